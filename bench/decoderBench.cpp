@@ -0,0 +1,333 @@
+// talkless_decoder_bench: decoder throughput per backend.
+//
+// For every fixture and every backend (miniaudio, FFmpeg) it measures open latency,
+// full-file decode throughput at the engine's output format, seek-to-first-samples
+// latency at random positions, and the memory a decoder holds while open. The
+// numbers back ClipDecoder::defaultBackendFor(); re-run it when either library is
+// upgraded or a new container is added.
+//
+// Fixtures (WAV/FLAC/MP3/OGG/Opus) are generated at build time when the ffmpeg CLI is
+// found; otherwise a WAV sine is written to the temp dir and other files can be passed
+// with --files. Peak RSS is process-wide and only grows, so for an isolated peak run a
+// single file and backend per process.
+//
+// Usage: talkless_decoder_bench [--fixtures DIR] [--files a.mp3,b.opus] [--backends miniaudio,ffmpeg]
+//                               [--rate 48000] [--opens N] [--seeks N] [--verbose]
+
+#include "clipDecoder.h"
+#include "latencyHistogram.h"
+#include "miniaudio.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+
+    #include <psapi.h>
+#elif defined(__APPLE__)
+    #include <mach/mach.h>
+    #include <sys/resource.h>
+#else
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+struct Options
+{
+    std::string fixtureDir;
+    std::vector<std::string> files;
+    std::vector<DecoderBackend> backends{DecoderBackend::Miniaudio, DecoderBackend::FFmpeg};
+    uint32_t rate = 48000; // 0 = each file's native rate
+    int opens = 20;
+    int seeks = 50;
+    bool verbose = false;
+};
+
+struct Result
+{
+    bool ok = false;
+    double durationSec = 0.0;
+    LatencyHistogram::Summary openMs;
+    double decodeMs = 0.0;
+    double framesPerSec = 0.0;
+    double realtimeX = 0.0;
+    LatencyHistogram::Summary seekMs;
+    int64_t openRssKb = 0;
+    int64_t peakRssKb = 0;
+};
+
+const char* backendName(DecoderBackend b)
+{
+    return b == DecoderBackend::FFmpeg ? "ffmpeg" : "miniaudio";
+}
+
+std::vector<std::string> parseStringList(const std::string& s)
+{
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            out.push_back(item);
+    return out;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : std::string(); };
+
+        if (arg == "--fixtures")
+            opt.fixtureDir = next();
+        else if (arg == "--files")
+            opt.files = parseStringList(next());
+        else if (arg == "--backends") {
+            opt.backends.clear();
+            for (const std::string& name : parseStringList(next()))
+                opt.backends.push_back(name == "ffmpeg" ? DecoderBackend::FFmpeg : DecoderBackend::Miniaudio);
+        } else if (arg == "--rate")
+            opt.rate = (uint32_t)std::max(0, std::atoi(next().c_str()));
+        else if (arg == "--opens")
+            opt.opens = std::max(1, std::atoi(next().c_str()));
+        else if (arg == "--seeks")
+            opt.seeks = std::max(0, std::atoi(next().c_str()));
+        else if (arg == "--verbose")
+            opt.verbose = true;
+        else {
+            std::cerr << "usage: talkless_decoder_bench [--fixtures DIR] [--files a.mp3,b.opus]\n"
+                         "                              [--backends miniaudio,ffmpeg] [--rate 48000]\n"
+                         "                              [--opens N] [--seeks N] [--verbose]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Resident set of the process right now, in KiB (0 where unsupported)
+int64_t currentRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return (int64_t)(pmc.WorkingSetSize / 1024);
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+        return (int64_t)(info.resident_size / 1024);
+    return 0;
+#else
+    long pages = 0;
+    long resident = 0;
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f)
+        return 0;
+    const bool ok = std::fscanf(f, "%ld %ld", &pages, &resident) == 2;
+    std::fclose(f);
+    return ok ? (int64_t)resident * (sysconf(_SC_PAGESIZE) / 1024) : 0;
+#endif
+}
+
+// High-water mark of the resident set, in KiB
+int64_t peakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return (int64_t)(pmc.PeakWorkingSetSize / 1024);
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    #ifdef __APPLE__
+    return (int64_t)usage.ru_maxrss / 1024; // bytes on macOS
+    #else
+    return (int64_t)usage.ru_maxrss;
+    #endif
+#endif
+}
+
+double elapsedMs(int64_t startNs)
+{
+    return (double)(latencyClockNs() - startNs) / 1e6;
+}
+
+bool writeSineWav(const std::string& path, uint32_t sampleRate, double seconds)
+{
+    ma_encoder_config cfg = ma_encoder_config_init(ma_encoding_format_wav, ma_format_s16, 2, sampleRate);
+    ma_encoder encoder;
+    if (ma_encoder_init_file(path.c_str(), &cfg, &encoder) != MA_SUCCESS)
+        return false;
+
+    const uint64_t frames = (uint64_t)(seconds * sampleRate);
+    std::vector<int16_t> pcm(4096 * 2);
+    for (uint64_t f = 0; f < frames;) {
+        const uint64_t n = std::min<uint64_t>(4096, frames - f);
+        for (uint64_t i = 0; i < n; ++i) {
+            const double t = (double)(f + i) / sampleRate;
+            const int16_t v = (int16_t)(8000.0 * std::sin(2.0 * kPi * 440.0 * t));
+            pcm[i * 2] = v;
+            pcm[i * 2 + 1] = v;
+        }
+        ma_encoder_write_pcm_frames(&encoder, pcm.data(), n, nullptr);
+        f += n;
+    }
+    ma_encoder_uninit(&encoder);
+    return true;
+}
+
+std::vector<std::string> findFixtures(const std::string& dir)
+{
+    static const char* kExtensions[] = {"wav", "flac", "mp3", "ogg", "opus", "m4a", "aac", "wma"};
+
+    std::vector<std::string> out;
+    std::error_code ec;
+    if (dir.empty() || !std::filesystem::is_directory(dir, ec))
+        return out;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file())
+            continue;
+        const std::string path = entry.path().string();
+        const std::string ext = MediaInfoCache::fileExtension(path);
+        if (std::find(std::begin(kExtensions), std::end(kExtensions), ext) != std::end(kExtensions))
+            out.push_back(path);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+Result runCase(const std::string& path, DecoderBackend backend, const Options& opt)
+{
+    Result result;
+    ClipDecoder decoder;
+
+    // Open latency; a fallback to the other backend means this one can't decode the file
+    LatencyHistogram openHist;
+    for (int i = 0; i < opt.opens; ++i) {
+        const int64_t startNs = latencyClockNs();
+        const bool opened = decoder.open(path, opt.rate, 2, backend);
+        openHist.record(elapsedMs(startNs));
+        const bool usable = opened && decoder.backend() == backend;
+        decoder.close();
+        if (!usable)
+            return result;
+    }
+    result.openMs = openHist.summary();
+
+    // Full decode, counting what the open decoder itself keeps resident
+    const int64_t rssBefore = currentRssKb();
+    if (!decoder.open(path, opt.rate, 2, backend))
+        return result;
+    result.openRssKb = std::max<int64_t>(0, currentRssKb() - rssBefore);
+
+    const uint32_t sampleRate = decoder.getSampleRate();
+    const uint32_t channels = decoder.getChannels();
+    std::vector<float> buffer((size_t)4096 * channels);
+
+    uint64_t totalFrames = 0;
+    const int64_t decodeStart = latencyClockNs();
+    for (;;) {
+        uint64_t read = 0;
+        const ma_result res = decoder.readPcmFrames(buffer.data(), 4096, &read);
+        totalFrames += read;
+        if (read == 0 || res != MA_SUCCESS)
+            break;
+    }
+    result.decodeMs = elapsedMs(decodeStart);
+    result.durationSec = sampleRate > 0 ? (double)totalFrames / sampleRate : 0.0;
+    if (result.decodeMs > 0.0) {
+        result.framesPerSec = totalFrames / (result.decodeMs / 1000.0);
+        result.realtimeX = result.durationSec / (result.decodeMs / 1000.0);
+    }
+
+    // Seek + first block, which is what a hotkey with a trim start or a scrub waits on
+    LatencyHistogram seekHist;
+    uint32_t seed = 0x2545F491u;
+    for (int i = 0; i < opt.seeks && totalFrames > 0; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const uint64_t target = (uint64_t)((double)(seed >> 8) / (double)(1u << 24) * (double)totalFrames);
+
+        const int64_t startNs = latencyClockNs();
+        if (!decoder.seekToPcmFrame(target))
+            continue;
+        uint64_t read = 0;
+        decoder.readPcmFrames(buffer.data(), 256, &read);
+        seekHist.record(elapsedMs(startNs));
+    }
+    result.seekMs = seekHist.summary();
+
+    decoder.close();
+    result.peakRssKb = peakRssKb();
+    result.ok = true;
+    return result;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+#ifdef TALKLESS_BENCH_FIXTURE_DIR
+    opt.fixtureDir = TALKLESS_BENCH_FIXTURE_DIR;
+#endif
+    if (!parseArgs(argc, argv, opt))
+        return 2;
+
+    std::vector<std::string> files = opt.files;
+    if (files.empty())
+        files = findFixtures(opt.fixtureDir);
+
+    std::error_code ec;
+    const std::filesystem::path tmpDir = std::filesystem::temp_directory_path(ec) / "talkless_decoder_bench";
+    if (files.empty()) {
+        std::filesystem::create_directories(tmpDir, ec);
+        const std::string path = (tmpDir / "tone.wav").string();
+        if (writeSineWav(path, 48000, 30.0))
+            files.push_back(path);
+    }
+    if (files.empty()) {
+        std::cerr << "talkless_decoder_bench: no fixtures to decode\n";
+        return 1;
+    }
+
+    // Results go to stdout; decoder logging (fallback attempts etc.) is dropped unless --verbose
+    std::ostream report(std::cout.rdbuf());
+    if (!opt.verbose)
+        std::cout.rdbuf(nullptr);
+
+    report << "file,format,backend,ok,fileKb,durationSec,openP50Ms,openMaxMs,decodeMs,framesPerSec,realtimeX,"
+              "seekP50Ms,seekP99Ms,openRssKb,peakRssKb\n";
+
+    for (const std::string& path : files) {
+        const std::uintmax_t fileSize = std::filesystem::file_size(path, ec);
+        const int64_t fileKb = ec ? 0 : (int64_t)(fileSize / 1024);
+        for (DecoderBackend backend : opt.backends) {
+            const Result r = runCase(path, backend, opt);
+            report << std::filesystem::path(path).filename().string() << ',' << MediaInfoCache::fileExtension(path)
+                   << ',' << backendName(backend) << ',' << (r.ok ? 1 : 0) << ',' << fileKb << ',' << r.durationSec
+                   << ',' << r.openMs.p50Ms << ',' << r.openMs.maxMs << ',' << r.decodeMs << ',' << r.framesPerSec
+                   << ',' << r.realtimeX << ',' << r.seekMs.p50Ms << ',' << r.seekMs.p99Ms << ',' << r.openRssKb
+                   << ',' << r.peakRssKb << '\n';
+            report.flush();
+        }
+    }
+
+    std::filesystem::remove_all(tmpDir, ec);
+    return 0;
+}
@@ -0,0 +1,268 @@
+// talkless_bench: headless benchmark of the audio mixer.
+//
+// Drives AudioEngine through its offline rendering path (no devices) and times every
+// block of the capture + main mix path, for each combination of sample rate, buffer
+// size, voice count, noise suppression and recording. Blocks are rendered back to back;
+// before each one the bench waits (untimed) until every voice has a block decoded, so
+// the numbers are mixer cost rather than decoder throughput.
+//
+// Usage: talkless_bench [--seconds N] [--rates 44100,48000] [--buffers 256,512]
+//                       [--voices 0,1,4,8] [--clips a.wav,b.mp3] [--verbose]
+
+#include "audioEngine.h"
+#include "latencyHistogram.h"
+#include "miniaudio.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+struct Options
+{
+    double seconds = 5.0;
+    std::vector<int> rates{48000};
+    std::vector<int> buffers{256, 512, 1024};
+    std::vector<int> voices{0, 1, 4, 8};
+    std::vector<std::string> clips; // fixtures; synthetic sines when empty
+    bool verbose = false;
+};
+
+struct Config
+{
+    int rate = 48000;
+    int buffer = 512;
+    int voices = 0;
+    bool noiseSuppression = false;
+    bool recording = false;
+};
+
+struct Result
+{
+    LatencyHistogram::Summary blockMs;
+    uint64_t clipUnderruns = 0;
+    uint64_t recordingOverruns = 0;
+    uint64_t decoderStalls = 0; // blocks rendered without every voice ready (waited too long)
+};
+
+std::vector<int> parseIntList(const std::string& s)
+{
+    std::vector<int> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            out.push_back(std::atoi(item.c_str()));
+    return out;
+}
+
+std::vector<std::string> parseStringList(const std::string& s)
+{
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            out.push_back(item);
+    return out;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : std::string(); };
+
+        if (arg == "--seconds")
+            opt.seconds = std::max(0.1, std::atof(next().c_str()));
+        else if (arg == "--rates")
+            opt.rates = parseIntList(next());
+        else if (arg == "--buffers")
+            opt.buffers = parseIntList(next());
+        else if (arg == "--voices")
+            opt.voices = parseIntList(next());
+        else if (arg == "--clips")
+            opt.clips = parseStringList(next());
+        else if (arg == "--verbose")
+            opt.verbose = true;
+        else {
+            std::cerr << "usage: talkless_bench [--seconds N] [--rates 44100,48000] [--buffers 256,512]\n"
+                         "                      [--voices 0,1,4,8] [--clips a.wav,b.mp3] [--verbose]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// 2 s stereo sine per voice at the engine rate, so the synthetic case never resamples
+bool writeSineWav(const std::string& path, int sampleRate, double freq)
+{
+    ma_encoder_config cfg = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 2, (ma_uint32)sampleRate);
+    ma_encoder encoder;
+    if (ma_encoder_init_file(path.c_str(), &cfg, &encoder) != MA_SUCCESS)
+        return false;
+
+    const int frames = sampleRate * 2;
+    std::vector<float> pcm((size_t)frames * 2);
+    for (int f = 0; f < frames; ++f) {
+        const float v = 0.25f * (float)std::sin(2.0 * kPi * freq * f / sampleRate);
+        pcm[(size_t)f * 2] = v;
+        pcm[(size_t)f * 2 + 1] = v;
+    }
+    ma_encoder_write_pcm_frames(&encoder, pcm.data(), (ma_uint64)frames, nullptr);
+    ma_encoder_uninit(&encoder);
+    return true;
+}
+
+// Wait (untimed) until every voice has a full block decoded; false on timeout
+bool waitForVoices(const AudioEngine& engine, int voices, ma_uint32 frames)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    for (;;) {
+        bool ready = true;
+        for (int v = 0; v < voices && ready; ++v)
+            ready = engine.getClipBufferedFrames(v) >= frames;
+        if (ready)
+            return true;
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::yield();
+    }
+}
+
+Result runConfig(const Config& cfg, const std::vector<std::string>& clips, double seconds,
+                 const std::filesystem::path& tmpDir)
+{
+    Result result;
+
+    AudioEngine engine;
+    engine.setAudioConfig((ma_uint32)cfg.rate, (ma_uint32)cfg.buffer, AudioEngine::DEFAULT_BUFFER_PERIODS, 2);
+    engine.setNoiseSuppressionLevel(cfg.noiseSuppression ? 2 : 0);
+    if (!engine.startOfflineRendering())
+        return result;
+
+    for (int v = 0; v < cfg.voices; ++v) {
+        engine.loadClip(v, clips[(size_t)v % clips.size()]);
+        engine.setClipLoop(v, true);
+        engine.setClipGain(v, -12.0f);
+    }
+
+    const std::string recPath = (tmpDir / "recording.wav").string();
+    if (cfg.recording)
+        engine.startRecording(recPath, true, true);
+
+    for (int v = 0; v < cfg.voices; ++v)
+        engine.playClip(v);
+
+    const ma_uint32 frames = (ma_uint32)cfg.buffer;
+    const ma_uint32 channels = engine.getChannels();
+    std::vector<float> out((size_t)frames * channels);
+
+    // Mic input: low-level noise so the suppressor has something to chew on
+    std::vector<float> mic(frames);
+    uint32_t seed = 0x12345678u;
+    auto fillMic = [&]() {
+        for (auto& s : mic) {
+            seed = seed * 1664525u + 1013904223u;
+            s = ((float)(seed >> 8) / (float)(1u << 24) - 0.5f) * 0.1f;
+        }
+    };
+
+    LatencyHistogram hist;
+    const uint64_t blocks = (uint64_t)std::ceil(seconds * cfg.rate / frames);
+    for (uint64_t b = 0; b < blocks; ++b) {
+        if (!waitForVoices(engine, cfg.voices, frames))
+            ++result.decoderStalls;
+        fillMic();
+
+        const int64_t startNs = latencyClockNs();
+        engine.renderOfflineBlock(mic.data(), out.data(), frames);
+        hist.record((double)(latencyClockNs() - startNs) / 1e6);
+    }
+
+    result.blockMs = hist.summary();
+    const AudioEngine::XrunCounters xruns = engine.getXrunCounters();
+    result.clipUnderruns = xruns.clipUnderruns;
+    result.recordingOverruns = xruns.recordingOverruns;
+
+    for (int v = 0; v < cfg.voices; ++v)
+        engine.stopClip(v);
+    if (cfg.recording) {
+        engine.stopRecording();
+        std::error_code ec;
+        std::filesystem::remove(recPath, ec);
+    }
+    engine.stopOfflineRendering();
+    return result;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+        return 2;
+
+    std::error_code ec;
+    const std::filesystem::path tmpDir = std::filesystem::temp_directory_path(ec) / "talkless_bench";
+    std::filesystem::create_directories(tmpDir, ec);
+
+    // Results go to stdout; the engine's own logging is dropped unless --verbose
+    std::ostream report(std::cout.rdbuf());
+    if (!opt.verbose)
+        std::cout.rdbuf(nullptr);
+
+    report << "rate,buffer,voices,noiseSuppression,recording,blocks,periodUs,meanUs,p50Us,p99Us,maxUs,meanLoadPct,"
+              "clipUnderruns,recordingOverruns,decoderStalls\n";
+
+    for (int rate : opt.rates) {
+        std::vector<std::string> clips = opt.clips;
+        if (clips.empty()) {
+            for (int v = 0; v < AudioEngine::MAX_CLIPS; ++v) {
+                const std::string path = (tmpDir / ("sine_" + std::to_string(rate) + "_" + std::to_string(v) + ".wav"))
+                                             .string();
+                if (writeSineWav(path, rate, 220.0 * (v + 1)))
+                    clips.push_back(path);
+            }
+        }
+        if (clips.empty()) {
+            std::cerr << "talkless_bench: no clips to play\n";
+            return 1;
+        }
+
+        for (int buffer : opt.buffers) {
+            for (int voices : opt.voices) {
+                voices = std::clamp(voices, 0, AudioEngine::MAX_CLIPS);
+                for (int ns = 0; ns < 2; ++ns) {
+                    for (int rec = 0; rec < 2; ++rec) {
+                        const Config cfg{rate, buffer, voices, ns != 0, rec != 0};
+                        const Result r = runConfig(cfg, clips, opt.seconds, tmpDir);
+
+                        const double periodUs = buffer * 1e6 / rate;
+                        const auto& s = r.blockMs;
+                        report << rate << ',' << buffer << ',' << voices << ',' << ns << ',' << rec << ','
+                               << s.count << ',' << periodUs << ',' << s.meanMs * 1000.0 << ','
+                               << s.p50Ms * 1000.0 << ',' << s.p99Ms * 1000.0 << ',' << s.maxMs * 1000.0 << ','
+                               << (periodUs > 0.0 ? s.meanMs * 1000.0 / periodUs * 100.0 : 0.0) << ','
+                               << r.clipUnderruns << ',' << r.recordingOverruns << ',' << r.decoderStalls << '\n';
+                        report.flush();
+                    }
+                }
+            }
+        }
+    }
+
+    std::filesystem::remove_all(tmpDir, ec);
+    return 0;
+}
@@ -0,0 +1,284 @@
+// talkless_resampler_bench: CPU cost and accuracy of every Resampler tier.
+//
+// For each rate pair and tier it streams a few seconds of a two-tone signal through
+// the resampler in host-sized blocks and reports the time per output frame per
+// channel and the share of one core needed to keep up in real time. Accuracy is
+// measured as the SNR against the analytically resampled signal. For downsampling,
+// alias rejection is measured too: a tone above the output Nyquist is fed in and
+// the energy that folds back into the band is reported. miniaudio's linear
+// resampler (what ma_decoder used to do) is included as a baseline.
+//
+// Usage: talkless_resampler_bench [--pairs 44100:48000,48000:24000] [--channels 1,2]
+//                                 [--seconds N] [--block FRAMES]
+
+#include "latencyHistogram.h"
+#include "miniaudio.h"
+#include "resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+struct Options
+{
+    std::vector<std::pair<uint32_t, uint32_t>> pairs{
+        {44100, 48000}, {48000, 44100}, {96000, 48000}, {48000, 24000}, {22050, 48000}};
+    std::vector<uint32_t> channels{1, 2};
+    double seconds = 4.0;
+    size_t block = 512;
+};
+
+struct Result
+{
+    double nsPerFramePerChannel = 0.0;
+    double cpuPercent = 0.0; // of one core, per channel, at real time
+    double snrDb = 0.0;
+    double aliasDb = 0.0; // NaN when not downsampling
+};
+
+std::vector<std::string> parseStringList(const std::string& s)
+{
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            out.push_back(item);
+    return out;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : std::string(); };
+
+        if (arg == "--pairs") {
+            opt.pairs.clear();
+            for (const std::string& pair : parseStringList(next())) {
+                const size_t colon = pair.find(':');
+                if (colon == std::string::npos)
+                    continue;
+                const int in = std::atoi(pair.substr(0, colon).c_str());
+                const int out = std::atoi(pair.substr(colon + 1).c_str());
+                if (in > 0 && out > 0)
+                    opt.pairs.emplace_back((uint32_t)in, (uint32_t)out);
+            }
+        } else if (arg == "--channels") {
+            opt.channels.clear();
+            for (const std::string& c : parseStringList(next()))
+                opt.channels.push_back((uint32_t)std::clamp(std::atoi(c.c_str()), 1, 8));
+        } else if (arg == "--seconds")
+            opt.seconds = std::max(0.1, std::atof(next().c_str()));
+        else if (arg == "--block")
+            opt.block = (size_t)std::max(1, std::atoi(next().c_str()));
+        else {
+            std::cerr << "usage: talkless_resampler_bench [--pairs 44100:48000,48000:24000] [--channels 1,2]\n"
+                         "                                [--seconds N] [--block FRAMES]\n";
+            return false;
+        }
+    }
+    return (!opt.pairs.empty() && !opt.channels.empty());
+}
+
+// Sum of sines, identical on every channel; evaluated at any (fractional) input time
+double signalAt(const std::vector<double>& freqs, double seconds)
+{
+    double v = 0.0;
+    for (double f : freqs)
+        v += 0.4 / freqs.size() * std::sin(2.0 * kPi * f * seconds);
+    return v;
+}
+
+std::vector<float> makeInput(const std::vector<double>& freqs, uint32_t rate, uint32_t channels, size_t frames)
+{
+    std::vector<float> in(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        const float v = (float)signalAt(freqs, (double)i / rate);
+        for (uint32_t ch = 0; ch < channels; ++ch)
+            in[i * channels + ch] = v;
+    }
+    return in;
+}
+
+// Streams the input through in host-sized blocks, then flushes; returns elapsed ns
+template <typename ProcessFn>
+int64_t streamThrough(const std::vector<float>& in, uint32_t channels, uint32_t inRate, uint32_t outRate,
+                      size_t block, size_t lookahead, std::vector<float>& out, ProcessFn&& process)
+{
+    const size_t inFrames = in.size() / channels;
+    const std::vector<float> zeros(lookahead * channels, 0.0f);
+    // Sized up front so the timed loop only resamples
+    const size_t outCapacity = (size_t)((double)(inFrames + lookahead) * outRate / inRate) + block + 64;
+    out.assign(outCapacity * channels, 0.0f);
+    size_t outFrames = 0;
+
+    const int64_t start = latencyClockNs();
+    auto feed = [&](const float* src, size_t frames) {
+        for (;;) {
+            size_t used = frames;
+            size_t made = outCapacity - outFrames;
+            process(src, used, out.data() + outFrames * channels, made);
+            outFrames += made;
+            src += used * channels;
+            frames -= used;
+            if ((frames == 0 && made == 0) || outFrames == outCapacity)
+                break;
+        }
+    };
+    for (size_t pos = 0; pos < inFrames; pos += block)
+        feed(in.data() + pos * channels, std::min(block, inFrames - pos));
+    feed(zeros.data(), lookahead);
+    const int64_t elapsed = latencyClockNs() - start;
+
+    out.resize(outFrames * channels);
+    return elapsed;
+}
+
+// Error power of channel 0 against the ideal output, away from the stream edges, in dB below the reference
+double snrDb(const std::vector<float>& out, uint32_t channels, uint32_t outRate, const std::vector<double>& freqs,
+             double delayFrames)
+{
+    const size_t frames = out.size() / channels;
+    const size_t edge = outRate / 20;
+    double err = 0.0;
+    double ref = 0.0;
+    for (size_t k = edge; k + edge < frames; ++k) {
+        const double ideal = signalAt(freqs, ((double)k - delayFrames) / outRate);
+        const double d = out[k * channels] - ideal;
+        err += d * d;
+        ref += ideal * ideal;
+    }
+    return err > 0.0 ? 10.0 * std::log10(ref / err) : 200.0;
+}
+
+double powerDb(const std::vector<float>& out, uint32_t channels, size_t skip)
+{
+    const size_t frames = out.size() / channels;
+    double p = 0.0;
+    size_t n = 0;
+    for (size_t k = skip; k + skip < frames; ++k, ++n)
+        p += (double)out[k * channels] * out[k * channels];
+    return n ? 10.0 * std::log10(std::max(p / n, 1e-30)) : -300.0;
+}
+
+Result benchTier(ResamplerQuality quality, uint32_t inRate, uint32_t outRate, uint32_t channels, const Options& opt)
+{
+    Result r;
+    const size_t inFrames = (size_t)(opt.seconds * inRate);
+    const double nyquist = 0.5 * std::min(inRate, outRate);
+    const std::vector<double> passband{997.0, 0.3 * nyquist};
+    const std::vector<float> in = makeInput(passband, inRate, channels, inFrames);
+    std::vector<float> out;
+
+    Resampler resampler;
+    resampler.init(channels, inRate, outRate, quality);
+    auto process = [&](const float* src, size_t& used, float* dst, size_t& made) {
+        resampler.process(src, used, dst, made);
+    };
+    const int64_t ns =
+        streamThrough(in, channels, inRate, outRate, opt.block, resampler.inputLookahead(), out, process);
+
+    const size_t outFrames = out.size() / channels;
+    r.nsPerFramePerChannel = outFrames ? (double)ns / outFrames / channels : 0.0;
+    r.cpuPercent = 100.0 * ((double)ns / 1e9) / (opt.seconds * channels);
+    r.snrDb = snrDb(out, channels, outRate, passband, 0.0);
+
+    r.aliasDb = std::nan("");
+    if (outRate < inRate) {
+        // A full-scale tone between the two Nyquists must not fold back
+        const std::vector<double> above{0.5 * (outRate * 0.5 + inRate * 0.5)};
+        const std::vector<float> aliasIn = makeInput(above, inRate, channels, inFrames);
+        resampler.reset();
+        streamThrough(aliasIn, channels, inRate, outRate, opt.block, resampler.inputLookahead(), out, process);
+        r.aliasDb = powerDb(out, channels, outRate / 20) - 10.0 * std::log10(0.5 * 0.4 * 0.4);
+    }
+    return r;
+}
+
+Result benchMiniaudioLinear(uint32_t inRate, uint32_t outRate, uint32_t channels, const Options& opt)
+{
+    Result r;
+    const size_t inFrames = (size_t)(opt.seconds * inRate);
+    const double nyquist = 0.5 * std::min(inRate, outRate);
+    const std::vector<double> passband{997.0, 0.3 * nyquist};
+    const std::vector<float> in = makeInput(passband, inRate, channels, inFrames);
+    std::vector<float> out;
+
+    // ma_decoder_config_init's defaults: linear, lpfOrder 4
+    ma_resampler_config cfg = ma_resampler_config_init(ma_format_f32, channels, inRate, outRate,
+                                                       ma_resample_algorithm_linear);
+    ma_resampler resampler;
+    if (ma_resampler_init(&cfg, nullptr, &resampler) != MA_SUCCESS)
+        return r;
+    auto process = [&](const float* src, size_t& used, float* dst, size_t& made) {
+        ma_uint64 u = used;
+        ma_uint64 m = made;
+        ma_resampler_process_pcm_frames(&resampler, src, &u, dst, &m);
+        used = (size_t)u;
+        made = (size_t)m;
+    };
+    const size_t latency = (size_t)ma_resampler_get_input_latency(&resampler) + 1;
+    const int64_t ns = streamThrough(in, channels, inRate, outRate, opt.block, latency, out, process);
+
+    const size_t outFrames = out.size() / channels;
+    r.nsPerFramePerChannel = outFrames ? (double)ns / outFrames / channels : 0.0;
+    r.cpuPercent = 100.0 * ((double)ns / 1e9) / (opt.seconds * channels);
+    // Its output lags by a frame or so; score it at its best alignment
+    r.snrDb = -1e9;
+    for (int tenth = 0; tenth <= 40; ++tenth)
+        r.snrDb = std::max(r.snrDb, snrDb(out, channels, outRate, passband, tenth / 10.0));
+
+    r.aliasDb = std::nan("");
+    if (outRate < inRate) {
+        const std::vector<double> above{0.5 * (outRate * 0.5 + inRate * 0.5)};
+        const std::vector<float> aliasIn = makeInput(above, inRate, channels, inFrames);
+        ma_resampler_reset(&resampler);
+        streamThrough(aliasIn, channels, inRate, outRate, opt.block, latency, out, process);
+        r.aliasDb = powerDb(out, channels, outRate / 20) - 10.0 * std::log10(0.5 * 0.4 * 0.4);
+    }
+    ma_resampler_uninit(&resampler, nullptr);
+    return r;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+        return 2;
+
+    std::printf("inRate,outRate,channels,tier,taps,nsPerFramePerCh,cpuPctPerCh,snrDb,aliasDb\n");
+    for (const auto& [inRate, outRate] : opt.pairs) {
+        for (uint32_t channels : opt.channels) {
+            auto print = [&](const char* tier, size_t taps, const Result& r) {
+                std::printf("%u,%u,%u,%s,%zu,%.2f,%.4f,%.1f,", inRate, outRate, channels, tier, taps,
+                            r.nsPerFramePerChannel, r.cpuPercent, r.snrDb);
+                if (std::isnan(r.aliasDb))
+                    std::printf("\n");
+                else
+                    std::printf("%.1f\n", r.aliasDb);
+            };
+
+            print("miniaudio-linear", 2, benchMiniaudioLinear(inRate, outRate, channels, opt));
+            for (int q = (int)ResamplerQuality::Linear; q <= (int)ResamplerQuality::Sinc64; ++q) {
+                const ResamplerQuality quality = (ResamplerQuality)q;
+                Resampler probe;
+                probe.init(channels, inRate, outRate, quality);
+                print(Resampler::qualityName(quality), probe.taps(),
+                      benchTier(quality, inRate, outRate, channels, opt));
+            }
+        }
+    }
+    return 0;
+}
@@ -104,18 +104,20 @@ Rectangle {
         }
     }
 
-    // Timer to update audio levels
-    Timer {
-        id: levelUpdateTimer
-        interval: 50  // Update 20 times per second
-        running: true
-        repeat: true
-        onTriggered: {
-            root.micPeakLevel = soundboardService.getMicPeakLevel();
-            root.masterPeakLevel = soundboardService.getMasterPeakLevel();
-            root.monitorPeakLevel = soundboardService.getMonitorPeakLevel();
-            // Reset peak levels for next measurement
-            soundboardService.resetPeakLevels();
+    // Audio levels follow the service's meter push (peaks are held and fall off in the engine),
+    // which only runs while this page is shown
+    readonly property bool watchesMeters: visible && Qt.application.state === Qt.ApplicationActive
+    onWatchesMetersChanged: if (soundboardService) soundboardService.watchMeterTelemetry(watchesMeters)
+    Component.onCompleted: if (soundboardService && watchesMeters) soundboardService.watchMeterTelemetry(true)
+    Component.onDestruction: if (soundboardService && watchesMeters) soundboardService.watchMeterTelemetry(false)
+
+    Connections {
+        target: soundboardService
+        function onMeterTelemetryChanged() {
+            const t = soundboardService.meterTelemetry;
+            root.micPeakLevel = t.mic ? t.mic.peak : 0.0;
+            root.masterPeakLevel = t.master ? t.master.peak : 0.0;
+            root.monitorPeakLevel = t.monitor ? t.monitor.peak : 0.0;
         }
     }
 
@@ -430,6 +432,36 @@ Rectangle {
                                         color: Colors.textSecondary
                                         font.pixelSize: Typography.fontSizeSmall
                                     }
+
+                                    // The extra recording device has its own suppressor and level
+                                    RowLayout {
+                                        Layout.fillWidth: true
+                                        spacing: 12
+
+                                        Text {
+                                            text: "Recording input:"
+                                            color: Colors.textPrimary
+                                            font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                            font.pixelSize: Typography.fontSizeSmall
+                                        }
+
+                                        DropdownSelector {
+                                            id: recordingInputNsDropdown
+                                            Layout.preferredWidth: 160
+                                            placeholder: "Select Level"
+                                            selectedId: (soundboardService?.recordingInputNoiseSuppressionLevel ?? 2).toString()
+                                            model: {
+                                                var names = soundboardService ? soundboardService.getNoiseSuppressionLevelNames() : [];
+                                                var items = [];
+                                                for (var i = 0; i < names.length; ++i)
+                                                    items.push({ id: i.toString(), name: names[i] });
+                                                return items;
+                                            }
+                                            onItemSelected: function (id, name) {
+                                                soundboardService.setRecordingInputNoiseSuppressionLevel(parseInt(id));
+                                            }
+                                        }
+                                    }
                                 }
                             }
                         }
@@ -728,8 +760,12 @@ Rectangle {
                                     Layout.preferredWidth: 200
                                     height: 40
                                     placeholder: "Select Sample Rate"
-                                    selectedId: (soundboardService?.sampleRate ?? 48000).toString()
+                                    selectedId: (soundboardService?.sampleRate ?? 0).toString()
                                     model: [
+                                        {
+                                            id: "0",
+                                            name: "Device native"
+                                        },
                                         {
                                             id: "44100",
                                             name: "44.1 kHz"
@@ -872,6 +908,221 @@ Rectangle {
                                 }
                             }
                         }
+
+                        // Row 3: Resampler quality (applies without restart)
+                        RowLayout {
+                            Layout.fillWidth: true
+                            spacing: 12
+
+                            Text {
+                                text: "Resampler:"
+                                color: Colors.textPrimary
+                                font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                font.pixelSize: 14
+                            }
+
+                            DropdownSelector {
+                                id: resamplerQualityDropdown
+                                Layout.preferredWidth: 200
+                                placeholder: "Select Quality"
+                                openUpward: true
+                                selectedId: (soundboardService?.resamplerQuality ?? 2).toString()
+                                model: [
+                                    {
+                                        id: "0",
+                                        name: "Linear (Lowest CPU)"
+                                    },
+                                    {
+                                        id: "1",
+                                        name: "Sinc 16 taps"
+                                    },
+                                    {
+                                        id: "2",
+                                        name: "Sinc 32 taps (Recommended)"
+                                    },
+                                    {
+                                        id: "3",
+                                        name: "Sinc 64 taps (Best)"
+                                    }
+                                ]
+                                onItemSelected: function (id, name) {
+                                    soundboardService.setResamplerQuality(parseInt(id));
+                                }
+                            }
+
+                            Text {
+                                Layout.fillWidth: true
+                                text: "For clips recorded at another sample rate, until their converted copy is ready"
+                                color: Colors.textSecondary
+                                font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                font.pixelSize: 12
+                                wrapMode: Text.WordWrap
+                            }
+                        }
+
+                        // Row 4: Where noise cancellation runs (requires restart)
+                        RowLayout {
+                            Layout.fillWidth: true
+                            spacing: 12
+
+                            Text {
+                                text: "Noise Cancellation:"
+                                color: Colors.textPrimary
+                                font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                font.pixelSize: 14
+                            }
+
+                            DropdownSelector {
+                                id: nsThreadDropdown
+                                Layout.preferredWidth: 200
+                                placeholder: "Select Mode"
+                                openUpward: true
+                                selectedId: (soundboardService?.noiseSuppressionOnDspThread ?? false) ? "dsp" : "callback"
+                                model: [
+                                    {
+                                        id: "callback",
+                                        name: "In audio callback"
+                                    },
+                                    {
+                                        id: "dsp",
+                                        name: "DSP thread (+1 buffer +10 ms)"
+                                    }
+                                ]
+                                onItemSelected: function (id, name) {
+                                    soundboardService.setNoiseSuppressionOnDspThread(id === "dsp");
+                                }
+                            }
+
+                            Text {
+                                Layout.fillWidth: true
+                                text: "Use the DSP thread if the mic crackles at small buffer sizes"
+                                color: Colors.textSecondary
+                                font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                font.pixelSize: 12
+                                wrapMode: Text.WordWrap
+                            }
+                        }
+
+                        // Row 5: Duck clips while the mic picks up speech (applies immediately)
+                        RowLayout {
+                            Layout.fillWidth: true
+                            spacing: 12
+
+                            Text {
+                                text: "Duck Clips While Speaking:"
+                                color: Colors.textPrimary
+                                font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                font.pixelSize: 14
+                            }
+
+                            ToggleSwitch {
+                                isOn: soundboardService?.voiceDuckingEnabled ?? false
+                                onToggled: function (value) {
+                                    soundboardService.setVoiceDuckingEnabled(value);
+                                }
+                            }
+
+                            Text {
+                                Layout.fillWidth: true
+                                text: "Lowers the soundboard on the main output while the mic hears voice"
+                                color: Colors.textSecondary
+                                font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                font.pixelSize: 12
+                                wrapMode: Text.WordWrap
+                            }
+                        }
+
+                        ColumnLayout {
+                            Layout.fillWidth: true
+                            spacing: 12
+                            visible: soundboardService?.voiceDuckingEnabled ?? false
+
+                            LabeledSlider {
+                                Layout.fillWidth: true
+                                label: "Voice Threshold"
+                                from: 0
+                                to: 100
+                                unit: "%"
+                                value: (soundboardService?.voiceDuckThreshold ?? 0.6) * 100
+                                onSliderValueChanged: function (newValue) {
+                                    soundboardService.setVoiceDuckThreshold(newValue / 100);
+                                }
+                            }
+
+                            LabeledSlider {
+                                Layout.fillWidth: true
+                                label: "Depth"
+                                from: -40
+                                to: 0
+                                unit: " dB"
+                                value: soundboardService?.voiceDuckDepthDb ?? -12
+                                onSliderValueChanged: function (newValue) {
+                                    soundboardService.setVoiceDuckDepthDb(newValue);
+                                }
+                            }
+
+                            LabeledSlider {
+                                Layout.fillWidth: true
+                                label: "Attack"
+                                from: 0
+                                to: 200
+                                unit: " ms"
+                                value: soundboardService?.voiceDuckAttackMs ?? 10
+                                onSliderValueChanged: function (newValue) {
+                                    soundboardService.setVoiceDuckAttackMs(newValue);
+                                }
+                            }
+
+                            LabeledSlider {
+                                Layout.fillWidth: true
+                                label: "Release"
+                                from: 50
+                                to: 2000
+                                unit: " ms"
+                                value: soundboardService?.voiceDuckReleaseMs ?? 400
+                                onSliderValueChanged: function (newValue) {
+                                    soundboardService.setVoiceDuckReleaseMs(newValue);
+                                }
+                            }
+                        }
+
+                        // Row 6: Which clip gives up its voice when all are busy (applies immediately)
+                        RowLayout {
+                            Layout.fillWidth: true
+                            spacing: 12
+
+                            Text {
+                                text: "Voice stealing:"
+                                color: Colors.textPrimary
+                                font.family: interFont.status === FontLoader.Ready ? interFont.name : "Arial"
+                                font.pixelSize: 14
+                            }
+
+                            DropdownSelector {
+                                id: voiceStealPolicyDropdown
+                                Layout.preferredWidth: 200
+                                placeholder: "Select Policy"
+                                openUpward: true
+                                selectedId: (soundboardService?.voiceStealPolicy ?? 0).toString()
+                                model: [
+                                    {
+                                        id: "0",
+                                        name: "Oldest clip"
+                                    },
+                                    {
+                                        id: "1",
+                                        name: "Quietest clip"
+                                    },
+                                    {
+                                        id: "2",
+                                        name: "Lowest priority clip"
+                                    }
+                                ]
+                                onItemSelected: function (id, name) {
+                                    soundboardService.setVoiceStealPolicy(parseInt(id));
+                                }
+                            }
+                        }
                         RowLayout {
                             Layout.fillWidth: true
                             spacing: 20
@@ -67,6 +67,33 @@ Rectangle {
         if (effectiveBoardId >= 0 && soundboardService) {
             // console.log("[QML] Board changed, caching waveforms...")
             soundboardService.cacheActiveBoardWaveforms();
+            visibleWaveformTimer.restart();
+        }
+    }
+
+    // Tell the model which tiles are on screen so their waveforms are generated first
+    function updateVisibleWaveformRange() {
+        if (!activeClipsModel || contentArea.tileHeight <= 0)
+            return;
+        const rowHeight = contentArea.tileHeight + contentArea.tileSpacing;
+        const firstRow = Math.floor(clipsFlickable.contentY / rowHeight);
+        const lastRow = Math.ceil((clipsFlickable.contentY + clipsFlickable.height) / rowHeight);
+        // -1 for AddAudioTile occupying the first grid cell
+        activeClipsModel.setVisibleRange(firstRow * contentArea.columnsCount - 1, (lastRow + 1) * contentArea.columnsCount - 2);
+    }
+
+    // Debounce viewport updates while scrolling/resizing
+    Timer {
+        id: visibleWaveformTimer
+        interval: 100
+        repeat: false
+        onTriggered: root.updateVisibleWaveformRange()
+    }
+
+    Connections {
+        target: activeClipsModel
+        function onClipsChanged() {
+            visibleWaveformTimer.restart();
         }
     }
 
@@ -75,56 +102,18 @@ Rectangle {
     signal requestDock
 
     // =========================
-    // PLAYBACK PROGRESS TIMER
+    // PLAYBACK TELEMETRY
     // =========================
-    // Timer that updates playback progress for all playing clips
-    Timer {
-        id: progressUpdateTimer
-        interval: 150  // Update every 150ms for better performance
-        repeat: true
-        running: true  // Always run to check for playing clips
-
-        // Map of clipId -> progress (0.0 to 1.0)
-        property var clipProgressMap: ({})
-
-        onTriggered: {
-            if (!soundboardService)
-                return;
-
-            // Get all currently playing clip IDs
-            var playingIds = soundboardService.playingClipIDs();
-
-            // Early exit if nothing is playing and no paused clips
-            var pausedCount = Object.keys(root.pausedClipIds).length;
-            if (playingIds.length === 0 && pausedCount === 0) {
-                if (Object.keys(clipProgressMap).length > 0) {
-                    clipProgressMap = {};
-                }
-                return;
-            }
-
-            var newMap = {};
-
-            // Add playing clips
-            for (var i = 0; i < playingIds.length; i++) {
-                var clipId = playingIds[i];
-                var progress = soundboardService.getClipPlaybackProgress(clipId);
-                newMap[clipId] = Math.max(0, Math.min(1, progress));
-            }
+    // Pushed by the service about once per frame while watched and playing: positions, progress and playing set
+    readonly property var telemetry: soundboardService ? soundboardService.playbackTelemetry : ({})
+    // Map of clipId -> progress (0.0 to 1.0) for clips playing or paused
+    readonly property var clipProgressMap: telemetry.progress || ({})
 
-            // Add paused clips
-            for (var pId in root.pausedClipIds) {
-                if (newMap[pId] === undefined) {
-                    var pClipId = parseInt(pId);
-                    var pProgress = soundboardService.getClipPlaybackProgress(pClipId);
-                    newMap[pId] = Math.max(0, Math.min(1, pProgress));
-                }
-            }
-
-            // Direct assignment (more efficient than JSON comparison)
-            clipProgressMap = newMap;
-        }
-    }
+    // Hidden views (another page, a docked board) stop asking for it
+    readonly property bool watchesPlayback: visible
+    onWatchesPlaybackChanged: if (soundboardService) soundboardService.watchPlaybackTelemetry(watchesPlayback)
+    Component.onCompleted: if (soundboardService && watchesPlayback) soundboardService.watchPlaybackTelemetry(true)
+    Component.onDestruction: if (soundboardService && watchesPlayback) soundboardService.watchPlaybackTelemetry(false)
 
     // Expose function to open the add soundboard dialog
     function showAddSoundboardDialog() {
@@ -1195,6 +1184,9 @@ Rectangle {
                     clip: true
                     flickableDirection: Flickable.VerticalFlick
 
+                    onContentYChanged: visibleWaveformTimer.restart()
+                    onHeightChanged: visibleWaveformTimer.restart()
+
                     // Background MouseArea for right-click context menu (Paste)
                     MouseArea {
                         anchors.fill: parent
@@ -1452,7 +1444,7 @@ Rectangle {
                                     }
                                     isPlaying: clipWrapper.clipIsPlaying
                                     clipId: clipWrapper.clipId
-                                    playbackProgress: progressUpdateTimer.clipProgressMap[clipWrapper.clipId] || 0.0
+                                    playbackProgress: root.clipProgressMap[clipWrapper.clipId] || 0.0
                                     filePath: clipWrapper.filePath
                                     currentBoardId: activeClipsModel.boardId
 
@@ -1856,15 +1848,24 @@ Rectangle {
                 property int lastClipId: -1  // Track which clip we're displaying
                 property var currentWaveformData: []  // Real waveform data for current clip
 
-                // Timer to poll playback position - runs when playing
-                Timer {
-                    id: audioPlayerTimer
-                    interval: 50  // Update every 50ms for smoother sync
-                    repeat: true
-                    running: audioPlayerCard.isPlaying && root.displayedClipData !== null
-                    onTriggered: {
+                // Follow the playback position from the telemetry push while playing
+                Connections {
+                    target: soundboardService
+                    enabled: audioPlayerCard.isPlaying && root.displayedClipData !== null
+                    function onPlaybackTelemetryChanged() {
                         if (root.displayedClipData) {
-                            audioPlayerCard.playbackPositionMs = soundboardService.getClipPlaybackPositionMs(root.displayedClipData.clipId);
+                            const positions = root.telemetry.positionMs || {};
+                            audioPlayerCard.playbackPositionMs = positions[root.displayedClipData.clipId] || 0;
+                        }
+                    }
+                }
+
+                // Pick up waveform peaks that were generated in the background
+                Connections {
+                    target: soundboardService
+                    function onClipWaveformReady(clipId) {
+                        if (clipId === audioPlayerCard.lastClipId) {
+                            audioPlayerCard.currentWaveformData = soundboardService.requestClipWaveformPeaks(clipId);
                         }
                     }
                 }
@@ -1888,8 +1889,9 @@ Rectangle {
                             playbackPositionMs = soundboardService.getClipPlaybackPositionMs(root.displayedClipData.clipId);
                             lastClipId = root.displayedClipData.clipId;
 
-                            // Load waveform data for the new clip (32 bars to match UI strip)
-                            currentWaveformData = soundboardService.getClipWaveformPeaks(root.displayedClipData.clipId, 32);
+                            // Load waveform data for the new clip; if it isn't cached yet it is generated
+                            // ahead of the background queue and delivered via clipWaveformReady
+                            currentWaveformData = soundboardService.requestClipWaveformPeaks(root.displayedClipData.clipId);
                         }
                     } else {
                         playbackPositionMs = 0;
@@ -4653,14 +4655,20 @@ Rectangle {
                     property real micDb: -60.0
                     property bool volumeTooHigh: (rmsLevel >= 0.90)
 
-                    Timer {
-                        interval: 50
-                        running: rightSidebar.currentTabIndex === 4 && Qt.application.state === Qt.ApplicationActive
-                        repeat: true
-                        onTriggered: {
+                    // Meters are only published while a view like this one watches them
+                    readonly property bool watchesMeters: visible && Qt.application.state === Qt.ApplicationActive
+                    onWatchesMetersChanged: if (soundboardService) soundboardService.watchMeterTelemetry(watchesMeters)
+                    Component.onCompleted: if (soundboardService && watchesMeters) soundboardService.watchMeterTelemetry(true)
+                    Component.onDestruction: if (soundboardService && watchesMeters) soundboardService.watchMeterTelemetry(false)
+
+                    Connections {
+                        target: soundboardService
+                        enabled: speakerTabContent.watchesMeters
+                        function onMeterTelemetryChanged() {
                             if (soundboardService) {
-                                var out = soundboardService.getMasterPeakLevel();
-                                var mic = soundboardService.getMicPeakLevel();
+                                const meters = soundboardService.meterTelemetry;
+                                var out = meters.master ? meters.master.peak : 0.0;
+                                var mic = meters.mic ? meters.mic.peak : 0.0;
 
                                 // Defensive: handle undefined / NaN
                                 out = (out === undefined || isNaN(out)) ? 0.0 : out;
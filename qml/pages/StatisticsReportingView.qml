@@ -35,6 +35,27 @@ Rectangle {
         { name: "Agent 3", checked: true, color: "#3498db" }
     ]
 
+    // Live engine health from the audio callbacks (see SoundboardService::getEngineHealth)
+    property var engineHealth: ({})
+
+    function formatCallback(name) {
+        var cb = engineHealth.callbacks ? engineHealth.callbacks[name] : undefined;
+        if (!cb || cb.blocks === 0)
+            return "idle";
+        return cb.avgUs.toFixed(0) + " / " + cb.worstUs.toFixed(0) + " µs  ("
+                + (cb.avgLoad * 100).toFixed(1) + "% avg, " + (cb.worstLoad * 100).toFixed(1) + "% worst, "
+                + cb.deadlineMisses + " late)";
+    }
+
+    Timer {
+        id: engineHealthTimer
+        interval: 500
+        running: root.visible
+        repeat: true
+        triggeredOnStart: true
+        onTriggered: root.engineHealth = soundboardService.getEngineHealth()
+    }
+
     Flickable {
         anchors.fill: parent
         contentWidth: width
@@ -281,6 +302,93 @@ Rectangle {
                     }
                 }
 
+                // Engine Health Section
+                RowLayout {
+                    Layout.fillWidth: true
+
+                    Text {
+                        text: "Engine Health"
+                        color: Colors.textPrimary
+                        font.pixelSize: Typography.fontSizeLarge
+                        font.weight: Font.DemiBold
+                    }
+
+                    Item { Layout.fillWidth: true }
+
+                    Rectangle {
+                        width: 70
+                        height: 28
+                        radius: 8
+                        color: Colors.surface
+                        border.color: Colors.border
+
+                        Text {
+                            anchors.centerIn: parent
+                            text: "Reset"
+                            color: Colors.textPrimary
+                            font.pixelSize: 12
+                        }
+
+                        MouseArea {
+                            anchors.fill: parent
+                            cursorShape: Qt.PointingHandCursor
+                            onClicked: {
+                                soundboardService.resetEngineHealth();
+                                root.engineHealth = soundboardService.getEngineHealth();
+                            }
+                        }
+                    }
+                }
+
+                Rectangle {
+                    Layout.fillWidth: true
+                    Layout.preferredHeight: engineHealthColumn.implicitHeight + 40
+                    color: Colors.panelBg
+                    radius: 12
+
+                    ColumnLayout {
+                        id: engineHealthColumn
+                        anchors.fill: parent
+                        anchors.margins: 20
+                        spacing: 12
+
+                        Repeater {
+                            model: [
+                                { label: "Main Output:", value: root.formatCallback("playback") },
+                                { label: "Microphone:", value: root.formatCallback("capture") },
+                                { label: "Monitor Output:", value: root.formatCallback("monitor") },
+                                { label: "Recording Input:", value: root.formatCallback("recordingInput") },
+                                { label: "Mic Overruns:", value: String(root.engineHealth.captureOverruns || 0) },
+                                { label: "Recording Overruns:", value: String((root.engineHealth.recordingOverruns || 0)
+                                                                            + (root.engineHealth.recordingInputOverruns || 0)) },
+                                { label: "Clip Underruns:", value: String(root.engineHealth.clipUnderruns || 0) },
+                                { label: "Voice Buffers:", value: Math.round((root.engineHealth.voiceRingBytes || 0) / 1024) + " KiB" },
+                                { label: "Noise Suppression Delay:", value: (root.engineHealth.noiseSuppressionLatencyMs || 0).toFixed(1) + " ms" }
+                            ]
+
+                            RowLayout {
+                                Layout.fillWidth: true
+                                spacing: 8
+
+                                Text {
+                                    text: modelData.label
+                                    color: Colors.textSecondary
+                                    font.pixelSize: 14
+                                }
+
+                                Text {
+                                    text: modelData.value
+                                    color: Colors.textPrimary
+                                    font.pixelSize: 14
+                                    font.weight: Font.Medium
+                                }
+
+                                required property var modelData
+                            }
+                        }
+                    }
+                }
+
                 // Overview Section
                 Text {
                     text: "Overview"
@@ -5,42 +5,25 @@
 
 #include "audioEngine.h"
 
-#include "ffmpeg_decoder.h"
+#include "clipDecoder.h"
 
 #include <algorithm>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <cstdio>  // FILE*
 #include <cstdlib> // malloc/free
 #include <cstring>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #if TALKLESS_HAS_EBUR128
     #include "ebur128.h"
 #endif
 
-#ifdef _WIN32
-    #include <windows.h>
-
-// Helper function to convert UTF-8 string to wide string for Windows file APIs
-static std::wstring utf8ToWide(const std::string& utf8)
-{
-    if (utf8.empty())
-        return std::wstring();
-    int wlen = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, nullptr, 0);
-    if (wlen <= 0)
-        return std::wstring();
-    std::wstring wstr(wlen, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wstr[0], wlen);
-    // Remove trailing null if present
-    if (!wstr.empty() && wstr.back() == L'\0')
-        wstr.pop_back();
-    return wstr;
-}
-#endif
-
 // ------------------------------------------------------------
 // Local helper
 // ------------------------------------------------------------
@@ -49,6 +32,17 @@ static inline float clamp01(float x)
     return std::max(0.0f, std::min(1.0f, x));
 }
 
+// Linear ramp to silence over the frames left of a stop fade (stereo, in place).
+// fadeLeft may exceed fadeTotal when the fade starts later in the block (scheduled stop).
+static inline void applyStopFade(float* stereo, ma_uint32 frames, uint32_t fadeLeft, uint32_t fadeTotal)
+{
+    for (ma_uint32 f = 0; f < frames; ++f) {
+        const float g = f < fadeLeft ? std::min(1.0f, (float)(fadeLeft - f) / (float)fadeTotal) : 0.0f;
+        stereo[f * 2] *= g;
+        stereo[f * 2 + 1] *= g;
+    }
+}
+
 // ------------------------------------------------------------
 // CTOR/DTOR
 // ------------------------------------------------------------
@@ -61,9 +55,13 @@ AudioEngine::AudioEngine()
     monitorDevice = nullptr;
     recordingInputDevice = nullptr;
 
-    // Initialize noise suppressor with default sample rate and moderate level
-    m_noiseSuppressor = std::make_unique<NoiseSuppressor>(48000, NoiseSuppressionLevel::Moderate);
-    m_noiseSuppressor->init();
+    // Initialize noise suppressors (main mic, recording input) with default sample rate and moderate level
+    m_noiseSuppressors = std::make_unique<NoiseSuppressorPool>(48000, NS_STREAM_COUNT, NoiseSuppressionLevel::Moderate);
+    m_noiseSuppressors->init();
+
+    resizeVoiceRings();
+
+    m_commandThread = std::thread(&AudioEngine::commandThreadFunc, this);
 }
 
 AudioEngine::AudioEngine(void* parent) : AudioEngine()
@@ -73,6 +71,14 @@ AudioEngine::AudioEngine(void* parent) : AudioEngine()
 
 AudioEngine::~AudioEngine()
 {
+    // command thread touches clip slots, stop it before anything else
+    m_commandThreadQuit.store(true, std::memory_order_release);
+    m_commandsPosted.fetch_add(1, std::memory_order_release);
+    m_commandsPosted.notify_one();
+    if (m_commandThread.joinable()) {
+        m_commandThread.join();
+    }
+
     // stop recording first
     stopRecording();
 
@@ -113,6 +119,7 @@ AudioEngine::~AudioEngine()
 
     // ringbuffers
     shutdownCaptureRingBuffer();
+    shutdownDspRingBuffer();
     shutdownRecordingRingBuffer();
 
     // cleanup context
@@ -128,7 +135,7 @@ AudioEngine::~AudioEngine()
 // ------------------------------------------------------------
 void AudioEngine::setAudioConfig(ma_uint32 sampleRate, ma_uint32 bufferSize, ma_uint32 periods, ma_uint32 channels)
 {
-    if (sampleRate != 44100 && sampleRate != 48000 && sampleRate != 96000) {
+    if (sampleRate != NATIVE_SAMPLE_RATE && sampleRate != 44100 && sampleRate != 48000 && sampleRate != 96000) {
         std::cout << "[AudioEngine] Invalid sample rate: " << sampleRate << ", using default\n";
         sampleRate = DEFAULT_SAMPLE_RATE;
     }
@@ -145,17 +152,24 @@ void AudioEngine::setAudioConfig(ma_uint32 sampleRate, ma_uint32 bufferSize, ma_
         channels = DEFAULT_CHANNELS;
     }
 
-    m_sampleRate = sampleRate;
+    // Native: keep the current rate until the playback device reports its own
+    m_requestedSampleRate = sampleRate;
+    if (sampleRate != NATIVE_SAMPLE_RATE)
+        m_sampleRate = sampleRate;
     m_bufferSizeFrames = bufferSize;
     m_bufferPeriods = periods;
     m_channels = channels;
 
     // Update noise suppressor sample rate
-    if (m_noiseSuppressor) {
-        m_noiseSuppressor->setSampleRate(sampleRate);
+    if (m_noiseSuppressors) {
+        m_noiseSuppressors->setSampleRate((int)m_sampleRate);
     }
 
-    std::cout << "[AudioEngine] Configured: SR=" << m_sampleRate << ", BufferSize=" << m_bufferSizeFrames
+    // Ring size follows buffer size/periods
+    resizeVoiceRings();
+
+    std::cout << "[AudioEngine] Configured: SR=" << (sampleRate == NATIVE_SAMPLE_RATE ? "native" : std::to_string(m_sampleRate))
+              << ", BufferSize=" << m_bufferSizeFrames
               << ", Periods=" << m_bufferPeriods << ", Channels=" << m_channels << "\n";
 }
 
@@ -191,6 +205,47 @@ ma_uint32 AudioEngine::getRingBufferSize() const
     return std::max<ma_uint32>(m_bufferSizeFrames * blocks, 4096);
 }
 
+bool AudioEngine::resizeVoiceRings()
+{
+    const ma_uint32 frames = getRingBufferSize();
+    if (!m_voiceRings.empty() && m_voiceRingFrames == frames) {
+        m_voiceRingsStale = false;
+        return true;
+    }
+
+    // The mixers read the rings lock-free; swap them only while no callback can be inside one
+    if (playbackRunning.load(std::memory_order_acquire) || monitorRunning.load(std::memory_order_acquire) ||
+        offlineRendering.load(std::memory_order_acquire)) {
+        m_voiceRingsStale = true;
+        return false;
+    }
+
+    for (int i = 0; i < MAX_CLIPS; ++i)
+        stopClip(i); // joins the decoder threads writing into the old rings
+
+    VoiceRingSlab slab;
+    if (!slab.allocate((size_t)MAX_CLIPS * 2, (size_t)frames * 2 * sizeof(float))) {
+        std::cerr << "[AudioEngine] Failed to allocate voice ring buffers (" << frames << " frames x "
+                  << MAX_CLIPS * 2 << ")\n";
+        return false;
+    }
+
+    for (int i = 0; i < MAX_CLIPS; ++i) {
+        ClipSlot& slot = clips[i];
+        ma_pcm_rb_uninit(&slot.ringBufferMain);
+        ma_pcm_rb_uninit(&slot.ringBufferMon);
+        ma_pcm_rb_init(ma_format_f32, 2, frames, slab.region((size_t)i * 2), nullptr, &slot.ringBufferMain);
+        ma_pcm_rb_init(ma_format_f32, 2, frames, slab.region((size_t)i * 2 + 1), nullptr, &slot.ringBufferMon);
+    }
+
+    m_voiceRings = std::move(slab);
+    m_voiceRingFrames = frames;
+    m_voiceRingsStale = false;
+    std::cout << "[AudioEngine] Voice rings: " << MAX_CLIPS << " voices x 2 x " << frames << " frames ("
+              << m_voiceRings.totalBytes() / 1024 << " KiB)\n";
+    return true;
+}
+
 ma_uint32 AudioEngine::getRecInputRbSize() const
 {
     // Recording-input mono RB: keep a couple seconds buffered
@@ -223,6 +278,7 @@ bool AudioEngine::initCaptureRingBuffer(ma_uint32 sampleRate)
 
     if (captureRbData) {
         ma_pcm_rb_reset(&captureRb);
+        resetVadSidechain();
         return true;
     }
 
@@ -241,6 +297,7 @@ bool AudioEngine::initCaptureRingBuffer(ma_uint32 sampleRate)
         captureRbFrames = 0;
         return false;
     }
+    resetVadSidechain();
     return true;
 }
 
@@ -254,6 +311,266 @@ void AudioEngine::shutdownCaptureRingBuffer()
     }
 }
 
+// ------------------------------------------------------------
+// Voice-activity sidechain
+// ------------------------------------------------------------
+float AudioEngine::micVoiceActivity(const float* mono, ma_uint32 frames, bool micOn) const
+{
+    if (!micOn || frames == 0)
+        return 0.0f;
+
+    // RNNoise's VAD is for the newest frame it analysed, so it leads the (delayed) denoised audio
+    // by up to the suppressor latency: a few ms of lookahead for the duck's attack
+    const NoiseSuppressor& ns = m_noiseSuppressors->stream(NS_STREAM_MIC);
+    if (ns.providesVad())
+        return ns.getLastVadProbability();
+
+    // Without RNNoise, a level gate: anything above -40 dBFS RMS counts as speech
+    double energy = 0.0;
+    for (ma_uint32 f = 0; f < frames; ++f)
+        energy += (double)mono[f] * mono[f];
+    return energy / frames > 1e-4 ? 1.0f : 0.0f;
+}
+
+void AudioEngine::pushVadMark(ma_uint32 frames, float probability)
+{
+    const uint32_t total = m_vadPendingFrames + frames;
+    if (total == 0)
+        return;
+    // A full queue only merges spans; the frame count the consumer walks stays exact
+    m_vadPendingFrames = m_vadMarks.push(VadMark{total, probability}) ? 0 : total;
+}
+
+void AudioEngine::resetVadSidechain()
+{
+    // Only with both ends idle (devices stopped, or the offline renderer between blocks)
+    VadMark mark;
+    while (m_vadMarks.pop(mark)) {
+    }
+    m_vadPendingFrames = 0;
+    m_vadMarkLeft = 0;
+    m_vadProbability = 0.0f;
+}
+
+void AudioEngine::computeVoiceDuck(ma_uint32 micFrames, ma_uint32 frameCount)
+{
+    if (m_voiceDuckScratch.size() != (size_t)frameCount)
+        m_voiceDuckScratch.resize(frameCount);
+
+    const bool enabled = m_voiceDuckEnabled.load(std::memory_order_relaxed);
+    const float threshold = m_voiceDuckThreshold.load(std::memory_order_relaxed);
+    const float depth = dBToLinear(m_voiceDuckDepthDb.load(std::memory_order_relaxed));
+
+    // One-pole smoothing towards the target: attack going down, release coming back up
+    auto coefFor = [this](float ms) {
+        const double frames = (double)ms * 0.001 * m_sampleRate;
+        return frames < 1.0 ? 1.0f : (float)(1.0 - std::exp(-1.0 / frames));
+    };
+    const float attack = coefFor(m_voiceDuckAttackMs.load(std::memory_order_relaxed));
+    const float release = coefFor(m_voiceDuckReleaseMs.load(std::memory_order_relaxed));
+
+    float env = m_voiceDuckEnvelope;
+    for (ma_uint32 f = 0; f < frameCount; ++f) {
+        // Walk the tags in step with the mic frames read; past them (mic ran short) keep the last one
+        if (f < micFrames) {
+            while (m_vadMarkLeft == 0) {
+                VadMark mark;
+                if (!m_vadMarks.pop(mark))
+                    break;
+                m_vadMarkLeft = mark.frames;
+                m_vadProbability = mark.probability;
+            }
+            if (m_vadMarkLeft > 0)
+                --m_vadMarkLeft;
+        }
+
+        const float target = (enabled && m_vadProbability >= threshold) ? depth : 1.0f;
+        env += (target - env) * (target < env ? attack : release);
+        m_voiceDuckScratch[f] = env;
+    }
+    m_voiceDuckEnvelope = env;
+    m_voiceDuckGainDb.store(env < 1.0f ? 20.0f * std::log10(std::max(env, 0.000001f)) : 0.0f,
+                            std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------
+// DSP thread: capture -> m_dspInputRb -> noise suppression -> captureRb
+// ------------------------------------------------------------
+bool AudioEngine::startDspThread()
+{
+    if (!captureRbData || m_sampleRate == 0)
+        return false;
+    // A thread left over from an earlier start still reads the rings we are about to replace
+    if (m_dspThread.joinable())
+        stopDspThread();
+
+    m_dspBatchFrames = std::max<ma_uint32>(m_sampleRate * DSP_BATCH_MS / 1000, 1);
+
+    // One host period (capture delivers and playback pulls that much at once) plus the batch in flight
+    ma_uint32 hostPeriod = m_bufferSizeFrames;
+    if (playbackDevice)
+        hostPeriod = std::max(hostPeriod, playbackDevice->playback.internalPeriodSizeInFrames);
+    if (captureDevice)
+        hostPeriod = std::max(hostPeriod, captureDevice->capture.internalPeriodSizeInFrames);
+    m_dspPrimeFrames = hostPeriod + m_dspBatchFrames;
+
+    // Sized for the current rate; no callback writes to them while m_dspActive is false
+    shutdownDspRingBuffer();
+    const ma_uint32 frames = std::max<ma_uint32>(m_sampleRate * 2, 4096); // ~2 seconds mono
+    auto initRing = [frames](ma_pcm_rb& rb, void*& data) {
+        data = std::malloc((size_t)frames * sizeof(float));
+        if (!data)
+            return false;
+        if (ma_pcm_rb_init(ma_format_f32, 1, frames, data, nullptr, &rb) != MA_SUCCESS) {
+            std::free(data);
+            data = nullptr;
+            return false;
+        }
+        return true;
+    };
+    if (!initRing(m_dspInputRb, m_dspInputRbData) || !initRing(m_dspRecInputRb, m_dspRecInputRbData)) {
+        shutdownDspRingBuffer();
+        return false;
+    }
+
+    // Playback starts reading m_dspPrimeFrames behind, so it never runs dry while a batch is in flight
+    ma_pcm_rb_reset(&captureRb);
+    resetVadSidechain();
+    ma_uint32 primed = 0;
+    while (primed < m_dspPrimeFrames) {
+        ma_uint32 n = m_dspPrimeFrames - primed;
+        void* pWrite = nullptr;
+        if (ma_pcm_rb_acquire_write(&captureRb, &n, &pWrite) != MA_SUCCESS || n == 0 || !pWrite)
+            break;
+        std::memset(pWrite, 0, (size_t)n * sizeof(float));
+        ma_pcm_rb_commit_write(&captureRb, n);
+        primed += n;
+    }
+    pushVadMark(primed, 0.0f);
+
+    m_dspQuit.store(false, std::memory_order_release);
+    m_dspThread = std::thread(&AudioEngine::dspThreadFunc, this);
+    m_dspRunning.store(true, std::memory_order_release);
+    m_dspActive.store(true, std::memory_order_release);
+    return true;
+}
+
+void AudioEngine::stopDspThread()
+{
+    m_dspActive.store(false, std::memory_order_release);
+    if (!m_dspThread.joinable())
+        return;
+
+    m_dspQuit.store(true, std::memory_order_release);
+    m_dspWake.fetch_add(1, std::memory_order_release);
+    m_dspWake.notify_one();
+    m_dspThread.join();
+    m_dspRunning.store(false, std::memory_order_release);
+}
+
+void AudioEngine::shutdownDspRingBuffer()
+{
+    if (m_dspInputRbData) {
+        ma_pcm_rb_uninit(&m_dspInputRb);
+        std::free(m_dspInputRbData);
+        m_dspInputRbData = nullptr;
+    }
+    if (m_dspRecInputRbData) {
+        ma_pcm_rb_uninit(&m_dspRecInputRb);
+        std::free(m_dspRecInputRbData);
+        m_dspRecInputRbData = nullptr;
+    }
+}
+
+void AudioEngine::dspThreadFunc()
+{
+    const ma_uint32 batchFrames = m_dspBatchFrames;
+    std::vector<float> micBatch(batchFrames);
+    std::vector<float> recBatch(batchFrames);
+
+    // Both sides may wrap inside a batch, so copy in up to two pieces
+    auto readBatch = [batchFrames](ma_pcm_rb* rb, float* dst) {
+        ma_uint32 got = 0;
+        while (got < batchFrames) {
+            ma_uint32 n = batchFrames - got;
+            void* pRead = nullptr;
+            if (ma_pcm_rb_acquire_read(rb, &n, &pRead) != MA_SUCCESS || n == 0 || !pRead)
+                break;
+            std::memcpy(dst + got, pRead, (size_t)n * sizeof(float));
+            ma_pcm_rb_commit_read(rb, n);
+            got += n;
+        }
+        std::fill(dst + got, dst + batchFrames, 0.0f);
+    };
+    // Returns the frames written; the rest is dropped if the ring is full
+    auto writeBatch = [batchFrames](ma_pcm_rb* rb, const float* src) {
+        ma_uint32 put = 0;
+        while (put < batchFrames) {
+            ma_uint32 n = batchFrames - put;
+            void* pWrite = nullptr;
+            if (ma_pcm_rb_acquire_write(rb, &n, &pWrite) != MA_SUCCESS || n == 0 || !pWrite)
+                break;
+            std::memcpy(pWrite, src + put, (size_t)n * sizeof(float));
+            ma_pcm_rb_commit_write(rb, n);
+            put += n;
+        }
+        return put;
+    };
+
+    uint64_t seen = 0;
+    while (!m_dspQuit.load(std::memory_order_acquire)) {
+        m_dspWake.wait(seen, std::memory_order_acquire);
+        seen = m_dspWake.load(std::memory_order_acquire);
+
+        while (!m_dspQuit.load(std::memory_order_acquire)) {
+            const bool micReady = ma_pcm_rb_available_read(&m_dspInputRb) >= batchFrames;
+            const bool recReady = ma_pcm_rb_available_read(&m_dspRecInputRb) >= batchFrames;
+            if (!micReady && !recReady)
+                break;
+
+            // Whatever is ready goes through RNNoise in one pass
+            int streams[NS_STREAM_COUNT];
+            float* blocks[NS_STREAM_COUNT];
+            int count = 0;
+            if (micReady) {
+                readBatch(&m_dspInputRb, micBatch.data());
+                if (micEnabled.load(std::memory_order_relaxed)) {
+                    streams[count] = NS_STREAM_MIC;
+                    blocks[count++] = micBatch.data();
+                }
+            }
+            if (recReady) {
+                readBatch(&m_dspRecInputRb, recBatch.data());
+                streams[count] = NS_STREAM_RECORDING_INPUT;
+                blocks[count++] = recBatch.data();
+            }
+            if (m_noiseSuppressors && count > 0)
+                m_noiseSuppressors->processBatch(streams, blocks, count, (int)batchFrames);
+
+            if (micReady) {
+                float peak = 0.0f;
+                for (float v : micBatch)
+                    peak = std::max(peak, std::abs(v));
+
+                const bool micOn = micEnabled.load(std::memory_order_relaxed);
+                const ma_uint32 put = writeBatch(&captureRb, micBatch.data());
+                if (put < batchFrames)
+                    m_captureOverruns.fetch_add(1, std::memory_order_relaxed);
+                pushVadMark(put, micVoiceActivity(micBatch.data(), put, micOn));
+
+                float cur = micPeakLevel.load(std::memory_order_relaxed);
+                if (peak > cur)
+                    micPeakLevel.store(peak, std::memory_order_relaxed);
+            }
+            if (recReady) {
+                std::lock_guard<std::mutex> lock(m_recInputRbMutex);
+                if (recordingInputRbData && writeBatch(&recordingInputRb, recBatch.data()) < batchFrames)
+                    m_recordingInputOverruns.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
 // ------------------------------------------------------------
 // Recording ringbuffer (float32 channels)
 // ------------------------------------------------------------
@@ -489,7 +806,7 @@ bool AudioEngine::initPlaybackDevice()
     ma_device_config cfg = ma_device_config_init(ma_device_type_playback);
     cfg.playback.format = ma_format_f32;
     cfg.playback.channels = m_channels;
-    cfg.sampleRate = m_sampleRate;
+    cfg.sampleRate = m_requestedSampleRate; // 0 = the device's native rate, no resampling in the backend
     cfg.dataCallback = &AudioEngine::playbackCallback;
     cfg.pUserData = this;
     cfg.periodSizeInFrames = m_bufferSizeFrames;
@@ -504,11 +821,29 @@ bool AudioEngine::initPlaybackDevice()
         playbackDevice = nullptr;
         return false;
     }
+    adoptDeviceSampleRate(playbackDevice->sampleRate);
 
     playbackRunning.store(false, std::memory_order_release);
     return true;
 }
 
+void AudioEngine::adoptDeviceSampleRate(ma_uint32 deviceRate)
+{
+    if (m_requestedSampleRate != NATIVE_SAMPLE_RATE || deviceRate == m_sampleRate)
+        return;
+    if (deviceRate < 8000 || deviceRate > 384000)
+        return;
+
+    // Decoders run at the mix rate; anything still playing was set up for the old one
+    for (int i = 0; i < MAX_CLIPS; ++i)
+        stopClip(i);
+
+    m_sampleRate = deviceRate;
+    if (m_noiseSuppressors)
+        m_noiseSuppressors->setSampleRate((int)deviceRate);
+    std::cout << "[AudioEngine] Using the playback device's native rate: " << deviceRate << " Hz\n";
+}
+
 bool AudioEngine::initCaptureDevice()
 {
     if (captureDevice)
@@ -563,20 +898,32 @@ bool AudioEngine::initCaptureDevice()
 
 bool AudioEngine::startAudioDevice()
 {
+    if (offlineRendering.load(std::memory_order_acquire))
+        return false;
+    if (m_voiceRingsStale)
+        resizeVoiceRings();
+
     // Ensure devices exist
     if (!playbackDevice && !initPlaybackDevice())
         return false;
     if (!captureDevice && !initCaptureDevice())
         return false;
 
+    // Fixed for the life of the devices; the offline renderer always suppresses inline
+    if (m_nsOnDspThread.load(std::memory_order_relaxed) && !startDspThread())
+        std::cerr << "[AudioEngine] DSP thread unavailable, noise suppression stays in the capture callback\n";
+
     // Start capture first so playback has data
-    if (ma_device_start(captureDevice) != MA_SUCCESS)
+    if (ma_device_start(captureDevice) != MA_SUCCESS) {
+        stopDspThread();
         return false;
+    }
     captureRunning.store(true, std::memory_order_release);
 
     if (ma_device_start(playbackDevice) != MA_SUCCESS) {
         ma_device_stop(captureDevice);
         captureRunning.store(false, std::memory_order_release);
+        stopDspThread();
         return false;
     }
     playbackRunning.store(true, std::memory_order_release);
@@ -600,6 +947,7 @@ bool AudioEngine::stopAudioDevice()
         ma_device_stop(captureDevice);
         captureRunning.store(false, std::memory_order_release);
     }
+    stopDspThread();
     return true;
 }
 
@@ -608,6 +956,54 @@ bool AudioEngine::isDeviceRunning() const
     return deviceRunning.load(std::memory_order_relaxed);
 }
 
+// ------------------------------------------------------------
+// Headless rendering
+// ------------------------------------------------------------
+bool AudioEngine::startOfflineRendering()
+{
+    if (deviceRunning.load(std::memory_order_acquire))
+        return false;
+    if (m_voiceRingsStale)
+        resizeVoiceRings();
+    if (!initCaptureRingBuffer(m_sampleRate))
+        return false;
+
+    offlineRendering.store(true, std::memory_order_release);
+    deviceRunning.store(true, std::memory_order_release);
+    return true;
+}
+
+void AudioEngine::stopOfflineRendering()
+{
+    if (!offlineRendering.load(std::memory_order_acquire))
+        return;
+    deviceRunning.store(false, std::memory_order_release);
+    offlineRendering.store(false, std::memory_order_release);
+}
+
+bool AudioEngine::isOfflineRendering() const
+{
+    return offlineRendering.load(std::memory_order_relaxed);
+}
+
+void AudioEngine::renderOfflineBlock(const float* micInput, float* output, ma_uint32 frameCount)
+{
+    if (!output || !offlineRendering.load(std::memory_order_acquire))
+        return;
+
+    // Same order and bookkeeping as the device callbacks
+    const int64_t captureStartNs = latencyClockNs();
+    processCaptureInput(micInput, frameCount, 1, ma_format_f32);
+    const int64_t playbackStartNs = latencyClockNs();
+    m_callbackProfiles[(int)EngineCallback::Capture].record(playbackStartNs - captureStartNs, frameCount,
+                                                             m_sampleRate);
+
+    processPlaybackAudio(output, frameCount, m_channels);
+    frameClock.fetch_add(frameCount, std::memory_order_release);
+    m_callbackProfiles[(int)EngineCallback::Playback].record(latencyClockNs() - playbackStartNs, frameCount,
+                                                              m_sampleRate);
+}
+
 // ------------------------------------------------------------
 // Monitor device
 // ------------------------------------------------------------
@@ -696,7 +1092,17 @@ bool AudioEngine::initRecordingInputDevice()
         return false;
     }
 
+    // Fresh filter for a fresh device
+    recordingHPFPrevIn = 0.0F;
+    recordingHPFPrevOut = 0.0F;
+    {
+        const float rc = 1.0F / (2.0F * 3.14159265F * kRecordingHPFCutoff);
+        const float dt = 1.0F / (float)recordingInputDevice->sampleRate;
+        recordingHPFAlpha = rc / (rc + dt);
+    }
+
     // init mono ringbuffer
+    std::lock_guard<std::mutex> lock(m_recInputRbMutex);
     if (!recordingInputRbData) {
         const size_t bytes = (size_t)getRecInputRbSize() * sizeof(float);
         recordingInputRbData = std::malloc(bytes);
@@ -746,10 +1152,13 @@ void AudioEngine::shutdownRecordingInputDevice()
         delete recordingInputDevice;
         recordingInputDevice = nullptr;
     }
-    if (recordingInputRbData) {
-        ma_pcm_rb_uninit(&recordingInputRb);
-        std::free(recordingInputRbData);
-        recordingInputRbData = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_recInputRbMutex);
+        if (recordingInputRbData) {
+            ma_pcm_rb_uninit(&recordingInputRb);
+            std::free(recordingInputRbData);
+            recordingInputRbData = nullptr;
+        }
     }
     recordingInputEnabled.store(false, std::memory_order_release);
     selectedRecordingCaptureSet = false;
@@ -990,6 +1399,44 @@ float AudioEngine::getMicGainLinear() const
     return micGain.load(std::memory_order_relaxed);
 }
 
+void AudioEngine::setMicDuckDB(float duckDB)
+{
+    // Ducking only ever attenuates
+    const float db = std::min(duckDB, 0.0f);
+    micDuckDB.store(db, std::memory_order_relaxed);
+    micDuckGain.store(dBToLinear(db), std::memory_order_relaxed);
+}
+
+float AudioEngine::getMicDuckDB() const
+{
+    return micDuckDB.load(std::memory_order_relaxed);
+}
+
+void AudioEngine::setVoiceDucking(const VoiceDuckSettings& settings)
+{
+    m_voiceDuckThreshold.store(std::clamp(settings.threshold, 0.0f, 1.0f), std::memory_order_relaxed);
+    m_voiceDuckAttackMs.store(std::clamp(settings.attackMs, 0.0f, 1000.0f), std::memory_order_relaxed);
+    m_voiceDuckReleaseMs.store(std::clamp(settings.releaseMs, 0.0f, 5000.0f), std::memory_order_relaxed);
+    m_voiceDuckDepthDb.store(std::clamp(settings.depthDb, -60.0f, 0.0f), std::memory_order_relaxed);
+    m_voiceDuckEnabled.store(settings.enabled, std::memory_order_relaxed);
+}
+
+AudioEngine::VoiceDuckSettings AudioEngine::getVoiceDucking() const
+{
+    VoiceDuckSettings s;
+    s.enabled = m_voiceDuckEnabled.load(std::memory_order_relaxed);
+    s.threshold = m_voiceDuckThreshold.load(std::memory_order_relaxed);
+    s.attackMs = m_voiceDuckAttackMs.load(std::memory_order_relaxed);
+    s.releaseMs = m_voiceDuckReleaseMs.load(std::memory_order_relaxed);
+    s.depthDb = m_voiceDuckDepthDb.load(std::memory_order_relaxed);
+    return s;
+}
+
+float AudioEngine::getVoiceDuckGainDb() const
+{
+    return m_voiceDuckGainDb.load(std::memory_order_relaxed);
+}
+
 void AudioEngine::setMasterGainDB(float gainDB_)
 {
     masterGainDB.store(gainDB_, std::memory_order_relaxed);
@@ -1028,13 +1475,56 @@ void AudioEngine::setNoiseSuppressionLevel(int level)
     level = std::max(0, std::min(4, level));
     m_noiseSuppressionLevel.store(level, std::memory_order_relaxed);
 
-    if (m_noiseSuppressor) {
-        m_noiseSuppressor->setSuppressionLevel(static_cast<NoiseSuppressionLevel>(level));
+    if (m_noiseSuppressors) {
+        m_noiseSuppressors->stream(NS_STREAM_MIC).setSuppressionLevel(static_cast<NoiseSuppressionLevel>(level));
     }
 
     std::cout << "[AudioEngine] Noise suppression level set to " << level << "\n";
 }
 
+void AudioEngine::setRecordingInputNoiseSuppressionLevel(int level)
+{
+    level = std::max(0, std::min(4, level));
+    m_recordingInputNoiseSuppressionLevel.store(level, std::memory_order_relaxed);
+
+    if (m_noiseSuppressors) {
+        m_noiseSuppressors->stream(NS_STREAM_RECORDING_INPUT)
+            .setSuppressionLevel(static_cast<NoiseSuppressionLevel>(level));
+    }
+
+    std::cout << "[AudioEngine] Recording input noise suppression level set to " << level << "\n";
+}
+
+int AudioEngine::getRecordingInputNoiseSuppressionLevel() const
+{
+    return m_recordingInputNoiseSuppressionLevel.load(std::memory_order_relaxed);
+}
+
+double AudioEngine::getNoiseSuppressionLatencyMs() const
+{
+    if (m_sampleRate == 0)
+        return 0.0;
+    ma_uint32 frames = 0;
+    if (m_dspActive.load(std::memory_order_acquire))
+        frames += m_dspPrimeFrames;
+    const NoiseSuppressor* mic = m_noiseSuppressors ? &m_noiseSuppressors->stream(NS_STREAM_MIC) : nullptr;
+    if (mic && mic->isEnabled())
+        frames += mic->getLatencyFrames();
+    return 1000.0 * frames / m_sampleRate;
+}
+
+void AudioEngine::setNoiseSuppressionOnDspThread(bool enabled)
+{
+    m_nsOnDspThread.store(enabled, std::memory_order_relaxed);
+    std::cout << "[AudioEngine] Noise suppression on DSP thread: " << (enabled ? "yes" : "no")
+              << " (applies on next device start)\n";
+}
+
+bool AudioEngine::isNoiseSuppressionOnDspThread() const
+{
+    return m_nsOnDspThread.load(std::memory_order_relaxed);
+}
+
 int AudioEngine::getNoiseSuppressionLevel() const
 {
     return m_noiseSuppressionLevel.load(std::memory_order_relaxed);
@@ -1066,6 +1556,41 @@ void AudioEngine::resetPeakLevels()
     monitorPeakLevel.store(0.0f, std::memory_order_relaxed);
 }
 
+AudioEngine::MeterSnapshot AudioEngine::getMeterSnapshot() const
+{
+    MeterSnapshot s;
+    s.mic = m_micMeter.reading();
+    s.master = m_masterMeter.reading();
+    s.monitor = m_monitorMeter.reading();
+    for (int i = 0; i < MAX_CLIPS; ++i) {
+        if (clips[i].state.load(std::memory_order_relaxed) != ClipState::Stopped)
+            s.voices[i] = clips[i].meterReading.load();
+    }
+    return s;
+}
+
+AudioEngine::TelemetrySnapshot AudioEngine::getTelemetrySnapshot() const
+{
+    TelemetrySnapshot s;
+    s.meters = getMeterSnapshot();
+    for (int i = 0; i < MAX_CLIPS; ++i) {
+        const ClipState st = clips[i].state.load(std::memory_order_relaxed);
+        VoiceTelemetry& v = s.voices[i];
+        v.playing = st == ClipState::Playing || st == ClipState::Draining || st == ClipState::Paused;
+        v.paused = st == ClipState::Paused;
+        if (v.playing)
+            v.positionMs = getClipPlaybackPositionMs(i);
+    }
+    return s;
+}
+
+void AudioEngine::resetMeters()
+{
+    m_micMeter.reset();
+    m_masterMeter.reset();
+    m_monitorMeter.reset();
+}
+
 // ------------------------------------------------------------
 // Clip callbacks
 // ------------------------------------------------------------
@@ -1098,7 +1623,11 @@ void AudioEngine::captureCallback(ma_device* pDevice, void*, const void* pInput,
 
     if (!engine->deviceRunning.load(std::memory_order_acquire))
         return;
+
+    const int64_t startNs = latencyClockNs();
     engine->processCaptureInput(pInput, frameCount, pDevice->capture.channels, pDevice->capture.format);
+    engine->m_callbackProfiles[(int)EngineCallback::Capture].record(latencyClockNs() - startNs, frameCount,
+                                                                     pDevice->sampleRate);
 }
 
 void AudioEngine::processCaptureInput(const void* input, ma_uint32 frameCount, ma_uint32 captureChannels, ma_format fmt)
@@ -1107,18 +1636,11 @@ void AudioEngine::processCaptureInput(const void* input, ma_uint32 frameCount, m
         return;
 
     const bool micOn = micEnabled.load(std::memory_order_relaxed);
-    const float micG = micGain.load(std::memory_order_relaxed);
+    const float micG = micGain.load(std::memory_order_relaxed) * micDuckGain.load(std::memory_order_relaxed);
 
-    float peak = 0.0f;
-
-    void* pWrite = nullptr;
-    ma_uint32 framesToWrite = frameCount;
-
-    if (ma_pcm_rb_acquire_write(&captureRb, &framesToWrite, &pWrite) != MA_SUCCESS || framesToWrite == 0 || !pWrite) {
-        return; // drop if full
-    }
-
-    float* dst = static_cast<float*>(pWrite);
+    // With the DSP thread active the callback only downmixes; suppression and metering happen there
+    const bool toDspThread = m_dspActive.load(std::memory_order_acquire);
+    ma_pcm_rb* rb = toDspThread ? &m_dspInputRb : &captureRb;
 
     auto readSample = [&](ma_uint32 frame, ma_uint32 ch) -> float {
         if (!input || captureChannels == 0)
@@ -1137,31 +1659,60 @@ void AudioEngine::processCaptureInput(const void* input, ma_uint32 frameCount, m
         }
     };
 
-    for (ma_uint32 f = 0; f < framesToWrite; ++f) {
-        float mono = 0.0f;
-        if (micOn && input && captureChannels > 0) {
-            for (ma_uint32 ch = 0; ch < captureChannels; ++ch) {
-                mono += readSample(f, ch);
+    float peak = 0.0f;
+
+    // The ring hands out contiguous space only, so a block that straddles its end goes in two pieces
+    ma_uint32 written = 0;
+    while (written < frameCount) {
+        void* pWrite = nullptr;
+        ma_uint32 framesToWrite = frameCount - written;
+
+        if (ma_pcm_rb_acquire_write(rb, &framesToWrite, &pWrite) != MA_SUCCESS || framesToWrite == 0 || !pWrite) {
+            m_captureOverruns.fetch_add(1, std::memory_order_relaxed);
+            break; // drop the rest if full
+        }
+
+        float* dst = static_cast<float*>(pWrite);
+
+        for (ma_uint32 f = 0; f < framesToWrite; ++f) {
+            float mono = 0.0f;
+            if (micOn && input && captureChannels > 0) {
+                for (ma_uint32 ch = 0; ch < captureChannels; ++ch) {
+                    mono += readSample(written + f, ch);
+                }
+                mono = (mono / (float)captureChannels) * micG;
+            } else {
+                mono = 0.0f;
             }
-            mono = (mono / (float)captureChannels) * micG;
-        } else {
-            mono = 0.0f;
+
+            dst[f] = mono;
         }
 
-        dst[f] = mono;
-    }
+        if (!toDspThread) {
+            // Apply noise suppression to the mono buffer (in-place)
+            if (m_noiseSuppressors && micOn) {
+                m_noiseSuppressors->process(NS_STREAM_MIC, dst, (int)framesToWrite);
+            }
 
-    // Apply noise suppression to the mono buffer (in-place)
-    if (m_noiseSuppressor && m_noiseSuppressor->isEnabled() && micOn) {
-        m_noiseSuppressor->process(dst, framesToWrite);
-    }
+            // Calculate peak after noise suppression
+            for (ma_uint32 f = 0; f < framesToWrite; ++f) {
+                peak = std::max(peak, std::abs(dst[f]));
+            }
+        }
 
-    // Calculate peak after noise suppression
-    for (ma_uint32 f = 0; f < framesToWrite; ++f) {
-        peak = std::max(peak, std::abs(dst[f]));
+        ma_pcm_rb_commit_write(rb, framesToWrite);
+        if (!toDspThread)
+            pushVadMark(framesToWrite, micVoiceActivity(dst, framesToWrite, micOn));
+        written += framesToWrite;
     }
 
-    ma_pcm_rb_commit_write(&captureRb, framesToWrite);
+    if (toDspThread) {
+        if (written > 0) {
+            m_dspWake.fetch_add(1, std::memory_order_release);
+            m_dspWake.notify_one();
+        }
+        return;
+    }
 
     // peak meter
     float cur = micPeakLevel.load(std::memory_order_relaxed);
@@ -1183,7 +1734,11 @@ void AudioEngine::playbackCallback(ma_device* pDevice, void* pOutput, const void
         return;
     }
 
+    const int64_t startNs = latencyClockNs();
     engine->processPlaybackAudio(pOutput, frameCount, pDevice->playback.channels);
+    engine->frameClock.fetch_add(frameCount, std::memory_order_release);
+    engine->m_callbackProfiles[(int)EngineCallback::Playback].record(latencyClockNs() - startNs, frameCount,
+                                                                      pDevice->sampleRate);
 }
 
 void AudioEngine::processPlaybackAudio(void* output, ma_uint32 frameCount, ma_uint32 playbackChannels)
@@ -1213,6 +1768,7 @@ void AudioEngine::processPlaybackAudio(void* output, ma_uint32 frameCount, ma_ui
     // --------------------------------------------------------
     std::vector<float> micMono;
     micMono.resize(frameCount, 0.0f);
+    ma_uint32 micFrames = 0;
 
     if (captureRbData) {
         void* pRead = nullptr;
@@ -1223,9 +1779,21 @@ void AudioEngine::processPlaybackAudio(void* output, ma_uint32 frameCount, ma_ui
             for (ma_uint32 f = 0; f < want; ++f)
                 micMono[f] = src[f];
             ma_pcm_rb_commit_read(&captureRb, want);
+            micFrames = want;
         }
     }
 
+    // Metered over the whole block: frames the mic did not deliver count as silence
+    m_micMeter.process(micMono.data(), frameCount, 1, m_sampleRate);
+
+    // Clip gain per frame from the mic's voice activity, aligned with the mic frames just read
+    computeVoiceDuck(micFrames, frameCount);
+    const float* voiceDuck = m_voiceDuckScratch.data();
+
+    if (m_voiceGainScratch.size() < (size_t)frameCount)
+        m_voiceGainScratch.resize(frameCount);
+    float* voiceGain = m_voiceGainScratch.data();
+
     const bool recordMic = recordMicEnabled.load(std::memory_order_relaxed);
     const bool recordClips = recordPlaybackEnabled.load(std::memory_order_relaxed);
 
@@ -1250,29 +1818,114 @@ void AudioEngine::processPlaybackAudio(void* output, ma_uint32 frameCount, ma_ui
     // --------------------------------------------------------
     // Clips mixing (MAIN ring buffers)
     // --------------------------------------------------------
+    // Engine time of this block's first frame; scheduled starts/stops land at an offset inside it
+    const uint64_t blockStart = frameClock.load(std::memory_order_relaxed);
+    const uint64_t blockEnd = blockStart + frameCount;
+
     for (int slotId = 0; slotId < MAX_CLIPS; ++slotId) {
         ClipSlot& slot = clips[slotId];
         auto st = slot.state.load(std::memory_order_relaxed);
         if (st != ClipState::Playing && st != ClipState::Draining)
             continue;
 
-        const float clipGain = slot.gain.load(std::memory_order_relaxed) * clipMul;
+        // Scheduled start: silent until the block containing startAtFrame, then mixed from that offset
+        ma_uint32 startOffset = 0;
+        const uint64_t startAt = slot.startAtFrame.load(std::memory_order_acquire);
+        if (startAt != kNoScheduledFrame) {
+            if (startAt >= blockEnd)
+                continue;
+            startOffset = startAt > blockStart ? (ma_uint32)(startAt - blockStart) : 0;
+            slot.startAtFrame.store(kNoScheduledFrame, std::memory_order_release);
+        }
+
+        // Scheduled stop: the stop fade begins exactly at stopAtFrame, the decoder thread ends the clip after it
+        const uint64_t stopAt = slot.stopAtFrame.load(std::memory_order_acquire);
+        if (stopAt != kNoScheduledFrame && stopAt < blockEnd &&
+            slot.stopFadeFrames.load(std::memory_order_relaxed) == 0) {
+            const uint32_t offset = stopAt > blockStart ? (uint32_t)(stopAt - blockStart) : 0;
+            const double stopFadeMs = slot.stopFadeMs.load(std::memory_order_relaxed);
+            const uint32_t fade = std::max<uint32_t>(
+                1, fadeFramesFor(stopFadeMs >= 0.0 ? stopFadeMs : clipFadeMs.load(std::memory_order_relaxed)));
+            slot.stopFadeMainLeft.store(offset + fade, std::memory_order_relaxed);
+            slot.stopFadeMonLeft.store(monitorRunning.load(std::memory_order_relaxed) ? fade : 0,
+                                       std::memory_order_relaxed);
+            slot.stopFadeFrames.store(fade, std::memory_order_release);
+            slot.stopAtFrame.store(kNoScheduledFrame, std::memory_order_relaxed);
+            slot.scheduledStopHit.store(true, std::memory_order_release);
+        }
+
+        // Stop fade in progress: stopClip waits until this output has ramped to silence
+        const uint32_t stopFadeTotal = slot.stopFadeFrames.load(std::memory_order_acquire);
+        uint32_t stopFadeLeft = 0;
+        if (stopFadeTotal > 0) {
+            stopFadeLeft = slot.stopFadeMainLeft.load(std::memory_order_relaxed);
+            if (stopFadeLeft == 0)
+                continue;
+            slot.stopFadeMainLeft.store(stopFadeLeft > frameCount ? stopFadeLeft - frameCount : 0,
+                                        std::memory_order_release);
+        }
+
+        // Pause fade: pauseClip waits until this output's level ramp has reached silence
+        retargetVoiceRamps(slot, slot.mainRamps);
+        const uint32_t pauseFadeLeft = slot.pauseFadeMainLeft.load(std::memory_order_acquire);
+        if (pauseFadeLeft > 0 && slot.mainRamps.level.target == 0.0f)
+            slot.pauseFadeMainLeft.store(pauseFadeLeft > frameCount ? pauseFadeLeft - frameCount : 0,
+                                         std::memory_order_release);
+
         const bool isMonitorOnly = slot.monitorOnly.load(std::memory_order_relaxed);
 
         void* pRead = nullptr;
-        ma_uint32 availFrames = frameCount;
+        ma_uint32 availFrames = frameCount - startOffset;
+
+        // Decoder fell behind: a started clip (not yet draining at EOF) has less ready than this block needs
+        if (st == ClipState::Playing && slot.mainPrimed.load(std::memory_order_relaxed) &&
+            ma_pcm_rb_available_read(&slot.ringBufferMain) < availFrames)
+            m_clipUnderruns.fetch_add(1, std::memory_order_relaxed);
 
         if (ma_pcm_rb_acquire_read(&slot.ringBufferMain, &availFrames, &pRead) == MA_SUCCESS && availFrames > 0 &&
             pRead) {
+            slot.mainPrimed.store(true, std::memory_order_relaxed);
             float* clip = static_cast<float*>(pRead); // stereo 2ch
+            if (stopFadeTotal > 0)
+                applyStopFade(clip, availFrames, stopFadeLeft, stopFadeTotal);
+            if (slot.traceArmed.load(std::memory_order_acquire) &&
+                slot.traceToken.load(std::memory_order_relaxed) == slot.mainRamps.playToken)
+                finishLatencyTrace(slot, startOffset);
+
+            voiceGains(slot.mainRamps, voiceGain, availFrames);
+            float energy = 0.0f;
+            float blockPeak = 0.0f;
+            for (ma_uint32 f = 0; f < availFrames; ++f) {
+                voiceGain[f] *= clipMul * voiceDuck[startOffset + f];
+                const float L = clip[f * 2] * voiceGain[f];
+                const float R = clip[f * 2 + 1] * voiceGain[f];
+                energy += L * L + R * R;
+                blockPeak = std::max(blockPeak, std::max(std::abs(L), std::abs(R)));
+            }
+
+            // Live RMS for quietest-voice stealing (~300 ms time constant, whatever the block size)
+            const float blockRms = std::sqrt(energy / (2.0f * (float)availFrames));
+            const float rmsCoeff = 1.0f - std::exp(-(float)availFrames / (0.3f * (float)m_sampleRate));
+            const float prevRms = slot.liveRms.load(std::memory_order_relaxed);
+            const float rms = prevRms + (blockRms - prevRms) * rmsCoeff;
+            slot.liveRms.store(rms, std::memory_order_relaxed);
+
+            // Voice meter; a new play starts from silence
+            if (slot.meterToken != slot.mainRamps.playToken) {
+                slot.meterToken = slot.mainRamps.playToken;
+                slot.meterPeakHold = 0.0f;
+                slot.meterPeakHoldLeft = 0;
+            }
+            BusMeter::holdPeak(blockPeak, slot.meterPeakHold, slot.meterPeakHoldLeft, availFrames, m_sampleRate);
+            slot.meterReading.store({rms, slot.meterPeakHold});
 
             // Only mix into main output if NOT monitor-only
             if (!isMonitorOnly) {
                 if (playbackChannels == 2) {
                     for (ma_uint32 f = 0; f < availFrames; ++f) {
-                        const ma_uint32 o = f * 2;
-                        const float L = clip[f * 2] * clipGain;
-                        const float R = clip[f * 2 + 1] * clipGain;
+                        const ma_uint32 o = (startOffset + f) * 2;
+                        const float L = clip[f * 2] * voiceGain[f];
+                        const float R = clip[f * 2 + 1] * voiceGain[f];
 
                         out[o] += L;
                         out[o + 1] += R;
@@ -1285,11 +1938,11 @@ void AudioEngine::processPlaybackAudio(void* output, ma_uint32 frameCount, ma_ui
                     }
                 } else {
                     for (ma_uint32 f = 0; f < availFrames; ++f) {
-                        const float L = clip[f * 2] * clipGain;
-                        const float R = clip[f * 2 + 1] * clipGain;
+                        const float L = clip[f * 2] * voiceGain[f];
+                        const float R = clip[f * 2 + 1] * voiceGain[f];
                         const float mono = (L + R) * 0.5f;
 
-                        const ma_uint32 o = f * playbackChannels;
+                        const ma_uint32 o = (startOffset + f) * playbackChannels;
                         for (ma_uint32 ch = 0; ch < playbackChannels; ++ch) {
                             out[o + ch] += mono;
                             // Only add clips to recording if recordClips is enabled
@@ -1355,6 +2008,7 @@ void AudioEngine::processPlaybackAudio(void* output, ma_uint32 frameCount, ma_ui
     float cur = masterPeakLevel.load(std::memory_order_relaxed);
     if (outPeak > cur)
         masterPeakLevel.store(outPeak, std::memory_order_relaxed);
+    m_masterMeter.process(out, frameCount, playbackChannels, m_sampleRate);
 
     // --------------------------------------------------------
     // Recording output (push to recordingRb, realtime-safe)
@@ -1374,6 +2028,8 @@ void AudioEngine::processPlaybackAudio(void* output, ma_uint32 frameCount, ma_ui
             recordedFrames.fetch_add(framesToWrite, std::memory_order_relaxed);
         }
         // If full: drop frames (prefer glitch-free playback)
+        if (framesToWrite < frameCount)
+            m_recordingOverruns.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
@@ -1388,7 +2044,11 @@ void AudioEngine::monitorCallback(ma_device* pDevice, void* pOutput, const void*
             std::memset(pOutput, 0, frameCount * pDevice->playback.channels * sizeof(float));
         return;
     }
+
+    const int64_t startNs = latencyClockNs();
     engine->processMonitorAudio(pOutput, frameCount, pDevice->playback.channels);
+    engine->m_callbackProfiles[(int)EngineCallback::Monitor].record(latencyClockNs() - startNs, frameCount,
+                                                                     pDevice->sampleRate);
 }
 
 void AudioEngine::processMonitorAudio(void* output, ma_uint32 frameCount, ma_uint32 playbackChannels)
@@ -1400,13 +2060,34 @@ void AudioEngine::processMonitorAudio(void* output, ma_uint32 frameCount, ma_uin
     float micMul = 1.0f, clipMul = 1.0f;
     computeBalanceMultipliers(micSoundboardBalance.load(std::memory_order_relaxed), micMul, clipMul);
 
+    if (m_monVoiceGainScratch.size() < (size_t)frameCount)
+        m_monVoiceGainScratch.resize(frameCount);
+    float* voiceGain = m_monVoiceGainScratch.data();
+
     for (int slotId = 0; slotId < MAX_CLIPS; ++slotId) {
         ClipSlot& slot = clips[slotId];
         auto st = slot.state.load(std::memory_order_relaxed);
         if (st != ClipState::Playing && st != ClipState::Draining)
             continue;
+        // Scheduled start is timed on the main output's clock; the monitor follows once it has started
+        if (slot.startAtFrame.load(std::memory_order_acquire) != kNoScheduledFrame)
+            continue;
+
+        const uint32_t stopFadeTotal = slot.stopFadeFrames.load(std::memory_order_acquire);
+        uint32_t stopFadeLeft = 0;
+        if (stopFadeTotal > 0) {
+            stopFadeLeft = slot.stopFadeMonLeft.load(std::memory_order_relaxed);
+            if (stopFadeLeft == 0)
+                continue;
+            slot.stopFadeMonLeft.store(stopFadeLeft > frameCount ? stopFadeLeft - frameCount : 0,
+                                       std::memory_order_release);
+        }
 
-        const float clipGain = slot.gain.load(std::memory_order_relaxed) * clipMul;
+        retargetVoiceRamps(slot, slot.monRamps);
+        const uint32_t pauseFadeLeft = slot.pauseFadeMonLeft.load(std::memory_order_acquire);
+        if (pauseFadeLeft > 0 && slot.monRamps.level.target == 0.0f)
+            slot.pauseFadeMonLeft.store(pauseFadeLeft > frameCount ? pauseFadeLeft - frameCount : 0,
+                                        std::memory_order_release);
 
         void* pRead = nullptr;
         ma_uint32 availFrames = frameCount;
@@ -1414,17 +2095,23 @@ void AudioEngine::processMonitorAudio(void* output, ma_uint32 frameCount, ma_uin
         if (ma_pcm_rb_acquire_read(&slot.ringBufferMon, &availFrames, &pRead) == MA_SUCCESS && availFrames > 0 &&
             pRead) {
             float* clip = static_cast<float*>(pRead); // stereo
+            if (stopFadeTotal > 0)
+                applyStopFade(clip, availFrames, stopFadeLeft, stopFadeTotal);
+
+            voiceGains(slot.monRamps, voiceGain, availFrames);
+            for (ma_uint32 f = 0; f < availFrames; ++f)
+                voiceGain[f] *= clipMul;
 
             if (playbackChannels == 2) {
                 for (ma_uint32 f = 0; f < availFrames; ++f) {
                     const ma_uint32 o = f * 2;
-                    out[o] += clip[f * 2] * clipGain;
-                    out[o + 1] += clip[f * 2 + 1] * clipGain;
+                    out[o] += clip[f * 2] * voiceGain[f];
+                    out[o + 1] += clip[f * 2 + 1] * voiceGain[f];
                 }
             } else {
                 for (ma_uint32 f = 0; f < availFrames; ++f) {
-                    const float L = clip[f * 2] * clipGain;
-                    const float R = clip[f * 2 + 1] * clipGain;
+                    const float L = clip[f * 2] * voiceGain[f];
+                    const float R = clip[f * 2 + 1] * voiceGain[f];
                     const float mono = (L + R) * 0.5f;
 
                     const ma_uint32 o = f * playbackChannels;
@@ -1459,6 +2146,7 @@ void AudioEngine::processMonitorAudio(void* output, ma_uint32 frameCount, ma_uin
     float cur = monitorPeakLevel.load(std::memory_order_relaxed);
     if (peak > cur)
         monitorPeakLevel.store(peak, std::memory_order_relaxed);
+    m_monitorMeter.process(out, frameCount, playbackChannels, m_sampleRate);
 }
 
 // ------------------------------------------------------------
@@ -1471,32 +2159,65 @@ void AudioEngine::recordingInputCallback(ma_device* pDevice, void*, const void*
         return;
     if (!pInput)
         return;
+
+    const int64_t startNs = latencyClockNs();
     engine->processRecordingInput(pInput, frameCount, pDevice->capture.channels);
+    engine->m_callbackProfiles[(int)EngineCallback::RecordingInput].record(latencyClockNs() - startNs, frameCount,
+                                                                            pDevice->sampleRate);
 }
 
 void AudioEngine::processRecordingInput(const void* input, ma_uint32 frameCount, ma_uint32 captureChannels)
 {
-    if (!recordingInputRbData)
+    if (!recordingInputRbData || captureChannels == 0)
         return;
 
-    const float* in = static_cast<const float*>(input);
+    // Same routing as the main mic: straight to the mix, or to the DSP thread for suppression
+    const bool toDspThread = m_dspActive.load(std::memory_order_acquire);
+    if (!toDspThread && m_dspRunning.load(std::memory_order_acquire)) {
+        m_recordingInputOverruns.fetch_add(1, std::memory_order_relaxed); // DSP thread winding down
+        return;
+    }
+    ma_pcm_rb* rb = toDspThread ? &m_dspRecInputRb : &recordingInputRb;
 
-    void* pWrite = nullptr;
-    ma_uint32 toWrite = frameCount;
+    const float* in = static_cast<const float*>(input);
 
     // Apply mic gain to recording input for consistent levels
     const float micG = micGain.load(std::memory_order_relaxed);
+    const float alpha = recordingHPFAlpha;
+
+    ma_uint32 written = 0;
+    while (written < frameCount) {
+        void* pWrite = nullptr;
+        ma_uint32 toWrite = frameCount - written;
+        if (ma_pcm_rb_acquire_write(rb, &toWrite, &pWrite) != MA_SUCCESS || toWrite == 0 || !pWrite) {
+            m_recordingInputOverruns.fetch_add(1, std::memory_order_relaxed);
+            break; // drop the rest if full
+        }
 
-    if (ma_pcm_rb_acquire_write(&recordingInputRb, &toWrite, &pWrite) == MA_SUCCESS && toWrite > 0 && pWrite) {
         float* dst = static_cast<float*>(pWrite);
         for (ma_uint32 f = 0; f < toWrite; ++f) {
             float mono = 0.0f;
             for (ma_uint32 ch = 0; ch < captureChannels; ++ch)
-                mono += in[f * captureChannels + ch];
+                mono += in[(written + f) * captureChannels + ch];
             mono = (mono / (float)captureChannels) * micG; // Apply mic gain
-            dst[f] = mono;
+
+            // y[n] = a * (y[n-1] + x[n] - x[n-1])
+            const float hp = alpha * (recordingHPFPrevOut + mono - recordingHPFPrevIn);
+            recordingHPFPrevIn = mono;
+            recordingHPFPrevOut = hp;
+            dst[f] = hp;
         }
-        ma_pcm_rb_commit_write(&recordingInputRb, toWrite);
+
+        if (!toDspThread && m_noiseSuppressors)
+            m_noiseSuppressors->process(NS_STREAM_RECORDING_INPUT, dst, (int)toWrite);
+
+        ma_pcm_rb_commit_write(rb, toWrite);
+        written += toWrite;
+    }
+
+    if (toDspThread && written > 0) {
+        m_dspWake.fetch_add(1, std::memory_order_release);
+        m_dspWake.notify_one();
     }
 }
 
@@ -1511,65 +2232,151 @@ void AudioEngine::decoderThreadFunc(AudioEngine* engine, ClipSlot* slot, int slo
         return;
     }
 
-    ma_decoder_config cfg = ma_decoder_config_init(ma_format_f32, 2, engine->m_sampleRate);
-    ma_decoder dec;
-    bool usingMiniaudio = false;
-    FFmpegDecoder ffmpegDec;
-
-#ifdef _WIN32
-    std::wstring wpath = utf8ToWide(filepath);
-    if (ma_decoder_init_file_w(wpath.c_str(), &cfg, &dec) == MA_SUCCESS) {
-        usingMiniaudio = true;
-    }
-#else
-    if (ma_decoder_init_file(filepath.c_str(), &cfg, &dec) == MA_SUCCESS) {
-        usingMiniaudio = true;
-    }
-#endif
-
-    // If miniaudio failed, try FFmpeg as fallback (for Opus, etc.)
-    if (!usingMiniaudio) {
-        std::cout << "[AudioEngine] miniaudio failed for: " << filepath << ", trying FFmpeg...\n";
-        if (ffmpegDec.open(filepath, engine->m_sampleRate, 2)) {
-            std::cout << "[AudioEngine] FFmpeg decoder opened successfully\n";
-        } else {
-            std::cerr << "[AudioEngine] Both miniaudio and FFmpeg failed for: " << filepath << "\n";
-            slot->state.store(ClipState::Stopped, std::memory_order_release);
-            std::lock_guard<std::mutex> lock(engine->callbackMutex);
-            if (engine->clipErrorCallback)
-                engine->clipErrorCallback(slotId);
-            return;
+    // A clip at another rate plays from its converted copy once that exists (no live resampling)
+    std::string decodePath = filepath;
+    DecoderBackend backend = slot->backend;
+    std::shared_ptr<const SeekIndex> seekIndex = slot->seekIndex;
+    if (!seekIndex) // built in the background since the clip was loaded?
+        seekIndex = engine->m_mediaInfoCache.seekIndex(filepath);
+    if (slot->nativeSampleRate != 0 && slot->nativeSampleRate != engine->m_sampleRate) {
+        std::string converted = engine->m_resampledClips.acquire(filepath, engine->m_sampleRate);
+        if (!converted.empty()) {
+            decodePath = std::move(converted);
+            backend = DecoderBackend::Miniaudio;
+            seekIndex.reset(); // PCM seeks directly
         }
     }
 
-    // Set sample rate and channels based on which decoder is being used
-    if (usingMiniaudio) {
-        slot->sampleRate.store((int)dec.outputSampleRate, std::memory_order_relaxed);
-        slot->channels.store((int)dec.outputChannels, std::memory_order_relaxed);
-    } else {
-        slot->sampleRate.store((int)ffmpegDec.getSampleRate(), std::memory_order_relaxed);
-        slot->channels.store((int)ffmpegDec.getChannels(), std::memory_order_relaxed);
+    // Start with the backend that decoded this file last time (skips a doomed miniaudio attempt for Opus etc.)
+    ClipDecoder dec;
+    dec.setResamplerQuality(engine->getResamplerQuality());
+    if (!dec.open(decodePath, engine->m_sampleRate, 2, backend)) {
+        slot->state.store(ClipState::Stopped, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(engine->callbackMutex);
+        if (engine->clipErrorCallback)
+            engine->clipErrorCallback(slotId);
+        return;
     }
+    if (decodePath == filepath && dec.backend() != slot->backend) {
+        engine->m_mediaInfoCache.updateBackend(filepath, dec.backend());
+    }
+    // Trim start and scrubbing jump via the precomputed index instead of decoding from the top
+    dec.setSeekIndex(seekIndex);
+
+    slot->sampleRate.store((int)dec.getSampleRate(), std::memory_order_relaxed);
+    slot->channels.store((int)dec.getChannels(), std::memory_order_relaxed);
 
-    const uint32_t decoderSampleRate = usingMiniaudio ? dec.outputSampleRate : ffmpegDec.getSampleRate();
+    const uint32_t decoderSampleRate = dec.getSampleRate();
+    const uint64_t fileFrames = dec.getLengthInPcmFrames(); // 0 if the container doesn't say
+    auto msToFrame = [decoderSampleRate](double ms) { return (uint64_t)((ms / 1000.0) * decoderSampleRate); };
 
     double startMs = slot->trimStartMs.load(std::memory_order_relaxed);
     if (startMs > 0.0) {
-        ma_uint64 startFrame = (ma_uint64)((startMs / 1000.0) * decoderSampleRate);
-        if (usingMiniaudio) {
-            ma_decoder_seek_to_pcm_frame(&dec, startFrame);
-        } else {
-            ffmpegDec.seekToPcmFrame(startFrame);
-        }
+        dec.seekToPcmFrame(msToFrame(startMs));
     }
+    // Tracked here rather than queried: only exact right after a seek for some backends
+    uint64_t decodePos = dec.getCursorInPcmFrames();
 
     constexpr ma_uint32 kFrames = 1024;
     float buf[kFrames * 2];
 
+    // Gapless looping: the first frames after trimStart are kept in memory, so at trimEnd the
+    // decoder writes them straight into the ring (crossfaded with the tail if requested) and
+    // seeks past them, instead of waiting for the ring to drain and seeking back.
+    constexpr double kLoopHeadMs = 250.0;
+    std::vector<float> loopHead; // interleaved stereo, starts at loopHeadStart
+    uint64_t loopHeadStart = UINT64_MAX;
+    std::vector<float> loopTail;
+    std::vector<float> loopBlock;
+
+    // Loop boundaries still queued in the ring: {frames written before it, frames to rewind the position by}
+    std::deque<std::pair<uint64_t, uint64_t>> loopBoundaries;
+    uint64_t framesWritten = 0;
+
+    // Reports boundaries once the mixer has consumed past them, so loop events line up with what is heard
+    auto reportLoops = [&]() {
+        if (loopBoundaries.empty() || slot->seekPosMs.load(std::memory_order_relaxed) >= 0.0)
+            return;
+        const long long queued = std::max(0LL, slot->queuedMainFrames.load(std::memory_order_relaxed));
+        const uint64_t played = framesWritten - std::min(framesWritten, (uint64_t)queued);
+        while (!loopBoundaries.empty() && played >= loopBoundaries.front().first) {
+            slot->playbackFrameCount.fetch_sub((long long)loopBoundaries.front().second, std::memory_order_relaxed);
+            loopBoundaries.pop_front();
+
+            std::lock_guard<std::mutex> lock(engine->callbackMutex);
+            if (engine->clipLoopedCallback)
+                engine->clipLoopedCallback(slotId);
+        }
+    };
+
+    // stopClipAt fired and both outputs have faded out
+    auto scheduledStopDone = [slot]() {
+        return slot->scheduledStopHit.load(std::memory_order_acquire) &&
+               slot->stopFadeMainLeft.load(std::memory_order_acquire) == 0 &&
+               slot->stopFadeMonLeft.load(std::memory_order_acquire) == 0;
+    };
+
+    // Blocks until everything is in the main ring; false if the clip is being stopped
+    auto writeFrames = [&](const float* data, uint64_t frameCount) -> bool {
+        while (frameCount > 0) {
+            auto st = slot->state.load(std::memory_order_acquire);
+            if (st == ClipState::Stopping || scheduledStopDone())
+                return false;
+            if (st == ClipState::Paused) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+
+            void* wMain = nullptr;
+            ma_uint32 toWrite = (ma_uint32)std::min<uint64_t>(frameCount, kFrames);
+
+            if (ma_pcm_rb_acquire_write(&slot->ringBufferMain, &toWrite, &wMain) == MA_SUCCESS && toWrite > 0 &&
+                wMain) {
+                std::memcpy(wMain, data, toWrite * 2 * sizeof(float));
+                ma_pcm_rb_commit_write(&slot->ringBufferMain, toWrite);
+                slot->queuedMainFrames.fetch_add((long long)toWrite, std::memory_order_relaxed);
+                if (framesWritten == 0 && slot->traceToken.load(std::memory_order_relaxed) == token)
+                    stampLatency(slot->traceDecodedNs, *slot);
+                framesWritten += toWrite;
+
+                // best-effort monitor buffer
+                void* wMon = nullptr;
+                ma_uint32 toWriteMon = toWrite;
+                if (ma_pcm_rb_acquire_write(&slot->ringBufferMon, &toWriteMon, &wMon) == MA_SUCCESS && toWriteMon > 0 &&
+                    wMon) {
+                    const ma_uint32 n = std::min(toWriteMon, toWrite);
+                    std::memcpy(wMon, data, n * 2 * sizeof(float));
+                    ma_pcm_rb_commit_write(&slot->ringBufferMon, n);
+                }
+
+                data += toWrite * 2;
+                frameCount -= toWrite;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            reportLoops();
+        }
+        return true;
+    };
+
+    // Reads until frameCount frames or end of file; returns frames read
+    auto readFully = [&](float* out, uint64_t frameCount) -> uint64_t {
+        uint64_t total = 0;
+        while (total < frameCount) {
+            uint64_t got = 0;
+            const ma_result r = dec.readPcmFrames(out + total * 2, frameCount - total, &got);
+            total += got;
+            if (got == 0 || (r != MA_SUCCESS && r != MA_AT_END))
+                break;
+        }
+        return total;
+    };
+
     bool naturalEnd = false;
+    bool wrapped = false;
 
     while (true) {
-        if (slot->state.load(std::memory_order_acquire) == ClipState::Stopping)
+        if (slot->state.load(std::memory_order_acquire) == ClipState::Stopping || scheduledStopDone())
             break;
 
         while (slot->state.load(std::memory_order_acquire) == ClipState::Paused) {
@@ -1582,153 +2389,147 @@ void AudioEngine::decoderThreadFunc(AudioEngine* engine, ClipSlot* slot, int slo
 
         double seekMs = slot->seekPosMs.exchange(-1.0, std::memory_order_relaxed);
         if (seekMs >= 0.0) {
-            ma_uint64 target = (ma_uint64)((seekMs / 1000.0) * decoderSampleRate);
-            if (usingMiniaudio) {
-                ma_decoder_seek_to_pcm_frame(&dec, target);
-            } else {
-                ffmpegDec.seekToPcmFrame(target);
-            }
+            dec.seekToPcmFrame(msToFrame(seekMs));
+            decodePos = dec.getCursorInPcmFrames();
+            // seekClip already set the position; older boundaries must not rewind it again
+            loopBoundaries.clear();
         }
 
-        ma_uint64 framesRead = 0;
-        bool readError = false;
+        // Trim/loop settings can change while playing (clip editor), so re-read them every block
+        const uint64_t startFrame = msToFrame(slot->trimStartMs.load(std::memory_order_relaxed));
+        const double endMs = slot->trimEndMs.load(std::memory_order_relaxed);
+        uint64_t endFrame = endMs > 0.0 ? msToFrame(endMs) : fileFrames;
+        if (fileFrames > 0)
+            endFrame = std::min(endFrame, fileFrames);
+        const bool looping = slot->loop.load(std::memory_order_relaxed);
 
-        if (usingMiniaudio) {
-            ma_result rr = ma_decoder_read_pcm_frames(&dec, buf, kFrames, &framesRead);
-            if (rr != MA_SUCCESS && rr != MA_AT_END)
-                readError = true;
-        } else {
-            framesRead = ffmpegDec.readPcmFrames(buf, kFrames);
-        }
-
-        if (readError)
+        if (looping && endFrame > 0 && endFrame <= startFrame) {
+            naturalEnd = true; // empty loop region
             break;
+        }
 
-        if (framesRead == 0) {
-            if (slot->loop.load(std::memory_order_relaxed)) {
-                while (slot->queuedMainFrames.load(std::memory_order_relaxed) > 0) {
-                    if (slot->state.load(std::memory_order_acquire) == ClipState::Stopping)
-                        break;
-                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
-                }
-                if (slot->state.load(std::memory_order_acquire) == ClipState::Stopping)
-                    break;
-
-                double sMs = slot->trimStartMs.load(std::memory_order_relaxed);
-                ma_uint64 sFrame = (ma_uint64)((sMs / 1000.0) * decoderSampleRate);
-                if (usingMiniaudio) {
-                    ma_decoder_seek_to_pcm_frame(&dec, sFrame);
-                } else {
-                    ffmpegDec.seekToPcmFrame(sFrame);
-                }
+        uint64_t fadeFrames = 0;
+        uint64_t headFrames = msToFrame(kLoopHeadMs);
+        if (looping && endFrame > startFrame) {
+            const double fadeMs = slot->loopCrossfadeMs.load(std::memory_order_relaxed);
+            fadeFrames = std::min(msToFrame(std::max(0.0, fadeMs)), (endFrame - startFrame) / 2);
+            headFrames = std::min(std::max(headFrames, fadeFrames), endFrame - startFrame);
+        }
+        // Reading stops where the crossfade into the next iteration starts, or exactly at trimEnd
+        const uint64_t limit = endFrame > 0 ? endFrame - fadeFrames : UINT64_MAX;
 
-                slot->playbackFrameCount.store(0, std::memory_order_relaxed);
+        if (startFrame != loopHeadStart) {
+            loopHeadStart = startFrame;
+            loopHead.clear();
+        }
 
-                {
-                    std::lock_guard<std::mutex> lock(engine->callbackMutex);
-                    if (engine->clipLoopedCallback)
-                        engine->clipLoopedCallback(slotId);
-                }
-                continue;
-            }
-            naturalEnd = true;
-            break;
+        uint64_t framesRead = 0;
+        if (decodePos < limit) {
+            const uint64_t want = std::min<uint64_t>(kFrames, limit - decodePos);
+            ma_result rr = dec.readPcmFrames(buf, want, &framesRead);
+            if (rr != MA_SUCCESS && rr != MA_AT_END)
+                break;
         }
 
-        double endMs = slot->trimEndMs.load(std::memory_order_relaxed);
-        if (endMs > 0.0) {
-            ma_uint64 curFrame = 0;
-            if (usingMiniaudio) {
-                ma_decoder_get_cursor_in_pcm_frames(&dec, &curFrame);
-            } else {
-                curFrame = ffmpegDec.getCursorInPcmFrames();
+        if (framesRead == 0) {
+            if (!looping) {
+                naturalEnd = true;
+                break;
             }
-            ma_uint64 endFrame = (ma_uint64)((endMs / 1000.0) * decoderSampleRate);
-            if (curFrame >= endFrame) {
-                if (slot->loop.load(std::memory_order_relaxed)) {
-                    while (slot->queuedMainFrames.load(std::memory_order_relaxed) > 0) {
-                        if (slot->state.load(std::memory_order_acquire) == ClipState::Stopping)
-                            break;
-                        std::this_thread::sleep_for(std::chrono::milliseconds(2));
-                    }
-                    if (slot->state.load(std::memory_order_acquire) == ClipState::Stopping)
-                        break;
-
-                    double sMs = slot->trimStartMs.load(std::memory_order_relaxed);
-                    ma_uint64 sFrame = (ma_uint64)((sMs / 1000.0) * decoderSampleRate);
-                    if (usingMiniaudio) {
-                        ma_decoder_seek_to_pcm_frame(&dec, sFrame);
-                    } else {
-                        ffmpegDec.seekToPcmFrame(sFrame);
-                    }
 
-                    slot->playbackFrameCount.store(0, std::memory_order_relaxed);
+            const uint64_t wrapPos = decodePos;
 
-                    {
-                        std::lock_guard<std::mutex> lock(engine->callbackMutex);
-                        if (engine->clipLoopedCallback)
-                            engine->clipLoopedCallback(slotId);
-                    }
-                    continue;
-                } else {
-                    naturalEnd = true;
-                    break;
-                }
+            // Tail of this iteration that overlaps the head of the next one
+            uint64_t tailFrames = 0;
+            if (fadeFrames > 0 && endFrame > decodePos) {
+                loopTail.resize(std::min(fadeFrames, endFrame - decodePos) * 2);
+                tailFrames = readFully(loopTail.data(), loopTail.size() / 2);
             }
-        }
-
-        ma_uint32 remaining = (ma_uint32)framesRead;
-        float* cursor = buf;
 
-        while (remaining > 0) {
-            auto st = slot->state.load(std::memory_order_acquire);
-            if (st == ClipState::Stopping)
+            // Normally captured during the first pass; only decoded here after a seek or a trim change
+            uint64_t haveHead = loopHead.size() / 2;
+            if (haveHead < headFrames) {
+                dec.seekToPcmFrame(startFrame + haveHead);
+                loopHead.resize(headFrames * 2);
+                haveHead += readFully(loopHead.data() + haveHead * 2, headFrames - haveHead);
+                loopHead.resize(haveHead * 2);
+            }
+            if (haveHead == 0) {
+                naturalEnd = true; // trimStart is past the end of the file
                 break;
-            if (st == ClipState::Paused) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                continue;
             }
 
-            void* wMain = nullptr;
-            ma_uint32 toWrite = remaining;
+            const uint64_t blockFrames = std::min(haveHead, headFrames);
+            tailFrames = std::min(tailFrames, blockFrames);
+            loopBlock.assign(loopHead.begin(), loopHead.begin() + (ptrdiff_t)(blockFrames * 2));
+
+            // Equal-power crossfade: constant perceived loudness for uncorrelated material
+            for (uint64_t i = 0; i < tailFrames; ++i) {
+                const float t = ((float)i + 0.5f) / (float)tailFrames;
+                const float gIn = std::sin(t * 1.57079632679f);
+                const float gOut = std::cos(t * 1.57079632679f);
+                loopBlock[i * 2] = loopTail[i * 2] * gOut + loopBlock[i * 2] * gIn;
+                loopBlock[i * 2 + 1] = loopTail[i * 2 + 1] * gOut + loopBlock[i * 2 + 1] * gIn;
+            }
 
-            if (ma_pcm_rb_acquire_write(&slot->ringBufferMain, &toWrite, &wMain) == MA_SUCCESS && toWrite > 0 &&
-                wMain) {
-                std::memcpy(wMain, cursor, toWrite * 2 * sizeof(float));
-                ma_pcm_rb_commit_write(&slot->ringBufferMain, toWrite);
-                slot->queuedMainFrames.fetch_add((long long)toWrite, std::memory_order_relaxed);
+            // Position jumps back to trimStart where the next iteration starts to be heard
+            loopBoundaries.emplace_back(framesWritten, wrapPos > startFrame ? wrapPos - startFrame : 0);
 
-                // best-effort monitor buffer
-                void* wMon = nullptr;
-                ma_uint32 toWriteMon = toWrite;
-                if (ma_pcm_rb_acquire_write(&slot->ringBufferMon, &toWriteMon, &wMon) == MA_SUCCESS && toWriteMon > 0 &&
-                    wMon) {
-                    const ma_uint32 n = std::min(toWriteMon, toWrite);
-                    std::memcpy(wMon, cursor, n * 2 * sizeof(float));
-                    ma_pcm_rb_commit_write(&slot->ringBufferMon, n);
-                }
+            // Decoding resumes right after the head; the seek is hidden behind the block already in hand
+            dec.seekToPcmFrame(startFrame + blockFrames);
+            decodePos = dec.getCursorInPcmFrames();
 
-                cursor += toWrite * 2;
-                remaining -= toWrite;
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            wrapped = true;
+            if (!writeFrames(loopBlock.data(), blockFrames))
+                break;
+            continue;
+        }
+
+        // Capture the loop head while passing through it (also when loop is only switched on later)
+        const uint64_t haveHead = loopHead.size() / 2;
+        if (decodePos == startFrame + haveHead && haveHead < headFrames) {
+            const uint64_t n = std::min(framesRead, headFrames - haveHead);
+            loopHead.insert(loopHead.end(), buf, buf + n * 2);
+        }
+
+        // Short fades where a trim point cuts into the waveform (a loop point gets the crossfade instead)
+        uint64_t edgeFade = msToFrame(engine->clipFadeMs.load(std::memory_order_relaxed));
+        if (endFrame > startFrame)
+            edgeFade = std::min(edgeFade, (endFrame - startFrame) / 2);
+        const bool fadeIn = edgeFade > 0 && startFrame > 0 && !wrapped && decodePos < startFrame + edgeFade &&
+                            decodePos + framesRead > startFrame;
+        const bool fadeOut = edgeFade > 0 && endMs > 0.0 && !looping && decodePos + framesRead + edgeFade > endFrame;
+        if (fadeIn || fadeOut) {
+            for (uint64_t i = 0; i < framesRead; ++i) {
+                const uint64_t p = decodePos + i;
+                float g = 1.0f;
+                if (fadeIn && p >= startFrame && p < startFrame + edgeFade)
+                    g = (float)(p - startFrame + 1) / (float)edgeFade;
+                if (fadeOut && p + edgeFade > endFrame)
+                    g = std::min(g, (float)(endFrame - p) / (float)edgeFade);
+                buf[i * 2] *= g;
+                buf[i * 2 + 1] *= g;
             }
         }
-    }
+        decodePos += framesRead;
 
-    // Clean up decoder
-    if (usingMiniaudio) {
-        ma_decoder_uninit(&dec);
-    } else {
-        ffmpegDec.close();
+        if (!writeFrames(buf, framesRead))
+            break;
     }
 
+    dec.close();
+
+    // Ended by stopClipAt: reported like a natural end, but the rest of the ring is never played
+    if (scheduledStopDone())
+        naturalEnd = true;
+
     if (naturalEnd) {
         slot->state.store(ClipState::Draining, std::memory_order_release);
 
-        while (slot->queuedMainFrames.load(std::memory_order_relaxed) > 0) {
+        while (slot->queuedMainFrames.load(std::memory_order_relaxed) > 0 && !scheduledStopDone()) {
             if (slot->state.load(std::memory_order_acquire) == ClipState::Stopping)
                 break;
+            reportLoops(); // loop switched off while earlier iterations were still queued
             std::this_thread::sleep_for(std::chrono::milliseconds(2));
         }
 
@@ -1759,23 +2560,13 @@ std::pair<double, double> AudioEngine::loadClip(int slotId, const std::string& f
         return {0.0, 0.0};
 
     ClipSlot& slot = clips[slotId];
+    std::lock_guard<std::mutex> lifecycle(slot.lifecycleMutex);
     if (slot.state.load(std::memory_order_relaxed) != ClipState::Stopped)
         return {0.0, 0.0};
 
-    const size_t bytes = (size_t)getRingBufferSize() * 2 * sizeof(float);
-
-    if (!slot.ringBufferMainData) {
-        slot.ringBufferMainData = std::malloc(bytes);
-        if (!slot.ringBufferMainData)
-            return {0.0, 0.0};
-        ma_pcm_rb_init(ma_format_f32, 2, getRingBufferSize(), slot.ringBufferMainData, nullptr, &slot.ringBufferMain);
-    }
-    if (!slot.ringBufferMonData) {
-        slot.ringBufferMonData = std::malloc(bytes);
-        if (!slot.ringBufferMonData)
-            return {0.0, 0.0};
-        ma_pcm_rb_init(ma_format_f32, 2, getRingBufferSize(), slot.ringBufferMonData, nullptr, &slot.ringBufferMon);
-    }
+    // Rings are preallocated; only missing if the slab allocation failed
+    if (m_voiceRings.empty())
+        return {0.0, 0.0};
 
     ma_pcm_rb_reset(&slot.ringBufferMain);
     ma_pcm_rb_reset(&slot.ringBufferMon);
@@ -1783,52 +2574,25 @@ std::pair<double, double> AudioEngine::loadClip(int slotId, const std::string& f
     slot.filePath = filepath;
     slot.gain.store(1.0f, std::memory_order_relaxed);
     slot.loop.store(false, std::memory_order_relaxed);
+    slot.loopCrossfadeMs.store(0.0, std::memory_order_relaxed);
     slot.queuedMainFrames.store(0, std::memory_order_relaxed);
     slot.seekPosMs.store(-1.0, std::memory_order_relaxed);
     slot.playbackFrameCount.store(0, std::memory_order_relaxed);
 
-    // duration - try miniaudio first, then FFmpeg as fallback
-    double endSec = -1.0;
-    ma_decoder_config cfg = ma_decoder_config_init(ma_format_f32, 2, m_sampleRate);
-    ma_decoder dec;
-    bool gotDuration = false;
-
-#ifdef _WIN32
-    std::wstring wpath = utf8ToWide(filepath);
-    ma_result initResult = ma_decoder_init_file_w(wpath.c_str(), &cfg, &dec);
-#else
-    ma_result initResult = ma_decoder_init_file(filepath.c_str(), &cfg, &dec);
-#endif
-    if (initResult == MA_SUCCESS) {
-        ma_uint64 totalFrames = 0;
-        if (ma_decoder_get_length_in_pcm_frames(&dec, &totalFrames) == MA_SUCCESS && dec.outputSampleRate > 0 &&
-            totalFrames > 0) {
-            endSec = (double)totalFrames / (double)dec.outputSampleRate;
-            slot.totalDurationMs.store(endSec * 1000.0, std::memory_order_relaxed);
-            gotDuration = true;
-        }
-        ma_decoder_uninit(&dec);
-    }
-
-    // If miniaudio failed, try FFmpeg (for Opus, etc.)
-    if (!gotDuration) {
-        FFmpegDecoder ffmpegDec;
-        if (ffmpegDec.open(filepath, m_sampleRate, 2)) {
-            uint64_t totalFrames = ffmpegDec.getLengthInPcmFrames();
-            if (totalFrames > 0) {
-                endSec = (double)totalFrames / (double)ffmpegDec.getSampleRate();
-                slot.totalDurationMs.store(endSec * 1000.0, std::memory_order_relaxed);
-                gotDuration = true;
-                std::cout << "[AudioEngine] loadClip: Got duration from FFmpeg: " << endSec << "s\n";
-            }
-            ffmpegDec.close();
-        }
-    }
-
-    if (!gotDuration) {
+    // Media info is cached per file, so in the common case this is a lookup rather than a decoder open
+    const MediaInfo info = m_mediaInfoCache.probe(filepath);
+    if (!info.isValid()) {
         return {0.0, 0.0};
     }
 
+    slot.backend = info.backend;
+    slot.nativeSampleRate = info.nativeSampleRate;
+    if (info.nativeSampleRate != m_sampleRate)
+        m_resampledClips.acquire(filepath, m_sampleRate); // start converting before the first trigger
+    slot.seekIndex = m_mediaInfoCache.seekIndex(filepath); // nullptr while still being built
+    const double endSec = info.durationSec();
+    slot.totalDurationMs.store(endSec * 1000.0, std::memory_order_relaxed);
+
     return {0.0, endSec};
 }
 
@@ -1837,33 +2601,279 @@ void AudioEngine::unloadClip(int slotId)
     if (slotId < 0 || slotId >= MAX_CLIPS)
         return;
 
-    stopClip(slotId);
-    clips[slotId].filePath.clear();
+    ClipSlot& slot = clips[slotId];
+    std::lock_guard<std::mutex> lifecycle(slot.lifecycleMutex);
+    stopVoice(slot, clipFadeMs.load(std::memory_order_relaxed));
+    slot.filePath.clear();
+    slot.seekIndex.reset();
+    slot.nativeSampleRate = 0;
+
+    // The rings stay with the slot (see resizeVoiceRings); just drop what the last clip left in them
+    ma_pcm_rb_reset(&slot.ringBufferMain);
+    ma_pcm_rb_reset(&slot.ringBufferMon);
+
+    slot.queuedMainFrames.store(0, std::memory_order_relaxed);
+}
 
-    if (clips[slotId].ringBufferMainData) {
-        ma_pcm_rb_uninit(&clips[slotId].ringBufferMain);
-        std::free(clips[slotId].ringBufferMainData);
-        clips[slotId].ringBufferMainData = nullptr;
+// ------------------------------------------------------------
+// Trigger latency
+// ------------------------------------------------------------
+const char* AudioEngine::latencyStageName(LatencyStage stage)
+{
+    switch (stage) {
+    case LatencyStage::HotkeyToAction:
+        return "hotkeyToAction";
+    case LatencyStage::ActionToEnqueue:
+        return "actionToEnqueue";
+    case LatencyStage::EnqueueToDecoded:
+        return "enqueueToDecoded";
+    case LatencyStage::DecodedToMixed:
+        return "decodedToMixed";
+    case LatencyStage::HotkeyToMixed:
+        return "hotkeyToMixed";
+    case LatencyStage::HotkeyToOutput:
+        return "hotkeyToOutput";
+    case LatencyStage::Count:
+        break;
     }
-    if (clips[slotId].ringBufferMonData) {
-        ma_pcm_rb_uninit(&clips[slotId].ringBufferMon);
-        std::free(clips[slotId].ringBufferMonData);
-        clips[slotId].ringBufferMonData = nullptr;
+    return "unknown";
+}
+
+void AudioEngine::armLatencyTrace(int slotId, int64_t pressNs, int64_t actionNs)
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return;
+    ClipSlot& slot = clips[slotId];
+    slot.pendingPressNs.store(pressNs, std::memory_order_relaxed);
+    slot.pendingActionNs.store(actionNs, std::memory_order_relaxed);
+    slot.pendingEnqueueNs.store(0, std::memory_order_relaxed);
+    slot.tracePending.store(true, std::memory_order_release);
+}
+
+void AudioEngine::armPendingTrace(ClipSlot& slot, uint64_t token)
+{
+    slot.traceArmed.store(false, std::memory_order_release);
+    if (!slot.tracePending.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    // Direct starts (not via postCommand) are enqueued right here
+    const int64_t enqueueNs = slot.pendingEnqueueNs.load(std::memory_order_relaxed);
+    slot.tracePressNs.store(slot.pendingPressNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    slot.traceActionNs.store(slot.pendingActionNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    slot.traceEnqueueNs.store(enqueueNs > 0 ? enqueueNs : latencyClockNs(), std::memory_order_relaxed);
+    slot.traceDecodedNs.store(0, std::memory_order_relaxed);
+    slot.traceToken.store(token, std::memory_order_relaxed);
+    slot.traceArmed.store(true, std::memory_order_release);
+}
+
+void AudioEngine::stampLatency(std::atomic<int64_t>& stamp, const ClipSlot& slot)
+{
+    // First stamp wins (a loop re-decodes)
+    if (slot.traceArmed.load(std::memory_order_acquire) && stamp.load(std::memory_order_relaxed) == 0)
+        stamp.store(latencyClockNs(), std::memory_order_release);
+}
+
+void AudioEngine::finishLatencyTrace(ClipSlot& slot, ma_uint32 startOffset)
+{
+    slot.traceArmed.store(false, std::memory_order_relaxed);
+
+    // The block's first sample leaves now; this clip starts startOffset frames into it
+    const int64_t mixedNs = latencyClockNs() + (int64_t)((double)startOffset * 1e9 / m_sampleRate);
+    const int64_t pressNs = slot.tracePressNs.load(std::memory_order_relaxed);
+    const int64_t actionNs = slot.traceActionNs.load(std::memory_order_relaxed);
+    const int64_t enqueueNs = slot.traceEnqueueNs.load(std::memory_order_acquire);
+    const int64_t decodedNs = slot.traceDecodedNs.load(std::memory_order_acquire);
+    auto ms = [](int64_t from, int64_t to) { return (double)(to - from) / 1e6; };
+
+    if (actionNs >= 0) {
+        m_latency[(int)LatencyStage::HotkeyToAction].record(ms(pressNs, actionNs));
+        if (enqueueNs > 0)
+            m_latency[(int)LatencyStage::ActionToEnqueue].record(ms(actionNs, enqueueNs));
+    } else if (enqueueNs > 0) {
+        // Fast path: press goes straight to the queue
+        m_latency[(int)LatencyStage::ActionToEnqueue].record(ms(pressNs, enqueueNs));
+    }
+    if (enqueueNs > 0 && decodedNs > 0)
+        m_latency[(int)LatencyStage::EnqueueToDecoded].record(ms(enqueueNs, decodedNs));
+    if (decodedNs > 0)
+        m_latency[(int)LatencyStage::DecodedToMixed].record(ms(decodedNs, mixedNs));
+    m_latency[(int)LatencyStage::HotkeyToMixed].record(ms(pressNs, mixedNs));
+    m_latency[(int)LatencyStage::HotkeyToOutput].record(ms(pressNs, mixedNs) + getOutputLatencyMs());
+}
+
+LatencyHistogram::Summary AudioEngine::getLatencySummary(LatencyStage stage) const
+{
+    if (stage == LatencyStage::Count)
+        return {};
+    return m_latency[(int)stage].summary();
+}
+
+void AudioEngine::resetLatencyStats()
+{
+    for (auto& h : m_latency)
+        h.reset();
+}
+
+const char* AudioEngine::engineCallbackName(EngineCallback cb)
+{
+    switch (cb) {
+    case EngineCallback::Playback:
+        return "playback";
+    case EngineCallback::Capture:
+        return "capture";
+    case EngineCallback::Monitor:
+        return "monitor";
+    case EngineCallback::RecordingInput:
+        return "recordingInput";
+    case EngineCallback::Count:
+        break;
     }
+    return "unknown";
+}
 
-    clips[slotId].queuedMainFrames.store(0, std::memory_order_relaxed);
+CallbackProfiler::Snapshot AudioEngine::getCallbackProfile(EngineCallback cb) const
+{
+    if (cb == EngineCallback::Count)
+        return {};
+    return m_callbackProfiles[(int)cb].snapshot();
+}
+
+AudioEngine::XrunCounters AudioEngine::getXrunCounters() const
+{
+    XrunCounters c;
+    c.captureOverruns = m_captureOverruns.load(std::memory_order_relaxed);
+    c.recordingOverruns = m_recordingOverruns.load(std::memory_order_relaxed);
+    c.recordingInputOverruns = m_recordingInputOverruns.load(std::memory_order_relaxed);
+    c.clipUnderruns = m_clipUnderruns.load(std::memory_order_relaxed);
+    return c;
+}
+
+void AudioEngine::resetEngineHealth()
+{
+    for (auto& p : m_callbackProfiles)
+        p.reset();
+    m_captureOverruns.store(0, std::memory_order_relaxed);
+    m_recordingOverruns.store(0, std::memory_order_relaxed);
+    m_recordingInputOverruns.store(0, std::memory_order_relaxed);
+    m_clipUnderruns.store(0, std::memory_order_relaxed);
+}
+
+double AudioEngine::getOutputLatencyMs() const
+{
+    if (!playbackDevice || playbackDevice->playback.internalSampleRate == 0)
+        return 0.0;
+    const double frames =
+        (double)playbackDevice->playback.internalPeriodSizeInFrames * playbackDevice->playback.internalPeriods;
+    return frames * 1000.0 / (double)playbackDevice->playback.internalSampleRate;
+}
+
+// ------------------------------------------------------------
+// Command queue
+// ------------------------------------------------------------
+bool AudioEngine::postCommand(const Command& cmd)
+{
+    if (cmd.slotId < 0 || cmd.slotId >= MAX_CLIPS)
+        return false;
+    ClipSlot& slot = clips[cmd.slotId];
+    if (cmd.type == Command::Type::PlayClip && slot.tracePending.load(std::memory_order_acquire) &&
+        slot.pendingEnqueueNs.load(std::memory_order_relaxed) == 0)
+        slot.pendingEnqueueNs.store(latencyClockNs(), std::memory_order_relaxed);
+    {
+        // Held only for the push; the consumer side stays lock-free
+        std::lock_guard<std::mutex> lock(m_commandPushMutex);
+        if (!m_commandQueue.push(cmd)) {
+            if (cmd.type == Command::Type::PlayClip)
+                slot.tracePending.store(false, std::memory_order_relaxed); // the caller's fallback re-arms
+            return false;
+        }
+        m_commandsPosted.fetch_add(1, std::memory_order_release);
+    }
+    m_commandsPosted.notify_one();
+    return true;
+}
+
+void AudioEngine::flushCommands()
+{
+    // Waits for everything posted before the call; other producers' later commands are not waited for
+    const uint64_t posted = m_commandsPosted.load(std::memory_order_acquire);
+    uint64_t done = m_commandsDone.load(std::memory_order_acquire);
+    while (done < posted && !m_commandThreadQuit.load(std::memory_order_acquire)) {
+        m_commandsDone.wait(done, std::memory_order_acquire);
+        done = m_commandsDone.load(std::memory_order_acquire);
+    }
+}
+
+bool AudioEngine::isClipLoaded(int slotId, const std::string& filepath) const
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return false;
+    std::lock_guard<std::mutex> lifecycle(clips[slotId].lifecycleMutex);
+    return !filepath.empty() && clips[slotId].filePath == filepath;
+}
+
+void AudioEngine::commandThreadFunc()
+{
+    uint64_t seen = 0;
+    while (!m_commandThreadQuit.load(std::memory_order_acquire)) {
+        m_commandsPosted.wait(seen, std::memory_order_acquire);
+        seen = m_commandsPosted.load(std::memory_order_acquire);
+
+        Command cmd;
+        while (!m_commandThreadQuit.load(std::memory_order_acquire) && m_commandQueue.pop(cmd)) {
+            runCommand(cmd);
+            m_commandsDone.fetch_add(1, std::memory_order_release);
+            m_commandsDone.notify_all();
+        }
+    }
+    // Unblock a flushCommands() racing with shutdown
+    m_commandsDone.notify_all();
+}
+
+void AudioEngine::runCommand(const Command& cmd)
+{
+    switch (cmd.type) {
+    case Command::Type::PlayClip: {
+        // One hold across stop + start, so no other thread can start or reload the slot in between
+        ClipSlot& slot = clips[cmd.slotId];
+        std::lock_guard<std::mutex> lifecycle(slot.lifecycleMutex);
+        if (slot.state.load(std::memory_order_acquire) != ClipState::Stopped)
+            stopVoice(slot, clipFadeMs.load(std::memory_order_relaxed)); // fade out, join the old decoder
+        startVoice(slot, cmd.slotId, kNoScheduledFrame);
+        break;
+    }
+    case Command::Type::StopClip:
+        stopClip(cmd.slotId);
+        break;
+    case Command::Type::PlayClipAt:
+        playClipAt(cmd.slotId, cmd.frame);
+        break;
+    case Command::Type::StopClipAt:
+        stopClipAt(cmd.slotId, cmd.frame);
+        break;
+    }
 }
 
 void AudioEngine::playClip(int slotId)
+{
+    playClipAt(slotId, kNoScheduledFrame);
+}
+
+void AudioEngine::playClipAt(int slotId, uint64_t startFrame)
 {
     if (slotId < 0 || slotId >= MAX_CLIPS)
         return;
     ClipSlot& slot = clips[slotId];
+    std::lock_guard<std::mutex> lifecycle(slot.lifecycleMutex);
+    startVoice(slot, slotId, startFrame);
+}
+
+void AudioEngine::startVoice(ClipSlot& slot, int slotId, uint64_t startFrame)
+{
     if (slot.filePath.empty())
         return;
 
     if (slot.state.load(std::memory_order_acquire) == ClipState::Paused) {
-        slot.state.store(ClipState::Playing, std::memory_order_release);
+        resumeFromPause(slot);
         return;
     }
 
@@ -1879,12 +2889,33 @@ void AudioEngine::playClip(int slotId)
     ma_pcm_rb_reset(&slot.ringBufferMain);
     ma_pcm_rb_reset(&slot.ringBufferMon);
     slot.queuedMainFrames.store(0, std::memory_order_relaxed);
+    slot.stopFadeFrames.store(0, std::memory_order_release);
+    slot.stopFadeMs.store(-1.0, std::memory_order_relaxed);
+    slot.scheduledStopHit.store(false, std::memory_order_relaxed);
+    slot.stopAtFrame.store(kNoScheduledFrame, std::memory_order_relaxed);
+    // Level automation is per play; the outputs snap their ramps when they see the new play token
+    slot.level.store(1.0f, std::memory_order_relaxed);
+    slot.pauseFade.store(false, std::memory_order_relaxed);
+    slot.pauseFadeMainLeft.store(0, std::memory_order_relaxed);
+    slot.pauseFadeMonLeft.store(0, std::memory_order_relaxed);
+    // The decoder starts filling the ring right away; the mixer holds the clip back until startFrame.
+    // Without a running main output there is no clock, so start immediately.
+    slot.startAtFrame.store(isDeviceRunning() ? startFrame : kNoScheduledFrame, std::memory_order_release);
 
     if (slot.seekPosMs.load(std::memory_order_relaxed) < 0.0) {
         slot.playbackFrameCount.store(0, std::memory_order_relaxed);
     }
 
-    const uint64_t token = slot.playToken.fetch_add(1, std::memory_order_acq_rel) + 1;
+    slot.mainPrimed.store(false, std::memory_order_relaxed);
+
+    slot.liveRms.store(0.0f, std::memory_order_relaxed);
+    slot.startSerial.store(m_voiceSerial.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Rings are empty and the old decoder is gone, so the trace can only see this start's audio.
+    // Only starts change playToken, all under the lifecycle lock, so the next token is known here.
+    const uint64_t token = slot.playToken.load(std::memory_order_relaxed) + 1;
+    armPendingTrace(slot, token);
+    slot.playToken.store(token, std::memory_order_release);
     slot.state.store(ClipState::Playing, std::memory_order_release);
 
     slot.decoderThread = std::thread(&AudioEngine::decoderThreadFunc, this, &slot, slotId, token);
@@ -1894,9 +2925,16 @@ void AudioEngine::pauseClip(int slotId)
 {
     if (slotId < 0 || slotId >= MAX_CLIPS)
         return;
-    auto st = clips[slotId].state.load(std::memory_order_acquire);
-    if (st == ClipState::Playing || st == ClipState::Draining) {
-        clips[slotId].state.store(ClipState::Paused, std::memory_order_release);
+    ClipSlot& slot = clips[slotId];
+    std::lock_guard<std::mutex> lifecycle(slot.lifecycleMutex);
+    auto st = slot.state.load(std::memory_order_acquire);
+    if (st != ClipState::Playing && st != ClipState::Draining)
+        return;
+
+    fadeToPause(slot);
+    // The decoder may have moved Playing -> Draining during the fade; an ended clip stays ended
+    while ((st == ClipState::Playing || st == ClipState::Draining) &&
+           !slot.state.compare_exchange_weak(st, ClipState::Paused, std::memory_order_acq_rel)) {
     }
 }
 
@@ -1904,25 +2942,351 @@ void AudioEngine::resumeClip(int slotId)
 {
     if (slotId < 0 || slotId >= MAX_CLIPS)
         return;
-    if (clips[slotId].state.load(std::memory_order_acquire) == ClipState::Paused) {
-        clips[slotId].state.store(ClipState::Playing, std::memory_order_release);
+    ClipSlot& slot = clips[slotId];
+    std::lock_guard<std::mutex> lifecycle(slot.lifecycleMutex);
+    if (slot.state.load(std::memory_order_acquire) == ClipState::Paused) {
+        resumeFromPause(slot);
     }
 }
 
 void AudioEngine::stopClip(int slotId)
+{
+    stopClipWithFade(slotId, clipFadeMs.load(std::memory_order_relaxed));
+}
+
+void AudioEngine::stopClipWithFade(int slotId, double fadeMs)
 {
     if (slotId < 0 || slotId >= MAX_CLIPS)
         return;
 
     ClipSlot& slot = clips[slotId];
+    std::lock_guard<std::mutex> lifecycle(slot.lifecycleMutex);
+    stopVoice(slot, fadeMs);
+}
+
+void AudioEngine::stopVoice(ClipSlot& slot, double fadeMs)
+{
+    fadeOutClip(slot, fadeMs);
     slot.state.store(ClipState::Stopping, std::memory_order_release);
 
     if (slot.decoderThread.joinable()) {
         slot.decoderThread.join();
     }
+    slot.stopFadeFrames.store(0, std::memory_order_release);
+    slot.stopFadeMs.store(-1.0, std::memory_order_relaxed);
+    slot.scheduledStopHit.store(false, std::memory_order_relaxed);
+    slot.startAtFrame.store(kNoScheduledFrame, std::memory_order_relaxed);
+    slot.stopAtFrame.store(kNoScheduledFrame, std::memory_order_relaxed);
     slot.state.store(ClipState::Stopped, std::memory_order_release);
 }
 
+void AudioEngine::stopClipAt(int slotId, uint64_t stopFrame, double fadeMs)
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return;
+    if (!isDeviceRunning()) {
+        stopClipWithFade(slotId, fadeMs >= 0.0 ? fadeMs : clipFadeMs.load(std::memory_order_relaxed));
+        return;
+    }
+    clips[slotId].stopFadeMs.store(fadeMs, std::memory_order_relaxed);
+    clips[slotId].stopAtFrame.store(stopFrame, std::memory_order_release);
+}
+
+void AudioEngine::fadeOutAndStop(int slotId, double fadeMs)
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return;
+    // The mixer skips a paused clip, so a scheduled stop would never fire; it is silent anyway
+    if (clips[slotId].state.load(std::memory_order_acquire) == ClipState::Paused) {
+        stopClip(slotId);
+        return;
+    }
+    stopClipAt(slotId, getEngineFrameTime(), std::max(0.0, fadeMs));
+}
+
+uint64_t AudioEngine::getEngineFrameTime() const
+{
+    return frameClock.load(std::memory_order_acquire);
+}
+
+uint64_t AudioEngine::quantizeFrame(uint64_t frame, uint64_t gridFrames)
+{
+    if (gridFrames == 0)
+        return frame;
+    return ((frame + gridFrames - 1) / gridFrames) * gridFrames;
+}
+
+uint64_t AudioEngine::nextScheduleFrame(double leadMs, double gridMs) const
+{
+    const uint64_t earliest = getEngineFrameTime() + (uint64_t)((std::max(0.0, leadMs) / 1000.0) * m_sampleRate);
+    if (gridMs <= 0.0)
+        return earliest;
+    const uint64_t gridFrames = std::max<uint64_t>(1, (uint64_t)std::llround((gridMs / 1000.0) * m_sampleRate));
+    return quantizeFrame(earliest, gridFrames);
+}
+
+void AudioEngine::fadeOutClip(ClipSlot& slot, double fadeMs)
+{
+    const auto st = slot.state.load(std::memory_order_acquire);
+    if (st != ClipState::Playing && st != ClipState::Draining)
+        return;
+    // Not audible yet (scheduled start pending): nothing to fade
+    if (slot.startAtFrame.load(std::memory_order_acquire) != kNoScheduledFrame)
+        return;
+
+    const uint32_t fadeFrames = fadeFramesFor(fadeMs);
+    const bool mainRunning = isDeviceRunning();
+    const bool monitorRunning = isMonitorRunning();
+    if (!mainRunning && !monitorRunning)
+        return;
+
+    // A stop scheduled to begin within this fade (a voice steal, a macro stop) keeps its own fade length:
+    // wait for the mixer to start it rather than cutting across it with this one
+    uint32_t waitFrames = slot.stopFadeFrames.load(std::memory_order_acquire);
+    const uint64_t stopAt = slot.stopAtFrame.load(std::memory_order_acquire);
+    if (waitFrames == 0 && mainRunning && stopAt <= getEngineFrameTime() + std::max<uint32_t>(fadeFrames, 1)) {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds((int)fadeMs + 100);
+        while ((waitFrames = slot.stopFadeFrames.load(std::memory_order_acquire)) == 0 &&
+               std::chrono::steady_clock::now() < until) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (waitFrames == 0 && fadeFrames == 0)
+        return;
+
+    // Each output callback ramps its own copy of the clip down and counts its side to zero.
+    // A fade already started by stopClipAt (possibly a longer one) is just waited for.
+    if (waitFrames == 0) {
+        slot.stopFadeMainLeft.store(mainRunning ? fadeFrames : 0, std::memory_order_relaxed);
+        slot.stopFadeMonLeft.store(monitorRunning ? fadeFrames : 0, std::memory_order_relaxed);
+        slot.stopFadeFrames.store(fadeFrames, std::memory_order_release);
+        waitFrames = fadeFrames;
+    }
+
+    // Bounded, in case a device stalls mid-fade
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds((int)(waitFrames * 1000.0 / m_sampleRate) + 100);
+    while ((slot.stopFadeMainLeft.load(std::memory_order_acquire) > 0 ||
+            slot.stopFadeMonLeft.load(std::memory_order_acquire) > 0) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// ------------------------------------------------------------
+// Gain automation
+// ------------------------------------------------------------
+uint32_t AudioEngine::fadeFramesFor(double ms) const
+{
+    return (uint32_t)((std::max(0.0, ms) / 1000.0) * m_sampleRate);
+}
+
+void AudioEngine::fadeToPause(ClipSlot& slot)
+{
+    const double fadeMs = clipFadeMs.load(std::memory_order_relaxed);
+    const uint32_t fadeFrames = fadeFramesFor(fadeMs);
+    const bool mainRunning = isDeviceRunning();
+    const bool monitorRunning = isMonitorRunning();
+    // Not audible yet (scheduled start pending) or no fade: the level just snaps to silence
+    const bool audible = slot.startAtFrame.load(std::memory_order_acquire) == kNoScheduledFrame &&
+                         (mainRunning || monitorRunning);
+
+    slot.levelRampFrames.store(audible ? fadeFrames : 0, std::memory_order_relaxed);
+    slot.pauseFadeMainLeft.store(audible && mainRunning ? fadeFrames : 0, std::memory_order_relaxed);
+    slot.pauseFadeMonLeft.store(audible && monitorRunning ? fadeFrames : 0, std::memory_order_relaxed);
+    slot.pauseFade.store(true, std::memory_order_release);
+    if (!audible || fadeFrames == 0)
+        return;
+
+    // Same bounded wait as fadeOutClip; each output counts its side down once its level ramp heads to 0
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds((int)fadeMs + 100);
+    while ((slot.pauseFadeMainLeft.load(std::memory_order_acquire) > 0 ||
+            slot.pauseFadeMonLeft.load(std::memory_order_acquire) > 0) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void AudioEngine::resumeFromPause(ClipSlot& slot)
+{
+    // The outputs kept their ramps at 0 while paused, so this fades back in
+    slot.levelRampFrames.store(fadeFramesFor(clipFadeMs.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+    slot.pauseFadeMainLeft.store(0, std::memory_order_relaxed);
+    slot.pauseFadeMonLeft.store(0, std::memory_order_relaxed);
+    slot.pauseFade.store(false, std::memory_order_release);
+    slot.state.store(ClipState::Playing, std::memory_order_release);
+}
+
+void AudioEngine::retargetVoiceRamps(ClipSlot& slot, VoiceRamps& ramps)
+{
+    // Targets are published after their ramp lengths
+    const float gain = slot.gain.load(std::memory_order_acquire);
+    const float level = slot.pauseFade.load(std::memory_order_acquire) ? 0.0f
+                                                                        : slot.level.load(std::memory_order_acquire);
+
+    // A new play starts right at its targets (its own start fade is in the decoded audio)
+    const uint64_t token = slot.playToken.load(std::memory_order_acquire);
+    if (ramps.playToken != token) {
+        ramps.playToken = token;
+        ramps.gain.snap(gain);
+        ramps.level.snap(level);
+        return;
+    }
+
+    if (gain != ramps.gain.target)
+        ramps.gain.rampTo(gain, slot.gainRampFrames.load(std::memory_order_relaxed));
+    if (level != ramps.level.target)
+        ramps.level.rampTo(level, slot.levelRampFrames.load(std::memory_order_relaxed));
+}
+
+void AudioEngine::voiceGains(VoiceRamps& ramps, float* gains, ma_uint32 frames)
+{
+    std::fill(gains, gains + frames, 1.0f);
+    ramps.gain.apply(gains, frames);
+    ramps.level.apply(gains, frames);
+}
+
+void AudioEngine::rampClipLevel(int slotId, float levelDB, double rampMs)
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return;
+    ClipSlot& slot = clips[slotId];
+    const float level = levelDB <= kSilentLevelDb ? 0.0f : dBToLinear(std::min(levelDB, 0.0f));
+    slot.levelRampFrames.store(fadeFramesFor(rampMs), std::memory_order_relaxed);
+    slot.level.store(level, std::memory_order_release);
+}
+
+// ------------------------------------------------------------
+// Voice allocation
+// ------------------------------------------------------------
+void AudioEngine::setVoiceStealPolicy(VoiceStealPolicy policy)
+{
+    voiceStealPolicy.store((int)policy, std::memory_order_relaxed);
+}
+
+AudioEngine::VoiceStealPolicy AudioEngine::getVoiceStealPolicy() const
+{
+    return (VoiceStealPolicy)voiceStealPolicy.load(std::memory_order_relaxed);
+}
+
+void AudioEngine::setClipPriority(int slotId, int priority)
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return;
+    clips[slotId].priority.store(priority, std::memory_order_relaxed);
+}
+
+int AudioEngine::acquireVoice(uint32_t candidateMask, int priority)
+{
+    return acquireVoice(candidateMask, priority, getVoiceStealPolicy());
+}
+
+int AudioEngine::acquireVoice(uint32_t candidateMask, int priority, VoiceStealPolicy policy)
+{
+    candidateMask &= (1u << MAX_CLIPS) - 1;
+
+    // A scheduled stop only frees the voice for free if it starts within the steal fade anyway
+    const uint64_t releaseBy = getEngineFrameTime() + fadeFramesFor(kVoiceStealFadeMs);
+
+    int releasing = -1;
+    int victim = -1;
+    uint64_t victimSerial = 0;
+    float victimRms = 0.0f;
+    int victimPriority = 0;
+
+    for (uint32_t m = candidateMask; m != 0; m &= m - 1) {
+        const int i = std::countr_zero(m);
+        const ClipSlot& slot = clips[i];
+        const ClipState st = slot.state.load(std::memory_order_acquire);
+        if (st == ClipState::Stopped)
+            return i;
+        // Already on its way out (being stopped, stop fade running or about to): free soon at no extra cost.
+        // A stop further ahead still leaves the voice audible, so it is weighed like any other below.
+        if (st == ClipState::Stopping || slot.stopFadeFrames.load(std::memory_order_acquire) > 0 ||
+            slot.stopAtFrame.load(std::memory_order_acquire) <= releaseBy) {
+            releasing = i;
+            continue;
+        }
+
+        const uint64_t serial = slot.startSerial.load(std::memory_order_relaxed);
+        const float rms = st == ClipState::Paused ? 0.0f : slot.liveRms.load(std::memory_order_relaxed);
+        const int prio = slot.priority.load(std::memory_order_relaxed);
+
+        // Every policy breaks ties by age
+        bool better = victim < 0;
+        if (!better) {
+            switch (policy) {
+            case VoiceStealPolicy::Quietest:
+                better = rms < victimRms || (rms == victimRms && serial < victimSerial);
+                break;
+            case VoiceStealPolicy::LowestPriority:
+                better = prio < victimPriority || (prio == victimPriority && serial < victimSerial);
+                break;
+            case VoiceStealPolicy::Oldest:
+            default:
+                better = serial < victimSerial;
+                break;
+            }
+        }
+        if (better) {
+            victim = i;
+            victimSerial = serial;
+            victimRms = rms;
+            victimPriority = prio;
+        }
+    }
+
+    if (releasing >= 0)
+        return releasing;
+    if (victim < 0 || (policy == VoiceStealPolicy::LowestPriority && victimPriority > priority))
+        return -1;
+
+    // Scheduled, not waited for: the caller's stopClip() before loading waits out just this short fade
+    fadeOutAndStop(victim, kVoiceStealFadeMs);
+    m_voicesStolen.fetch_add(1, std::memory_order_relaxed);
+    return victim;
+}
+
+float AudioEngine::getVoiceRms(int slotId) const
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return 0.0f;
+    return clips[slotId].liveRms.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioEngine::getVoicesStolen() const
+{
+    return m_voicesStolen.load(std::memory_order_relaxed);
+}
+
+float AudioEngine::getClipLevel(int slotId) const
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return kSilentLevelDb;
+    const float lin = clips[slotId].level.load(std::memory_order_relaxed);
+    return std::max(kSilentLevelDb, 20.0f * std::log10(std::max(lin, 0.000001f)));
+}
+
+void AudioEngine::setResamplerQuality(ResamplerQuality quality)
+{
+    resamplerQuality.store((int)quality, std::memory_order_relaxed);
+}
+
+ResamplerQuality AudioEngine::getResamplerQuality() const
+{
+    return (ResamplerQuality)resamplerQuality.load(std::memory_order_relaxed);
+}
+
+void AudioEngine::setClipFadeMs(double fadeMs)
+{
+    clipFadeMs.store(std::clamp(fadeMs, 0.0, 100.0), std::memory_order_relaxed);
+}
+
+double AudioEngine::getClipFadeMs() const
+{
+    return clipFadeMs.load(std::memory_order_relaxed);
+}
+
 void AudioEngine::setClipLoop(int slotId, bool loop)
 {
     if (slotId < 0 || slotId >= MAX_CLIPS)
@@ -1930,11 +3294,19 @@ void AudioEngine::setClipLoop(int slotId, bool loop)
     clips[slotId].loop.store(loop, std::memory_order_relaxed);
 }
 
+void AudioEngine::setClipLoopCrossfade(int slotId, double crossfadeMs)
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return;
+    clips[slotId].loopCrossfadeMs.store(std::max(0.0, crossfadeMs), std::memory_order_relaxed);
+}
+
 void AudioEngine::setClipGain(int slotId, float gainDB)
 {
     if (slotId < 0 || slotId >= MAX_CLIPS)
         return;
-    clips[slotId].gain.store(dBToLinear(gainDB), std::memory_order_relaxed);
+    clips[slotId].gainRampFrames.store(fadeFramesFor(kGainSmoothingMs), std::memory_order_relaxed);
+    clips[slotId].gain.store(dBToLinear(gainDB), std::memory_order_release);
 }
 
 float AudioEngine::getClipGain(int slotId) const
@@ -2017,6 +3389,206 @@ bool AudioEngine::isClipPaused(int slotId) const
     return clips[slotId].state.load(std::memory_order_relaxed) == ClipState::Paused;
 }
 
+AudioEngine::OfflineRenderResult AudioEngine::renderSession(std::vector<OfflineTrigger> triggers,
+                                                         const std::string& micInputPath,
+                                                         const std::string& outputPath, double durationMs)
+{
+    using Action = OfflineTrigger::Action;
+
+    OfflineRenderResult result;
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    if (outputPath.empty()) {
+        result.error = "No output file";
+        return result;
+    }
+    if (!startOfflineRendering()) {
+        result.error = "Main output is running";
+        return result;
+    }
+
+    ma_encoder encoder;
+    ma_encoder_config ecfg = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, m_channels, m_sampleRate);
+    if (ma_encoder_init_file(outputPath.c_str(), &ecfg, &encoder) != MA_SUCCESS) {
+        stopOfflineRendering();
+        result.error = "Cannot write " + outputPath;
+        return result;
+    }
+
+    // Mic input is decoded straight to the engine's mono capture format
+    ClipDecoder micDecoder;
+    micDecoder.setResamplerQuality(ResamplerQuality::Sinc64); // offline: no deadline to meet
+    bool micActive = false;
+    if (!micInputPath.empty()) {
+        if (!micDecoder.open(micInputPath, m_sampleRate, 1, m_mediaInfoCache.preferredBackend(micInputPath))) {
+            ma_encoder_uninit(&encoder);
+            stopOfflineRendering();
+            result.error = "Cannot decode mic input " + micInputPath;
+            return result;
+        }
+        micActive = true;
+    }
+    const bool haveMic = micActive;
+
+    const uint64_t base = frameClock.load(std::memory_order_acquire);
+    auto msToFrames = [this](double ms) { return (uint64_t)std::llround(std::max(0.0, ms) / 1000.0 * m_sampleRate); };
+
+    std::stable_sort(triggers.begin(), triggers.end(),
+                     [](const OfflineTrigger& a, const OfflineTrigger& b) { return a.timeMs < b.timeMs; });
+    struct Pending
+    {
+        uint64_t frame;
+        int slotId;
+        Action action;
+    };
+    std::deque<Pending> pending;
+    for (const auto& t : triggers) {
+        if (t.slotId >= 0 && t.slotId < MAX_CLIPS && !clips[t.slotId].filePath.empty())
+            pending.push_back({base + msToFrames(t.timeMs), t.slotId, t.action});
+    }
+    std::vector<Pending> restarts; // plays waiting for the slot's previous voice to fade out
+
+    // A voice still contributes audio (or is about to); decided from mixer state only, so it is deterministic
+    auto voiceActive = [](const ClipSlot& slot) {
+        const bool stopDone = slot.scheduledStopHit.load(std::memory_order_acquire) &&
+                              slot.stopFadeMainLeft.load(std::memory_order_acquire) == 0;
+        switch (slot.state.load(std::memory_order_acquire)) {
+        case ClipState::Playing:
+            return !stopDone;
+        case ClipState::Draining:
+            return !stopDone && slot.queuedMainFrames.load(std::memory_order_relaxed) > 0;
+        default:
+            return false;
+        }
+    };
+
+    // Untimed, bounded waits on the decoder threads; a stuck decoder shows up as a clip underrun
+    auto waitFor = [](const std::function<bool()>& ready) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!ready() && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+    };
+
+    const ma_uint32 frameCount = m_bufferSizeFrames;
+    const uint64_t endFrame = base + msToFrames(durationMs > 0.0 ? durationMs : kMaxOfflineRenderMs);
+    std::vector<float> out((size_t)frameCount * m_channels);
+    std::vector<float> mic(frameCount, 0.0f);
+
+    for (;;) {
+        const uint64_t blockStart = frameClock.load(std::memory_order_acquire);
+        const uint64_t blockEnd = blockStart + frameCount;
+        if (blockStart >= endFrame)
+            break;
+
+        // Triggers landing in this block; the mixer starts/stops them at their exact frame
+        while (!pending.empty() && pending.front().frame < blockEnd) {
+            const Pending p = pending.front();
+            pending.pop_front();
+            ClipSlot& slot = clips[p.slotId];
+            const uint64_t at = std::max(p.frame, blockStart);
+
+            if (p.action == Action::Stop) {
+                restarts.erase(std::remove_if(restarts.begin(), restarts.end(),
+                                              [&](const Pending& r) { return r.slotId == p.slotId; }),
+                               restarts.end());
+                if (voiceActive(slot) && slot.stopFadeFrames.load(std::memory_order_acquire) == 0)
+                    stopClipAt(p.slotId, at);
+                continue;
+            }
+
+            if (voiceActive(slot)) {
+                if (slot.stopFadeFrames.load(std::memory_order_acquire) == 0)
+                    stopClipAt(p.slotId, at);
+                restarts.push_back({at, p.slotId, Action::Play});
+                continue;
+            }
+            waitFor([&] { return slot.state.load(std::memory_order_acquire) == ClipState::Stopped; });
+            playClipAt(p.slotId, at);
+        }
+
+        // Restarts go ahead once the old voice has faded out in an earlier block
+        for (auto it = restarts.begin(); it != restarts.end();) {
+            ClipSlot& slot = clips[it->slotId];
+            if (voiceActive(slot)) {
+                ++it;
+                continue;
+            }
+            waitFor([&] { return slot.state.load(std::memory_order_acquire) == ClipState::Stopped; });
+            playClipAt(it->slotId, std::max(it->frame, blockStart));
+            it = restarts.erase(it);
+        }
+
+        // Every playing voice needs its share of this block decoded (or to have reached its end)
+        for (int slotId = 0; slotId < MAX_CLIPS; ++slotId) {
+            ClipSlot& slot = clips[slotId];
+            if (slot.state.load(std::memory_order_acquire) != ClipState::Playing)
+                continue;
+            const uint64_t startAt = slot.startAtFrame.load(std::memory_order_acquire);
+            if (startAt != kNoScheduledFrame && startAt >= blockEnd)
+                continue;
+            const long long need = (long long)(blockEnd - std::max(startAt == kNoScheduledFrame ? 0 : startAt,
+                                                                   blockStart));
+            waitFor([&] {
+                return slot.state.load(std::memory_order_acquire) != ClipState::Playing ||
+                       slot.queuedMainFrames.load(std::memory_order_relaxed) >= need;
+            });
+        }
+
+        if (durationMs <= 0.0 && pending.empty() && restarts.empty() && !micActive) {
+            bool anyActive = false;
+            for (const ClipSlot& slot : clips)
+                anyActive = anyActive || voiceActive(slot);
+            if (!anyActive)
+                break;
+        }
+
+        if (micActive) {
+            uint64_t read = 0;
+            micDecoder.readPcmFrames(mic.data(), frameCount, &read);
+            std::fill(mic.begin() + (ptrdiff_t)read, mic.end(), 0.0f);
+            micActive = read == frameCount;
+        }
+
+        renderOfflineBlock(haveMic ? mic.data() : nullptr, out.data(), frameCount);
+
+        const ma_uint32 toWrite = (ma_uint32)std::min<uint64_t>(frameCount, endFrame - blockStart);
+        ma_encoder_write_pcm_frames(&encoder, out.data(), toWrite, nullptr);
+        result.framesRendered += toWrite;
+    }
+
+    // Without a running output stopClip skips the fade instead of waiting on a mixer that no longer runs
+    stopOfflineRendering();
+    for (int slotId = 0; slotId < MAX_CLIPS; ++slotId)
+        stopClip(slotId);
+
+    micDecoder.close();
+    ma_encoder_uninit(&encoder);
+
+    result.success = true;
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return result;
+}
+
+ma_uint32 AudioEngine::getClipBufferedFrames(int slotId) const
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return 0;
+    return (ma_uint32)std::max<long long>(0, clips[slotId].queuedMainFrames.load(std::memory_order_relaxed));
+}
+
+double AudioEngine::getClipPlayableMs(int slotId) const
+{
+    if (slotId < 0 || slotId >= MAX_CLIPS)
+        return 0.0;
+
+    const ClipSlot& slot = clips[slotId];
+    const double totalMs = slot.totalDurationMs.load(std::memory_order_relaxed);
+    const double startMs = slot.trimStartMs.load(std::memory_order_relaxed);
+    const double endMs = slot.trimEndMs.load(std::memory_order_relaxed);
+    const double stopMs = (endMs > 0.0 && endMs < totalMs) ? endMs : totalMs;
+    return std::max(0.0, stopMs - startMs);
+}
+
 double AudioEngine::getClipPlaybackPositionMs(int slotId) const
 {
     if (slotId < 0 || slotId >= MAX_CLIPS)
@@ -2035,47 +3607,46 @@ double AudioEngine::getClipPlaybackPositionMs(int slotId) const
 
 double AudioEngine::getFileDuration(const std::string& filepath)
 {
-    ma_decoder_config cfg = ma_decoder_config_init(ma_format_f32, 2, m_sampleRate);
-    ma_decoder dec;
-    double duration = -1.0;
+    const MediaInfo info = m_mediaInfoCache.probe(filepath);
+    return info.isValid() ? info.durationSec() : -1.0;
+}
 
-#ifdef _WIN32
-    std::wstring wpath = utf8ToWide(filepath);
-    if (ma_decoder_init_file_w(wpath.c_str(), &cfg, &dec) == MA_SUCCESS) {
-#else
-    if (ma_decoder_init_file(filepath.c_str(), &cfg, &dec) == MA_SUCCESS) {
-#endif
-        ma_uint64 totalFrames = 0;
-        if (ma_decoder_get_length_in_pcm_frames(&dec, &totalFrames) == MA_SUCCESS && dec.outputSampleRate > 0) {
-            duration = (double)totalFrames / (double)dec.outputSampleRate;
-        }
-        ma_decoder_uninit(&dec);
-    }
-    return duration;
+MediaInfo AudioEngine::getMediaInfo(const std::string& filepath)
+{
+    return m_mediaInfoCache.probe(filepath);
+}
+
+void AudioEngine::setMediaCacheDirectory(const std::string& directory)
+{
+    m_mediaInfoCache.setStorageDirectory(directory);
+    m_resampledClips.setStorageDirectory(directory + "/resampled");
+}
+
+bool AudioEngine::openFileDecoder(ClipDecoder& decoder, const std::string& filepath)
+{
+    const DecoderBackend preferred = m_mediaInfoCache.preferredBackend(filepath);
+    decoder.setResamplerQuality(ResamplerQuality::Sinc64); // edits and exports, never live
+    if (!decoder.open(filepath, m_sampleRate, 2, preferred))
+        return false;
+    if (decoder.backend() != preferred)
+        m_mediaInfoCache.updateBackend(filepath, decoder.backend());
+    return true;
 }
 
 bool AudioEngine::exportTrimmedAudio(const std::string& sourcePath, const std::string& destPath, double trimStartMs,
                                      double trimEndMs)
 {
     // Initialize decoder for source file
-    ma_decoder_config decCfg = ma_decoder_config_init(ma_format_f32, 2, m_sampleRate);
-    ma_decoder decoder;
-
-#ifdef _WIN32
-    std::wstring wsourcePath = utf8ToWide(sourcePath);
-    if (ma_decoder_init_file_w(wsourcePath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#else
-    if (ma_decoder_init_file(sourcePath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#endif
+    ClipDecoder decoder;
+    if (!openFileDecoder(decoder, sourcePath)) {
         std::cerr << "exportTrimmedAudio: Failed to open source file: " << sourcePath << std::endl;
         return false;
     }
 
     // Get source file info
-    ma_uint64 totalFrames = 0;
-    ma_decoder_get_length_in_pcm_frames(&decoder, &totalFrames);
-    const ma_uint32 sampleRate = decoder.outputSampleRate;
-    const ma_uint32 channels = decoder.outputChannels;
+    const uint64_t totalFrames = decoder.getLengthInPcmFrames();
+    const ma_uint32 sampleRate = decoder.getSampleRate();
+    const ma_uint32 channels = decoder.getChannels();
 
     // Calculate frame ranges from milliseconds
     const ma_uint64 startFrame = static_cast<ma_uint64>((trimStartMs / 1000.0) * sampleRate);
@@ -2090,16 +3661,16 @@ bool AudioEngine::exportTrimmedAudio(const std::string& sourcePath, const std::s
     if (startFrame >= endFrame) {
         std::cerr << "exportTrimmedAudio: Invalid trim range - start:" << startFrame << " end:" << endFrame
                   << std::endl;
-        ma_decoder_uninit(&decoder);
+        decoder.close();
         return false;
     }
 
     const ma_uint64 framesToWrite = endFrame - startFrame;
 
     // Seek to start position
-    if (ma_decoder_seek_to_pcm_frame(&decoder, startFrame) != MA_SUCCESS) {
+    if (!decoder.seekToPcmFrame(startFrame)) {
         std::cerr << "exportTrimmedAudio: Failed to seek to frame: " << startFrame << std::endl;
-        ma_decoder_uninit(&decoder);
+        decoder.close();
         return false;
     }
 
@@ -2109,7 +3680,7 @@ bool AudioEngine::exportTrimmedAudio(const std::string& sourcePath, const std::s
 
     if (ma_encoder_init_file(destPath.c_str(), &encCfg, &encoder) != MA_SUCCESS) {
         std::cerr << "exportTrimmedAudio: Failed to create output file: " << destPath << std::endl;
-        ma_decoder_uninit(&decoder);
+        decoder.close();
         return false;
     }
 
@@ -2123,8 +3694,8 @@ bool AudioEngine::exportTrimmedAudio(const std::string& sourcePath, const std::s
         const ma_uint32 framesToRead =
             static_cast<ma_uint32>(std::min(static_cast<ma_uint64>(kChunkFrames), framesRemaining));
 
-        ma_uint64 framesRead = 0;
-        ma_result res = ma_decoder_read_pcm_frames(&decoder, buffer.data(), framesToRead, &framesRead);
+        uint64_t framesRead = 0;
+        ma_result res = decoder.readPcmFrames(buffer.data(), framesToRead, &framesRead);
 
         if (framesRead == 0 || res != MA_SUCCESS) {
             break; // End of file or error
@@ -2136,7 +3707,7 @@ bool AudioEngine::exportTrimmedAudio(const std::string& sourcePath, const std::s
 
     // Cleanup
     ma_encoder_uninit(&encoder);
-    ma_decoder_uninit(&decoder);
+    decoder.close();
 
     std::cout << "exportTrimmedAudio: Exported " << framesWritten << " frames to " << destPath << std::endl;
     return true;
@@ -2149,21 +3720,14 @@ bool AudioEngine::exportTrimmedAudio(const std::string& sourcePath, const std::s
 double AudioEngine::measureLoudness(const std::string& filepath, NormalizationType type)
 {
     // Initialize decoder
-    ma_decoder_config decCfg = ma_decoder_config_init(ma_format_f32, 2, m_sampleRate);
-    ma_decoder decoder;
-
-#ifdef _WIN32
-    std::wstring wpath = utf8ToWide(filepath);
-    if (ma_decoder_init_file_w(wpath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#else
-    if (ma_decoder_init_file(filepath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#endif
+    ClipDecoder decoder;
+    if (!openFileDecoder(decoder, filepath)) {
         std::cerr << "measureLoudness: Failed to open file: " << filepath << std::endl;
         return std::numeric_limits<double>::quiet_NaN();
     }
 
-    const ma_uint32 channels = decoder.outputChannels;
-    const ma_uint32 sampleRate = decoder.outputSampleRate;
+    const ma_uint32 channels = decoder.getChannels();
+    const ma_uint32 sampleRate = decoder.getSampleRate();
 
 #if TALKLESS_HAS_EBUR128
     if (type == NormalizationType::LUFS) {
@@ -2171,7 +3735,7 @@ double AudioEngine::measureLoudness(const std::string& filepath, NormalizationTy
         ebur128_state* state = ebur128_init(channels, sampleRate, EBUR128_MODE_I);
         if (!state) {
             std::cerr << "measureLoudness: Failed to initialize ebur128" << std::endl;
-            ma_decoder_uninit(&decoder);
+            decoder.close();
             return std::numeric_limits<double>::quiet_NaN();
         }
 
@@ -2180,8 +3744,8 @@ double AudioEngine::measureLoudness(const std::string& filepath, NormalizationTy
         std::vector<float> buffer(static_cast<size_t>(kChunkFrames) * channels);
 
         while (true) {
-            ma_uint64 framesRead = 0;
-            ma_result res = ma_decoder_read_pcm_frames(&decoder, buffer.data(), kChunkFrames, &framesRead);
+            uint64_t framesRead = 0;
+            ma_result res = decoder.readPcmFrames(buffer.data(), kChunkFrames, &framesRead);
             if (framesRead == 0 || res != MA_SUCCESS) {
                 break;
             }
@@ -2191,7 +3755,7 @@ double AudioEngine::measureLoudness(const std::string& filepath, NormalizationTy
         double loudness = 0.0;
         ebur128_loudness_global(state, &loudness);
         ebur128_destroy(&state);
-        ma_decoder_uninit(&decoder);
+        decoder.close();
         return loudness;
     }
 #endif
@@ -2205,8 +3769,8 @@ double AudioEngine::measureLoudness(const std::string& filepath, NormalizationTy
     std::vector<float> buffer(static_cast<size_t>(kChunkFrames) * channels);
 
     while (true) {
-        ma_uint64 framesRead = 0;
-        ma_result res = ma_decoder_read_pcm_frames(&decoder, buffer.data(), kChunkFrames, &framesRead);
+        uint64_t framesRead = 0;
+        ma_result res = decoder.readPcmFrames(buffer.data(), kChunkFrames, &framesRead);
         if (framesRead == 0 || res != MA_SUCCESS) {
             break;
         }
@@ -2217,7 +3781,7 @@ double AudioEngine::measureLoudness(const std::string& filepath, NormalizationTy
         totalSamples += samples;
     }
 
-    ma_decoder_uninit(&decoder);
+    decoder.close();
 
     if (totalSamples == 0) {
         return std::numeric_limits<double>::quiet_NaN();
@@ -2276,21 +3840,14 @@ AudioEngine::NormalizationResult AudioEngine::normalizeAudio(const std::string&
     result.backupPath = sourcePath + ".backup";
 
     // Initialize decoder for source file
-    ma_decoder_config decCfg = ma_decoder_config_init(ma_format_f32, 2, m_sampleRate);
-    ma_decoder decoder;
-
-#ifdef _WIN32
-    std::wstring wsourcePath = utf8ToWide(sourcePath);
-    if (ma_decoder_init_file_w(wsourcePath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#else
-    if (ma_decoder_init_file(sourcePath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#endif
+    ClipDecoder decoder;
+    if (!openFileDecoder(decoder, sourcePath)) {
         result.error = "Failed to open source file";
         return result;
     }
 
-    const ma_uint32 sampleRate = decoder.outputSampleRate;
-    const ma_uint32 channels = decoder.outputChannels;
+    const ma_uint32 sampleRate = decoder.getSampleRate();
+    const ma_uint32 channels = decoder.getChannels();
 
     // Initialize encoder for output file
     ma_encoder encoder;
@@ -2298,7 +3855,7 @@ AudioEngine::NormalizationResult AudioEngine::normalizeAudio(const std::string&
 
     if (ma_encoder_init_file(result.outputPath.c_str(), &encCfg, &encoder) != MA_SUCCESS) {
         result.error = "Failed to create output file";
-        ma_decoder_uninit(&decoder);
+        decoder.close();
         return result;
     }
 
@@ -2308,8 +3865,8 @@ AudioEngine::NormalizationResult AudioEngine::normalizeAudio(const std::string&
     const float gainF = static_cast<float>(gainLinear);
 
     while (true) {
-        ma_uint64 framesRead = 0;
-        ma_result res = ma_decoder_read_pcm_frames(&decoder, buffer.data(), kChunkFrames, &framesRead);
+        uint64_t framesRead = 0;
+        ma_result res = decoder.readPcmFrames(buffer.data(), kChunkFrames, &framesRead);
         if (framesRead == 0 || res != MA_SUCCESS) {
             break;
         }
@@ -2332,7 +3889,7 @@ AudioEngine::NormalizationResult AudioEngine::normalizeAudio(const std::string&
 
     // Cleanup
     ma_encoder_uninit(&encoder);
-    ma_decoder_uninit(&decoder);
+    decoder.close();
 
     result.success = true;
     std::cout << "normalizeAudio: Normalized " << sourcePath << " (measured: " << measuredLevel
@@ -2437,21 +3994,14 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
     result.outputPath = dir + "/" + effectFilename;
 
     // Initialize decoder for source file
-    ma_decoder_config decCfg = ma_decoder_config_init(ma_format_f32, 2, m_sampleRate);
-    ma_decoder decoder;
-
-#ifdef _WIN32
-    std::wstring wsourcePath = utf8ToWide(sourcePath);
-    if (ma_decoder_init_file_w(wsourcePath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#else
-    if (ma_decoder_init_file(sourcePath.c_str(), &decCfg, &decoder) != MA_SUCCESS) {
-#endif
+    ClipDecoder decoder;
+    if (!openFileDecoder(decoder, sourcePath)) {
         result.error = "Failed to open source file";
         return result;
     }
 
-    const ma_uint32 sampleRate = decoder.outputSampleRate;
-    const ma_uint32 channels = decoder.outputChannels;
+    const ma_uint32 sampleRate = decoder.getSampleRate();
+    const ma_uint32 channels = decoder.getChannels();
 
     // Initialize encoder for output file
     ma_encoder encoder;
@@ -2459,7 +4009,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
 
     if (ma_encoder_init_file(result.outputPath.c_str(), &encCfg, &encoder) != MA_SUCCESS) {
         result.error = "Failed to create output file";
-        ma_decoder_uninit(&decoder);
+        decoder.close();
         return result;
     }
 
@@ -2496,7 +4046,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
             ma_loshelf2_config_init(ma_format_f32, channels, sampleRate, params.gainDb, params.q, params.frequency);
         if (ma_loshelf2_init(&loshelfConfig, nullptr, &loshelf) != MA_SUCCESS) {
             result.error = "Failed to initialize bass boost filter";
-            ma_decoder_uninit(&decoder);
+            decoder.close();
             ma_encoder_uninit(&encoder);
             return result;
         }
@@ -2509,7 +4059,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
             ma_hishelf2_config_init(ma_format_f32, channels, sampleRate, params.gainDb, params.q, params.frequency);
         if (ma_hishelf2_init(&hishelfConfig, nullptr, &hishelf) != MA_SUCCESS) {
             result.error = "Failed to initialize treble boost filter";
-            ma_decoder_uninit(&decoder);
+            decoder.close();
             ma_encoder_uninit(&encoder);
             return result;
         }
@@ -2521,7 +4071,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
         hpfConfig = ma_hpf2_config_init(ma_format_f32, channels, sampleRate, params.frequency, params.q);
         if (ma_hpf2_init(&hpfConfig, nullptr, &hpf) != MA_SUCCESS) {
             result.error = "Failed to initialize low-cut filter";
-            ma_decoder_uninit(&decoder);
+            decoder.close();
             ma_encoder_uninit(&encoder);
             return result;
         }
@@ -2533,7 +4083,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
         lpfConfig = ma_lpf2_config_init(ma_format_f32, channels, sampleRate, params.frequency, params.q);
         if (ma_lpf2_init(&lpfConfig, nullptr, &lpf) != MA_SUCCESS) {
             result.error = "Failed to initialize high-cut filter";
-            ma_decoder_uninit(&decoder);
+            decoder.close();
             ma_encoder_uninit(&encoder);
             return result;
         }
@@ -2546,7 +4096,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
             ma_peak2_config_init(ma_format_f32, channels, sampleRate, params.gainDb, params.q, params.frequency);
         if (ma_peak2_init(&peakConfig, nullptr, &peak) != MA_SUCCESS) {
             result.error = "Failed to initialize voice enhance filter";
-            ma_decoder_uninit(&decoder);
+            decoder.close();
             ma_encoder_uninit(&encoder);
             return result;
         }
@@ -2559,7 +4109,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
             ma_loshelf2_config_init(ma_format_f32, channels, sampleRate, params.gainDb, params.q, params.frequency);
         if (ma_loshelf2_init(&loshelfConfig, nullptr, &loshelf) != MA_SUCCESS) {
             result.error = "Failed to initialize warmth filter";
-            ma_decoder_uninit(&decoder);
+            decoder.close();
             ma_encoder_uninit(&encoder);
             return result;
         }
@@ -2568,7 +4118,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
 
     default:
         result.error = "Unknown effect type";
-        ma_decoder_uninit(&decoder);
+        decoder.close();
         ma_encoder_uninit(&encoder);
         return result;
     }
@@ -2578,8 +4128,8 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
     std::vector<float> buffer(static_cast<size_t>(kChunkFrames) * channels);
 
     while (true) {
-        ma_uint64 framesRead = 0;
-        ma_result res = ma_decoder_read_pcm_frames(&decoder, buffer.data(), kChunkFrames, &framesRead);
+        uint64_t framesRead = 0;
+        ma_result res = decoder.readPcmFrames(buffer.data(), kChunkFrames, &framesRead);
         if (framesRead == 0 || res != MA_SUCCESS) {
             break;
         }
@@ -2614,7 +4164,7 @@ AudioEngine::AudioEffectResult AudioEngine::applyAudioEffect(const std::string&
 
     // Cleanup encoder/decoder
     ma_encoder_uninit(&encoder);
-    ma_decoder_uninit(&decoder);
+    decoder.close();
 
     result.success = true;
     std::cout << "applyAudioEffect: Applied " << result.effectName << " to " << sourcePath << " -> "
@@ -12,8 +12,19 @@
 
 // DO NOT put MINIAUDIO_IMPLEMENTATION in a header.
 // Define it in exactly one .cpp (e.g., audioEngine.cpp).
+#include "busMeter.h"
+#include "callbackProfiler.h"
+#include "gainRamp.h"
+#include "latencyHistogram.h"
+#include "mediaInfoCache.h"
 #include "miniaudio.h"
 #include "noiseSuppressor.h"
+#include "resampledClipCache.h"
+#include "resampler.h"
+#include "spscQueue.h"
+#include "voiceRingSlab.h"
+
+class ClipDecoder;
 
 class AudioEngine
 {
@@ -36,7 +47,8 @@ public:
     // ------------------------------------------------------------
     // Constants
     // ------------------------------------------------------------
-    static constexpr ma_uint32 DEFAULT_SAMPLE_RATE = 96000;
+    static constexpr ma_uint32 DEFAULT_SAMPLE_RATE = 48000;
+    static constexpr ma_uint32 NATIVE_SAMPLE_RATE = 0; // setAudioConfig: run at the playback device's own rate
     static constexpr ma_uint32 DEFAULT_BUFFER_SIZE = 512;
     static constexpr ma_uint32 DEFAULT_BUFFER_PERIODS = 3;
     static constexpr ma_uint32 DEFAULT_CHANNELS = 2;
@@ -53,6 +65,8 @@ public:
     // Audio Configuration
     // ------------------------------------------------------------
     void setAudioConfig(ma_uint32 sampleRate, ma_uint32 bufferSize, ma_uint32 periods, ma_uint32 channels);
+    // Rate the engine mixes at; with NATIVE_SAMPLE_RATE, whatever the playback device reported on init
+    ma_uint32 getSampleRate() const { return m_sampleRate; }
 
     // ------------------------------------------------------------
     // Devices / context
@@ -116,6 +130,26 @@ public:
     void setMicGainLinear(float linear);
     float getMicGainLinear() const;
 
+    // Extra mic attenuation on top of the mic gain, e.g. ducking from a macro (0 dB = none)
+    void setMicDuckDB(float duckDB);
+    float getMicDuckDB() const;
+
+    // Speech ducking: while the mic's voice activity (RNNoise VAD, or a level gate when suppression
+    // is off) is at or above the threshold, clips on the main output are pulled down by depthDb.
+    // The detector is carried alongside the mic audio, so the duck lines up with what listeners hear.
+    struct VoiceDuckSettings
+    {
+        bool enabled = false;
+        float threshold = 0.6f; // VAD probability, 0..1
+        float attackMs = 10.0f;
+        float releaseMs = 400.0f;
+        float depthDb = -12.0f;
+    };
+    void setVoiceDucking(const VoiceDuckSettings& settings);
+    VoiceDuckSettings getVoiceDucking() const;
+    // Current clip attenuation on the main output (0 dB = not ducked)
+    float getVoiceDuckGainDb() const;
+
     void setMasterGainDB(float gainDB);
     float getMasterGainDB() const;
     void setMasterGainLinear(float linear);
@@ -129,12 +163,48 @@ public:
     int getNoiseSuppressionLevel() const;
     bool isNoiseSuppressionEnabled() const;
 
+    // Separate level (and RNNoise state) for the extra recording-input device
+    void setRecordingInputNoiseSuppressionLevel(int level);
+    int getRecordingInputNoiseSuppressionLevel() const;
+
     // Peak meters
     float getMicPeakLevel() const;
     float getMasterPeakLevel() const;
     float getMonitorPeakLevel() const;
     void resetPeakLevels();
 
+    // Per voice, measured by the main mixer after gain and ducking; zero while the voice is stopped
+    struct VoiceMeterReading
+    {
+        float rms = 0.0f;  // as getVoiceRms
+        float peak = 0.0f; // linear sample peak, BusMeter::Reading::peak ballistics
+    };
+
+    // Full meters: each bus and voice publishes once per block, so a snapshot is at most one block old
+    struct MeterSnapshot
+    {
+        BusMeter::Reading mic; // captured mic after noise suppression, before mute and balance
+        BusMeter::Reading master;
+        BusMeter::Reading monitor;
+        VoiceMeterReading voices[MAX_CLIPS];
+    };
+    MeterSnapshot getMeterSnapshot() const;
+    void resetMeters();
+
+    // Everything a UI frame shows about the voices, read in one pass
+    struct VoiceTelemetry
+    {
+        bool playing = false; // as isClipPlaying (paused counts)
+        bool paused = false;
+        double positionMs = 0.0; // as getClipPlaybackPositionMs
+    };
+    struct TelemetrySnapshot
+    {
+        MeterSnapshot meters;
+        VoiceTelemetry voices[MAX_CLIPS];
+    };
+    TelemetrySnapshot getTelemetrySnapshot() const;
+
     // ------------------------------------------------------------
     // Callbacks
     // ------------------------------------------------------------
@@ -149,14 +219,212 @@ public:
     void unloadClip(int slotId);
 
     void playClip(int slotId);
-    void pauseClip(int slotId);
-    void resumeClip(int slotId);
+    void pauseClip(int slotId);  // fades out first (clip fade length); blocks for the fade
+    void resumeClip(int slotId); // fades back in
     void stopClip(int slotId);
 
+    // ------------------------------------------------------------
+    // Command queue: lets control threads (the UI thread's hotkey handler, the macro
+    // sequencer) start/stop already-loaded clips without waiting on decoder threads or
+    // fades. Commands run in order on the engine's command thread.
+    // ------------------------------------------------------------
+    struct Command
+    {
+        enum class Type : uint8_t {
+            PlayClip, // restart from the trim start (fades out first if playing)
+            StopClip,
+            PlayClipAt, // playClipAt(slotId, frame)
+            StopClipAt  // stopClipAt(slotId, frame), clip fade
+        };
+        Type type = Type::PlayClip;
+        int slotId = -1;
+        uint64_t frame = kNoScheduledFrame; // *At commands only
+    };
+
+    bool postCommand(const Command& cmd); // false if the queue is full (caller should do it directly)
+    void flushCommands();                 // blocks until every posted command has run
+    bool isClipLoaded(int slotId, const std::string& filepath) const;
+
+    // ------------------------------------------------------------
+    // Trigger latency: hotkey press -> action handler -> engine command -> first decoded
+    // block -> first frame mixed into the main output (+ device buffering = audible)
+    // ------------------------------------------------------------
+    enum class LatencyStage {
+        HotkeyToAction,
+        ActionToEnqueue,
+        EnqueueToDecoded,
+        DecodedToMixed,
+        HotkeyToMixed,
+        HotkeyToOutput,
+        Count
+    };
+    static const char* latencyStageName(LatencyStage stage);
+
+    // Trace the next start of this slot. actionNs < 0 if the press skipped the action handler.
+    // The trace is armed by that start itself and follows only its play token, so audio still
+    // mixed from the slot's previous sound never closes it.
+    void armLatencyTrace(int slotId, int64_t pressNs, int64_t actionNs);
+    LatencyHistogram::Summary getLatencySummary(LatencyStage stage) const;
+    void resetLatencyStats();
+    double getOutputLatencyMs() const; // playback device buffering as configured by the backend
+
+    // ------------------------------------------------------------
+    // Engine health: time spent in each device callback and ring buffer
+    // over/underruns. Lock-free; safe to poll from the UI thread.
+    // ------------------------------------------------------------
+    enum class EngineCallback {
+        Playback,
+        Capture,
+        Monitor,
+        RecordingInput,
+        Count
+    };
+    static const char* engineCallbackName(EngineCallback cb);
+    CallbackProfiler::Snapshot getCallbackProfile(EngineCallback cb) const;
+
+    struct XrunCounters
+    {
+        uint64_t captureOverruns = 0;        // mic blocks (partly) dropped, capture ring full
+        uint64_t recordingOverruns = 0;      // mixed blocks (partly) dropped, recording ring full
+        uint64_t recordingInputOverruns = 0; // recording-input blocks (partly) dropped
+        uint64_t clipUnderruns = 0;          // playing clip had fewer frames ready than the block needed
+    };
+    XrunCounters getXrunCounters() const;
+    void resetEngineHealth();
+
+    // Memory reserved for all clip voices' ring buffers (allocated once, not per load)
+    size_t getVoiceRingMemoryBytes() const { return m_voiceRings.totalBytes(); }
+
+    // Constant delay noise suppression adds to the mic path: the suppressor's own while it is on,
+    // plus the DSP thread's headroom while that mode is active
+    double getNoiseSuppressionLatencyMs() const;
+
+    // Run noise suppression on a dedicated DSP thread instead of the capture callback (from the
+    // next device start). The callback then only copies the mic into a lock-free ring, and the
+    // thread denoises it in DSP_BATCH_MS batches. The mic path gains a fixed 2 x DSP_BATCH_MS.
+    void setNoiseSuppressionOnDspThread(bool enabled);
+    bool isNoiseSuppressionOnDspThread() const;
+
+    // ------------------------------------------------------------
+    // Headless rendering: runs the mic capture + main mix path without any device, one block
+    // at a time on the caller's thread (benchmarks, offline export). Clips play as they would
+    // on a running main output; the real main devices must be stopped.
+    // ------------------------------------------------------------
+    bool startOfflineRendering();
+    void stopOfflineRendering();
+    bool isOfflineRendering() const;
+    // micInput: frameCount mono samples (nullptr = silence); output: frameCount * configured channels
+    void renderOfflineBlock(const float* micInput, float* output, ma_uint32 frameCount);
+    ma_uint32 getChannels() const { return m_channels; }
+    ma_uint32 getClipBufferedFrames(int slotId) const; // decoded frames waiting for the main mix
+
+    // Offline session: a timed trigger script (plus an optional mic input file) rendered through the
+    // main mix and limiter into a WAV file, as fast as the decoders allow. Clips must already be
+    // loaded into their slots and the main devices stopped. Output is identical run to run.
+    struct OfflineTrigger
+    {
+        enum class Action : uint8_t {
+            Play, // restarts a playing slot after its stop fade, like playClip after stopClip
+            Stop
+        };
+        double timeMs = 0.0; // from the start of the render
+        int slotId = -1;
+        Action action = Action::Play;
+    };
+
+    struct OfflineRenderResult
+    {
+        bool success = false;
+        std::string error;
+        uint64_t framesRendered = 0;
+        double wallSeconds = 0.0; // real time the render took
+    };
+
+    static constexpr double kMaxOfflineRenderMs = 10.0 * 60.0 * 1000.0;
+
+    // durationMs <= 0: until every triggered clip and the mic input have ended (capped at kMaxOfflineRenderMs)
+    OfflineRenderResult renderSession(std::vector<OfflineTrigger> triggers, const std::string& micInputPath,
+                                      const std::string& outputPath, double durationMs = 0.0);
+
+    // ------------------------------------------------------------
+    // Scheduled playback (sample-accurate, on the main output's clock)
+    // ------------------------------------------------------------
+    static constexpr uint64_t kNoScheduledFrame = UINT64_MAX;
+
+    // Frames rendered by the main output since it started
+    uint64_t getEngineFrameTime() const;
+    // Earliest engine frame at least leadMs ahead, rounded up to a gridMs grid (e.g. 60000/bpm for beats)
+    uint64_t nextScheduleFrame(double leadMs, double gridMs = 0.0) const;
+    static uint64_t quantizeFrame(uint64_t frame, uint64_t gridFrames);
+
+    // Like playClip/stopClip, but the mixer starts/stops the clip at exactly this engine frame.
+    // Schedule far enough ahead for the decoder to fill the ring (see nextScheduleFrame).
+    void playClipAt(int slotId, uint64_t startFrame);
+    // fadeMs < 0: the clip fade length
+    void stopClipAt(int slotId, uint64_t stopFrame, double fadeMs = -1.0);
+
     void setClipLoop(int slotId, bool loop);
+    void setClipLoopCrossfade(int slotId, double crossfadeMs); // 0 = hard (still gapless) loop
+
+    // Quality for clips decoded at a rate other than the output's (applies from the next play).
+    // Only until their converted copy exists; offline edits always use the best tier.
+    void setResamplerQuality(ResamplerQuality quality);
+    ResamplerQuality getResamplerQuality() const;
+
+    // Fade applied at trim points and on stopClip, so cutting into a waveform never clicks (0 = off)
+    void setClipFadeMs(double fadeMs);
+    double getClipFadeMs() const;
+    // Gain changes are smoothed over kGainSmoothingMs by the mixer, so a moving volume slider never zippers
     void setClipGain(int slotId, float gainDB);
     float getClipGain(int slotId) const;
 
+    // ------------------------------------------------------------
+    // Gain automation (ramped per block by each output; never touches the decoder)
+    // ------------------------------------------------------------
+    static constexpr double kGainSmoothingMs = 20.0;
+    static constexpr float kSilentLevelDb = -60.0f; // at or below: silent
+
+    // Ramp a clip's level (on top of its gain) to levelDB over rampMs: duck-to-level, mute, unmute.
+    // Reset to 0 dB whenever the clip is started again.
+    void rampClipLevel(int slotId, float levelDB, double rampMs);
+    float getClipLevel(int slotId) const;
+    // Fade out over fadeMs, then stop. Returns at once; the end is reported like a natural end.
+    void fadeOutAndStop(int slotId, double fadeMs);
+
+    // ------------------------------------------------------------
+    // Voice allocation
+    // ------------------------------------------------------------
+    enum class VoiceStealPolicy {
+        Oldest = 0,        // the voice started longest ago
+        Quietest = 1,      // lowest live RMS on the main output (paused voices count as silent)
+        LowestPriority = 2 // lowest clip priority, oldest among equals; never one above the new sound's
+    };
+    static constexpr double kVoiceStealFadeMs = 10.0;
+
+    void setVoiceStealPolicy(VoiceStealPolicy policy);
+    VoiceStealPolicy getVoiceStealPolicy() const;
+    void setClipPriority(int slotId, int priority); // higher survives longer under LowestPriority
+
+    /**
+     * @brief Pick a voice for a new sound from candidateMask (bit i = slot i)
+     *
+     * An idle voice if there is one, then one already on its way out (being
+     * stopped, fading, or with a scheduled stop due within kVoiceStealFadeMs),
+     * else the victim chosen by policy, whose stop is scheduled with a
+     * kVoiceStealFadeMs fade (fadeOutAndStop, does not block) and counted in
+     * getVoicesStolen(). The caller's stopClip() before loading the voice then
+     * waits only for that fade and the decoder join (~13 ms at 48 kHz) rather than
+     * a clip fade. The old sound may still report its end through the finished
+     * callback. -1 if LowestPriority finds nothing it may take.
+     * Start order and RMS are kept per voice as they change, so picking only
+     * scans the fixed voice table.
+     */
+    int acquireVoice(uint32_t candidateMask, int priority, VoiceStealPolicy policy);
+    int acquireVoice(uint32_t candidateMask, int priority = 0);
+
+    float getVoiceRms(int slotId) const; // smoothed over ~300 ms, after gain and ducking
+    uint64_t getVoicesStolen() const;
+
     void setClipTrim(int slotId, double startMs, double endMs);
     void seekClip(int slotId, double positionMs);
     void setClipStartPosition(int slotId, double positionMs); // Sets position BEFORE playClip is called
@@ -165,9 +433,16 @@ public:
     bool isClipPlaying(int slotId) const;
     bool isClipPaused(int slotId) const;
     double getClipPlaybackPositionMs(int slotId) const;
+    double getClipPlayableMs(int slotId) const; // trimStart..trimEnd (or end of file), one pass
 
     double getFileDuration(const std::string& filepath);
 
+    // Probed media info (codec, native rate, frame count, backend), cached and persisted per file
+    MediaInfo getMediaInfo(const std::string& filepath);
+    // Also hosts the resampled clip copies (<directory>/resampled)
+    void setMediaCacheDirectory(const std::string& directory);
+    MediaInfoCache& mediaInfoCache() { return m_mediaInfoCache; }
+
     // Export a trimmed segment of an audio file to a new file
     // Returns true on success, false on failure
     bool exportTrimmedAudio(const std::string& sourcePath, const std::string& destPath, double trimStartMs,
@@ -265,11 +540,19 @@ private:
         Stopping
     };
 
+    struct VoiceRamps
+    {
+        uint64_t playToken = 0; // play these ramps were snapped for
+        GainRamp gain;
+        GainRamp level;
+    };
+
     struct ClipSlot
     {
         std::atomic<ClipState> state{ClipState::Stopped};
         std::atomic<float> gain{1.0f};
         std::atomic<bool> loop{false};
+        std::atomic<double> loopCrossfadeMs{0.0};
 
         std::atomic<double> trimStartMs{0.0};
         std::atomic<double> trimEndMs{-1.0};
@@ -278,29 +561,108 @@ private:
         std::atomic<long long> playbackFrameCount{0};
         std::atomic<long long> queuedMainFrames{0};
 
+        // Stop fade: length set by stopClip, frames left counted down by each output callback
+        std::atomic<uint32_t> stopFadeFrames{0};
+        std::atomic<uint32_t> stopFadeMainLeft{0};
+        std::atomic<uint32_t> stopFadeMonLeft{0};
+        std::atomic<double> stopFadeMs{-1.0}; // stopClipAt's fade length (< 0 = clipFadeMs)
+
+        // Voice allocation: start order, priority, and the main mixer's running RMS of this voice
+        std::atomic<uint64_t> startSerial{0};
+        std::atomic<int> priority{0};
+        std::atomic<float> liveRms{0.0f};
+        // Voice meter: hold state owned by the main mixer (reset when meterToken falls behind playToken)
+        Seqlock<VoiceMeterReading> meterReading;
+        float meterPeakHold = 0.0f;
+        uint32_t meterPeakHoldLeft = 0;
+        uint64_t meterToken = 0;
+
+        // Gain automation: control threads set targets and ramp lengths, each output ramps toward them
+        std::atomic<uint32_t> gainRampFrames{0};
+        std::atomic<float> level{1.0f};
+        std::atomic<uint32_t> levelRampFrames{0};
+        // Pause fade: level heads to 0 before the pause and stays there while paused
+        std::atomic<bool> pauseFade{false};
+        std::atomic<uint32_t> pauseFadeMainLeft{0};
+        std::atomic<uint32_t> pauseFadeMonLeft{0};
+
+        // Scheduled start/stop in engine frames (kNoScheduledFrame = none)
+        std::atomic<uint64_t> startAtFrame{kNoScheduledFrame};
+        std::atomic<uint64_t> stopAtFrame{kNoScheduledFrame};
+        std::atomic<bool> scheduledStopHit{false};
+
         std::atomic<int> sampleRate{0};
         std::atomic<int> channels{0};
         std::atomic<double> totalDurationMs{0.0};
 
         std::atomic<uint64_t> playToken{0};
 
+        // Latency trace (see armLatencyTrace), stamped with latencyClockNs(). pending* wait for the next
+        // start, which moves them into the trace for its own playToken (traceToken).
+        std::atomic<bool> tracePending{false};
+        std::atomic<int64_t> pendingPressNs{0};
+        std::atomic<int64_t> pendingActionNs{-1};
+        std::atomic<int64_t> pendingEnqueueNs{0};
+        std::atomic<bool> traceArmed{false};
+        std::atomic<uint64_t> traceToken{0};
+        std::atomic<int64_t> tracePressNs{0};
+        std::atomic<int64_t> traceActionNs{-1};
+        std::atomic<int64_t> traceEnqueueNs{0};
+        std::atomic<int64_t> traceDecodedNs{0};
+
+        // Set by the main mixer once the first frames of a start were mixed; underruns only count after that
+        std::atomic<bool> mainPrimed{false};
+
         // Monitor-only mode: if true, clip only plays on monitor output (not main)
         std::atomic<bool> monitorOnly{false};
 
+        // Held across every start/stop/load/unload of the slot, whichever thread does it (UI, command thread,
+        // macro sequencer), so decoderThread and filePath only change under it. Decoder and audio threads
+        // never take it.
+        mutable std::mutex lifecycleMutex;
+
         std::string filePath;
+        DecoderBackend backend = DecoderBackend::Unknown; // from media info, set by loadClip
+        uint32_t nativeSampleRate = 0;                    // ditto; decoded from a resampled copy if it differs
+        std::shared_ptr<const SeekIndex> seekIndex;        // built at import; null for WAV/FLAC etc.
 
-        // ring buffers (stereo)
+        // ring buffers (stereo), carved from m_voiceRings
         ma_pcm_rb ringBufferMain{};
-        void* ringBufferMainData = nullptr;
-
         ma_pcm_rb ringBufferMon{};
-        void* ringBufferMonData = nullptr;
 
         std::thread decoderThread;
+
+        // Ramp state, one set per output callback (snapped to the targets on every new play)
+        VoiceRamps mainRamps;
+        VoiceRamps monRamps;
     };
 
+    // Command thread
+    void commandThreadFunc();
+    void runCommand(const Command& cmd);
+
+    // Latency probes
+    static void stampLatency(std::atomic<int64_t>& stamp, const ClipSlot& slot);
+    void armPendingTrace(ClipSlot& slot, uint64_t token); // from startVoice, for the start with this token
+    void finishLatencyTrace(ClipSlot& slot, ma_uint32 startOffset);
+
     // Decoder thread
     static void decoderThreadFunc(AudioEngine* engine, ClipSlot* slot, int slotId, uint64_t token);
+    void fadeOutClip(ClipSlot& slot, double fadeMs); // blocks for the fade length
+    void stopClipWithFade(int slotId, double fadeMs);
+    // Bodies of playClipAt / stopClipWithFade; the caller holds slot.lifecycleMutex
+    void startVoice(ClipSlot& slot, int slotId, uint64_t startFrame);
+    void stopVoice(ClipSlot& slot, double fadeMs);
+    void fadeToPause(ClipSlot& slot); // ditto
+    void resumeFromPause(ClipSlot& slot);
+    uint32_t fadeFramesFor(double ms) const;
+
+    // Gain automation, per output callback: pick up new targets, then one gain per frame for the frames mixed
+    static void retargetVoiceRamps(ClipSlot& slot, VoiceRamps& ramps);
+    static void voiceGains(VoiceRamps& ramps, float* gains, ma_uint32 frames);
+
+    // Offline file tools: stereo at the engine rate, backend chosen from the media cache
+    bool openFileDecoder(ClipDecoder& decoder, const std::string& filepath);
 
     // ------------------------------------------------------------
     // Main pipeline callbacks
@@ -332,6 +694,22 @@ private:
     bool initRecordingRingBuffer(ma_uint32 sampleRate, ma_uint32 channels);
     void shutdownRecordingRingBuffer();
 
+    // ------------------------------------------------------------
+    // Voice-activity sidechain (capture -> playback)
+    // ------------------------------------------------------------
+    float micVoiceActivity(const float* mono, ma_uint32 frames, bool micOn) const;
+    void pushVadMark(ma_uint32 frames, float probability);
+    void resetVadSidechain();
+    void computeVoiceDuck(ma_uint32 micFrames, ma_uint32 frameCount);
+
+    // ------------------------------------------------------------
+    // DSP thread (noise suppression off the capture callback)
+    // ------------------------------------------------------------
+    bool startDspThread();
+    void stopDspThread();
+    void dspThreadFunc();
+    void shutdownDspRingBuffer();
+
     // ------------------------------------------------------------
     // Helpers
     // ------------------------------------------------------------
@@ -341,6 +719,8 @@ private:
     // rb sizing
     ma_uint32 getRingBufferSize() const; // clip ringbuffers
     ma_uint32 getRecInputRbSize() const; // recording input rb
+    bool resizeVoiceRings();             // (re)carve every slot's rings; only while nothing streams
+    void adoptDeviceSampleRate(ma_uint32 deviceRate);
 
     // file writer (legacy; you are using encoder thread now)
     static bool writeWavFile(const std::string& path, const std::vector<float>& samples, int sampleRate, int channels);
@@ -350,6 +730,7 @@ private:
     // Core config
     // ------------------------------------------------------------
     ma_uint32 m_sampleRate = DEFAULT_SAMPLE_RATE;
+    ma_uint32 m_requestedSampleRate = DEFAULT_SAMPLE_RATE; // NATIVE_SAMPLE_RATE = follow the device
     ma_uint32 m_bufferSizeFrames = DEFAULT_BUFFER_SIZE;
     ma_uint32 m_bufferPeriods = DEFAULT_BUFFER_PERIODS;
     ma_uint32 m_channels = DEFAULT_CHANNELS;
@@ -389,12 +770,32 @@ private:
     std::atomic<bool> deviceRunning{false};
     std::atomic<bool> playbackRunning{false};
     std::atomic<bool> captureRunning{false};
+    std::atomic<bool> offlineRendering{false}; // deviceRunning is also set, see startOfflineRendering
 
     // capture -> playback mono ringbuffer
     ma_pcm_rb captureRb{};
     void* captureRbData = nullptr;
     ma_uint32 captureRbFrames = 0;
 
+    // capture -> DSP thread mono ringbuffer, used instead of captureRb's write side while m_dspActive.
+    // The mode only changes while the devices are stopped, so captureRb never has two producers.
+    static constexpr ma_uint32 DSP_BATCH_MS = 10; // one RNNoise frame per wakeup
+    ma_pcm_rb m_dspInputRb{};
+    void* m_dspInputRbData = nullptr;
+    // Same for the recording input, which may keep running across the switch: while the thread
+    // winds down (m_dspRunning without m_dspActive) its blocks are dropped rather than written twice
+    ma_pcm_rb m_dspRecInputRb{};
+    void* m_dspRecInputRbData = nullptr;
+    std::atomic<bool> m_dspRunning{false};
+    std::mutex m_recInputRbMutex; // DSP thread's writes vs. recordingInputRb (re)allocation
+    ma_uint32 m_dspBatchFrames = 0;
+    ma_uint32 m_dspPrimeFrames = 0; // silence captureRb starts with: one host period + one batch
+    std::atomic<bool> m_nsOnDspThread{false}; // requested
+    std::atomic<bool> m_dspActive{false};     // in effect for the running devices
+    std::atomic<bool> m_dspQuit{false};
+    std::atomic<uint64_t> m_dspWake{0};
+    std::thread m_dspThread;
+
     // ------------------------------------------------------------
     // Monitor device (clips-only)
     // ------------------------------------------------------------
@@ -411,10 +812,10 @@ private:
     std::atomic<int> recordingInputCaptureChannels{0};
 
     // High-pass filter state for recording (removes rumble, hum, plosives)
-    // Simple 1-pole high-pass filter per channel
+    // Simple 1-pole high-pass filter on the mono downmix, ahead of noise suppression
     static constexpr float kRecordingHPFCutoff = 80.0F; // 80Hz cutoff
-    float recordingHPFStateL = 0.0F;                    // Left channel filter state
-    float recordingHPFStateR = 0.0F;                    // Right channel filter state
+    float recordingHPFPrevIn = 0.0F;                    // x[n-1]
+    float recordingHPFPrevOut = 0.0F;                   // y[n-1]
     float recordingHPFAlpha = 0.0F;                     // Filter coefficient (computed from sample rate)
 
     // ------------------------------------------------------------
@@ -441,6 +842,9 @@ private:
     // Scratch buffers (avoid realloc in audio callback)
     // ------------------------------------------------------------
     std::vector<float> recTempScratch; // size = bufferSizeFrames * playbackChannels
+    std::vector<float> m_voiceDuckScratch; // per-frame clip gain, size = frameCount
+    std::vector<float> m_voiceGainScratch; // main callback: one voice's automation gain per frame
+    std::vector<float> m_monVoiceGainScratch; // monitor callback: ditto
 
     // ------------------------------------------------------------
     // Mixer parameters
@@ -450,29 +854,95 @@ private:
 
     std::atomic<float> micGainDB{0.0f};
     std::atomic<float> micGain{1.0f};
+    std::atomic<float> micDuckDB{0.0f};
+    std::atomic<float> micDuckGain{1.0f};
+
+    // Voice ducking parameters (see VoiceDuckSettings) and its current gain, for display
+    std::atomic<bool> m_voiceDuckEnabled{false};
+    std::atomic<float> m_voiceDuckThreshold{0.6f};
+    std::atomic<float> m_voiceDuckAttackMs{10.0f};
+    std::atomic<float> m_voiceDuckReleaseMs{400.0f};
+    std::atomic<float> m_voiceDuckDepthDb{-12.0f};
+    std::atomic<float> m_voiceDuckGainDb{0.0f};
+
+    // Each span of frames committed to captureRb is tagged with the VAD at that point; playback
+    // walks the tags as it reads the same frames. The producer is whichever thread writes captureRb.
+    struct VadMark
+    {
+        uint32_t frames = 0;
+        float probability = 0.0f;
+    };
+    SpscQueue<VadMark, 1024> m_vadMarks;
+    uint32_t m_vadPendingFrames = 0; // producer: untagged frames (queue was full), folded into the next tag
+    uint32_t m_vadMarkLeft = 0;      // consumer: frames left in the current tag
+    float m_vadProbability = 0.0f;   // consumer: the current tag's VAD
+    float m_voiceDuckEnvelope = 1.0f; // consumer: clip gain reached so far
 
     std::atomic<float> masterGainDB{0.0f};
     std::atomic<float> masterGain{1.0f};
 
     std::atomic<float> micSoundboardBalance{0.5f}; // 0..1
 
+    std::atomic<double> clipFadeMs{5.0};
+    std::atomic<int> resamplerQuality{(int)ResamplerQuality::Sinc32};
+
+    std::atomic<int> voiceStealPolicy{(int)VoiceStealPolicy::Oldest};
+    std::atomic<uint64_t> m_voiceSerial{0};
+    std::atomic<uint64_t> m_voicesStolen{0};
+
+    // Main output sample clock, advanced after every playback callback
+    std::atomic<uint64_t> frameClock{0};
+
+    // Trigger latency histograms, one per LatencyStage
+    LatencyHistogram m_latency[(int)LatencyStage::Count];
+
+    // Engine health, see getCallbackProfile/getXrunCounters
+    CallbackProfiler m_callbackProfiles[(int)EngineCallback::Count];
+    std::atomic<uint64_t> m_captureOverruns{0};
+    std::atomic<uint64_t> m_recordingOverruns{0};
+    std::atomic<uint64_t> m_recordingInputOverruns{0};
+    std::atomic<uint64_t> m_clipUnderruns{0};
+
     // ------------------------------------------------------------
     // Peaks
     // ------------------------------------------------------------
     std::atomic<float> micPeakLevel{0.0f};
     std::atomic<float> masterPeakLevel{0.0f};
     std::atomic<float> monitorPeakLevel{0.0f};
+    BusMeter m_micMeter;     // playback callback
+    BusMeter m_masterMeter;  // playback callback
+    BusMeter m_monitorMeter; // monitor callback
 
     // ------------------------------------------------------------
     // Noise Suppression
     // ------------------------------------------------------------
-    std::unique_ptr<NoiseSuppressor> m_noiseSuppressor;
+    // One independent stream per mic input; the DSP thread batches whichever are ready together
+    enum NsStream { NS_STREAM_MIC = 0, NS_STREAM_RECORDING_INPUT = 1, NS_STREAM_COUNT };
+    std::unique_ptr<NoiseSuppressorPool> m_noiseSuppressors;
     std::atomic<int> m_noiseSuppressionLevel{2}; // 0=Off, 1=Low, 2=Moderate, 3=High, 4=VeryHigh
+    std::atomic<int> m_recordingInputNoiseSuppressionLevel{2};
 
     // ------------------------------------------------------------
     // Clips
     // ------------------------------------------------------------
     ClipSlot clips[MAX_CLIPS];
+    MediaInfoCache m_mediaInfoCache;
+    ResampledClipCache m_resampledClips;
+
+    // Every slot's main + monitor ring, sized by getRingBufferSize() (see resizeVoiceRings)
+    VoiceRingSlab m_voiceRings;
+    ma_uint32 m_voiceRingFrames = 0;
+    bool m_voiceRingsStale = false; // config changed while streaming; resized on the next start
+
+    // ------------------------------------------------------------
+    // Command queue (see postCommand)
+    // ------------------------------------------------------------
+    SpscQueue<Command, 64> m_commandQueue;
+    std::mutex m_commandPushMutex; // several producers share the queue's single producer side
+    std::atomic<uint64_t> m_commandsPosted{0};
+    std::atomic<uint64_t> m_commandsDone{0};
+    std::atomic<bool> m_commandThreadQuit{false};
+    std::thread m_commandThread;
 
     // ------------------------------------------------------------
     // Device selections (strings + device-id structs)
@@ -0,0 +1,338 @@
+#include "busMeter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define TALKLESS_BUSMETER_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define TALKLESS_BUSMETER_NEON 1
+#endif
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double kRmsSeconds = 0.3;
+constexpr double kHoldSeconds = 1.5;
+constexpr double kFallDbPerSecond = 20.0;
+
+float lufsFromMeanSquare(double meanSquare)
+{
+    if (meanSquare <= 0.0)
+        return BusMeter::kSilenceLufs;
+    return std::max(BusMeter::kSilenceLufs, (float)(-0.691 + 10.0 * std::log10(meanSquare)));
+}
+
+#if TALKLESS_BUSMETER_SSE
+inline float horizontalMax(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_max_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+
+inline float horizontalSum(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_add_ss(v, _mm_shuffle_ps(v, v, 1)));
+}
+#elif TALKLESS_BUSMETER_NEON
+inline float horizontalMax(float32x4_t v)
+{
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    return vmaxvq_f32(v);
+    #else
+    const float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(m, m), 0);
+    #endif
+}
+
+inline float horizontalSum(float32x4_t v)
+{
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    return vaddvq_f32(v);
+    #else
+    return vgetq_lane_f32(v, 0) + vgetq_lane_f32(v, 1) + vgetq_lane_f32(v, 2) + vgetq_lane_f32(v, 3);
+    #endif
+}
+#endif
+
+// Largest |x| and sum of x^2; two accumulators each so consecutive adds do not wait on each other
+void peakAndSquares(const float* __restrict x, uint32_t n, float& peak, float& squares)
+{
+    uint32_t f = 0;
+    float p = 0.0f;
+    float sq = 0.0f;
+#if TALKLESS_BUSMETER_SSE
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    __m128 p0 = _mm_setzero_ps(), p1 = _mm_setzero_ps();
+    __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps();
+    for (; f + 8 <= n; f += 8) {
+        const __m128 a = _mm_loadu_ps(x + f);
+        const __m128 b = _mm_loadu_ps(x + f + 4);
+        p0 = _mm_max_ps(p0, _mm_andnot_ps(signBit, a));
+        p1 = _mm_max_ps(p1, _mm_andnot_ps(signBit, b));
+        s0 = _mm_add_ps(s0, _mm_mul_ps(a, a));
+        s1 = _mm_add_ps(s1, _mm_mul_ps(b, b));
+    }
+    p = horizontalMax(_mm_max_ps(p0, p1));
+    sq = horizontalSum(_mm_add_ps(s0, s1));
+#elif TALKLESS_BUSMETER_NEON
+    float32x4_t p0 = vdupq_n_f32(0.0f), p1 = vdupq_n_f32(0.0f);
+    float32x4_t s0 = vdupq_n_f32(0.0f), s1 = vdupq_n_f32(0.0f);
+    for (; f + 8 <= n; f += 8) {
+        const float32x4_t a = vld1q_f32(x + f);
+        const float32x4_t b = vld1q_f32(x + f + 4);
+        p0 = vmaxq_f32(p0, vabsq_f32(a));
+        p1 = vmaxq_f32(p1, vabsq_f32(b));
+        s0 = vmlaq_f32(s0, a, a);
+        s1 = vmlaq_f32(s1, b, b);
+    }
+    p = horizontalMax(vmaxq_f32(p0, p1));
+    sq = horizontalSum(vaddq_f32(s0, s1));
+#endif
+    for (; f < n; ++f) {
+        p = std::max(p, std::abs(x[f]));
+        sq += x[f] * x[f];
+    }
+    peak = p;
+    squares = sq;
+}
+
+// Largest |y| of one interpolator phase, y[f] = sum_k h[k] * x[f - k]; x must have taps - 1 samples of history.
+// Frames go four to a register (eight per pass, two registers), taps are the inner loop, so nothing is stored.
+template <uint32_t Taps>
+float phasePeak(const float* __restrict x, const float* __restrict h, uint32_t n)
+{
+    uint32_t f = 0;
+    float peak = 0.0f;
+#if TALKLESS_BUSMETER_SSE
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    __m128 p0 = _mm_setzero_ps(), p1 = _mm_setzero_ps();
+    for (; f + 8 <= n; f += 8) {
+        __m128 y0 = _mm_setzero_ps(), y1 = _mm_setzero_ps();
+        for (uint32_t k = 0; k < Taps; ++k) {
+            const __m128 hk = _mm_set1_ps(h[k]);
+            y0 = _mm_add_ps(y0, _mm_mul_ps(hk, _mm_loadu_ps(x + f - k)));
+            y1 = _mm_add_ps(y1, _mm_mul_ps(hk, _mm_loadu_ps(x + f + 4 - k)));
+        }
+        p0 = _mm_max_ps(p0, _mm_andnot_ps(signBit, y0));
+        p1 = _mm_max_ps(p1, _mm_andnot_ps(signBit, y1));
+    }
+    peak = horizontalMax(_mm_max_ps(p0, p1));
+#elif TALKLESS_BUSMETER_NEON
+    float32x4_t p0 = vdupq_n_f32(0.0f), p1 = vdupq_n_f32(0.0f);
+    for (; f + 8 <= n; f += 8) {
+        float32x4_t y0 = vdupq_n_f32(0.0f), y1 = vdupq_n_f32(0.0f);
+        for (uint32_t k = 0; k < Taps; ++k) {
+            y0 = vmlaq_n_f32(y0, vld1q_f32(x + f - k), h[k]);
+            y1 = vmlaq_n_f32(y1, vld1q_f32(x + f + 4 - k), h[k]);
+        }
+        p0 = vmaxq_f32(p0, vabsq_f32(y0));
+        p1 = vmaxq_f32(p1, vabsq_f32(y1));
+    }
+    peak = horizontalMax(vmaxq_f32(p0, p1));
+#endif
+    for (; f < n; ++f) {
+        float y = 0.0f;
+        for (uint32_t k = 0; k < Taps; ++k)
+            y += h[k] * *(x + f - k);
+        peak = std::max(peak, std::abs(y));
+    }
+    return peak;
+}
+} // namespace
+
+// Held for kHoldSeconds, then falling at kFallDbPerSecond
+void BusMeter::holdPeak(float blockPeak, float& held, uint32_t& holdLeft, uint32_t frames, uint32_t sampleRate)
+{
+    if (blockPeak >= held) {
+        held = blockPeak;
+        holdLeft = (uint32_t)(kHoldSeconds * sampleRate);
+        return;
+    }
+    if (holdLeft > frames) {
+        holdLeft -= frames;
+        return;
+    }
+    holdLeft = 0;
+    const double fallDb = kFallDbPerSecond * frames / sampleRate;
+    held = std::max(blockPeak, held * (float)std::pow(10.0, -fallDb / 20.0));
+}
+
+void BusMeter::reset()
+{
+    m_resetRequested.store(true, std::memory_order_relaxed);
+}
+
+void BusMeter::configure(uint32_t channels, uint32_t sampleRate)
+{
+    m_channels = channels;
+    m_sampleRate = sampleRate;
+
+    // BS.1770 K-weighting at any rate: high shelf (head), then the RLB high-pass
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(kPi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+        m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(kPi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        m_highpass.b0 = 1.0;
+        m_highpass.b1 = -2.0;
+        m_highpass.b2 = 1.0;
+        m_highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+        m_highpass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    // 4x interpolator: Blackman-windowed sinc cut at the input Nyquist, split into phases
+    constexpr uint32_t taps = kOversample * kPhaseTaps;
+    for (uint32_t j = 0; j < taps; ++j) {
+        const double t = ((double)j - (taps - 1) / 2.0) / kOversample;
+        const double sinc = std::abs(t) < 1e-9 ? 1.0 : std::sin(kPi * t) / (kPi * t);
+        const double w = (double)j / (taps - 1);
+        const double window = 0.42 - 0.5 * std::cos(2.0 * kPi * w) + 0.08 * std::cos(4.0 * kPi * w);
+        m_phases[j % kOversample][j / kOversample] = (float)(sinc * window);
+    }
+    // Unity gain at DC for every phase
+    for (auto& phase : m_phases) {
+        float sum = 0.0f;
+        for (float h : phase)
+            sum += h;
+        for (float& h : phase)
+            h /= sum;
+    }
+
+    m_state.assign(channels, ChannelState{});
+    m_history.assign((size_t)channels * (kPhaseTaps - 1 + kChunkFrames), 0.0f);
+    m_subBlockLength = std::max(1u, sampleRate / 10);
+    clear();
+}
+
+void BusMeter::clear()
+{
+    std::fill(m_state.begin(), m_state.end(), ChannelState{});
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_subBlockEnergy = 0.0;
+    m_subBlockFrames = 0;
+    m_blockHead = 0;
+    m_blockCount = 0;
+    m_meanSquare = 0.0;
+    m_peakHold = m_truePeakHold = 0.0f;
+    m_peakHoldLeft = m_truePeakHoldLeft = 0;
+    m_momentaryLufs = m_shortTermLufs = kSilenceLufs;
+}
+
+void BusMeter::process(const float* interleaved, uint32_t frames, uint32_t channels, uint32_t sampleRate)
+{
+    if (!interleaved || frames == 0 || channels == 0 || sampleRate == 0)
+        return;
+    if (channels != m_channels || sampleRate != m_sampleRate)
+        configure(channels, sampleRate);
+    if (m_resetRequested.exchange(false, std::memory_order_relaxed))
+        clear();
+
+    float peak = 0.0f;
+    float truePeak = 0.0f;
+    double sumSquares = 0.0;
+    for (uint32_t done = 0; done < frames;) {
+        // Never run past a sub-block boundary, so loudness windows stay exact
+        const uint32_t n =
+            std::min({frames - done, kChunkFrames, m_subBlockLength - m_subBlockFrames});
+        measureChunk(interleaved + (size_t)done * channels, n, peak, truePeak, sumSquares);
+        done += n;
+        m_subBlockFrames += n;
+        if (m_subBlockFrames == m_subBlockLength)
+            endSubBlock();
+    }
+
+    const double blockMeanSquare = sumSquares / ((double)frames * channels);
+    m_meanSquare += (blockMeanSquare - m_meanSquare) * (1.0 - std::exp(-(double)frames / (kRmsSeconds * sampleRate)));
+    holdPeak(peak, m_peakHold, m_peakHoldLeft, frames, sampleRate);
+    holdPeak(std::max(truePeak, peak), m_truePeakHold, m_truePeakHoldLeft, frames, sampleRate);
+
+    Reading r;
+    r.rms = (float)std::sqrt(m_meanSquare);
+    r.peak = m_peakHold;
+    r.truePeak = m_truePeakHold;
+    r.momentaryLufs = m_momentaryLufs;
+    r.shortTermLufs = m_shortTermLufs;
+    m_published.store(r);
+}
+
+void BusMeter::measureChunk(const float* interleaved, uint32_t frames, float& peak, float& truePeak,
+                            double& sumSquares)
+{
+    constexpr uint32_t past = kPhaseTaps - 1;
+    const size_t stride = past + kChunkFrames;
+
+    for (uint32_t ch = 0; ch < m_channels; ++ch) {
+        float* x = m_history.data() + ch * stride;
+        float* cur = x + past;
+        for (uint32_t f = 0; f < frames; ++f)
+            cur[f] = interleaved[(size_t)f * m_channels + ch];
+
+        float chPeak = 0.0f;
+        float chSquares = 0.0f;
+        peakAndSquares(cur, frames, chPeak, chSquares);
+        peak = std::max(peak, chPeak);
+        sumSquares += chSquares;
+
+        // Polyphase 4x, one pass per phase
+        for (const auto& h : m_phases)
+            truePeak = std::max(truePeak, phasePeak<kPhaseTaps>(cur, h, frames));
+
+        // K-weighting is recursive, so it stays per sample
+        ChannelState& st = m_state[ch];
+        double energy = 0.0;
+        for (uint32_t f = 0; f < frames; ++f) {
+            const double in = cur[f];
+            const double y0 = m_shelf.b0 * in + st.s1[0];
+            st.s1[0] = m_shelf.b1 * in - m_shelf.a1 * y0 + st.s2[0];
+            st.s2[0] = m_shelf.b2 * in - m_shelf.a2 * y0;
+            const double y1 = m_highpass.b0 * y0 + st.s1[1];
+            st.s1[1] = m_highpass.b1 * y0 - m_highpass.a1 * y1 + st.s2[1];
+            st.s2[1] = m_highpass.b2 * y0 - m_highpass.a2 * y1;
+            energy += y1 * y1;
+        }
+        m_subBlockEnergy += energy;
+
+        // Keep the tail as the next chunk's filter history
+        std::copy(cur + frames - past, cur + frames, x);
+    }
+}
+
+void BusMeter::endSubBlock()
+{
+    m_blocks[m_blockHead] = m_subBlockEnergy / m_subBlockLength;
+    m_blockHead = (m_blockHead + 1) % kShortTermBlocks;
+    m_blockCount = std::min(m_blockCount + 1, kShortTermBlocks);
+    m_subBlockEnergy = 0.0;
+    m_subBlockFrames = 0;
+
+    // Windows that have not filled yet average what there is
+    double momentary = 0.0;
+    double shortTerm = 0.0;
+    for (int i = 0; i < m_blockCount; ++i) {
+        const double e = m_blocks[(m_blockHead - 1 - i + kShortTermBlocks) % kShortTermBlocks];
+        shortTerm += e;
+        if (i < kMomentaryBlocks)
+            momentary += e;
+    }
+    m_momentaryLufs = lufsFromMeanSquare(momentary / std::min(m_blockCount, kMomentaryBlocks));
+    m_shortTermLufs = lufsFromMeanSquare(shortTerm / m_blockCount);
+}
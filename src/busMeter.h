@@ -0,0 +1,96 @@
+#pragma once
+
+#include "seqlock.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Level meter for one audio bus: RMS, peak-hold, true peak and loudness
+ *
+ * process() is called once per block by the callback that owns the bus
+ * (single writer). It measures the block in planar chunks: sample peak, sum
+ * of squares and the true-peak interpolator are written with SSE / NEON
+ * (scalar elsewhere); only the K-weighting filters run sample by sample. The
+ * result is published through a Seqlock at the end of every block, so
+ * reading() from any thread always sees one consistent set.
+ *
+ * True peak is taken on a 4x-oversampled copy (48-tap polyphase interpolator)
+ * as BS.1770 describes. Loudness is K-weighted mean square over 100 ms
+ * sub-blocks, ungated: momentary over the last 400 ms, short-term over 3 s.
+ * All channels are weighted equally.
+ */
+class BusMeter
+{
+public:
+    static constexpr float kSilenceLufs = -70.0f;
+
+    struct Reading
+    {
+        float rms = 0.0f;      // linear, ~300 ms integration
+        float peak = 0.0f;     // linear sample peak, held 1.5 s then falling 20 dB/s
+        float truePeak = 0.0f; // linear inter-sample peak, same ballistics
+        float momentaryLufs = kSilenceLufs;
+        float shortTermLufs = kSilenceLufs;
+    };
+
+    // Audio thread only. Reconfigures itself (allocating once) when the format changes.
+    void process(const float* interleaved, uint32_t frames, uint32_t channels, uint32_t sampleRate);
+
+    Reading reading() const { return m_published.load(); }
+    void reset(); // applied by the next process()
+
+    // Peak ballistics of Reading::peak, for meters that keep their own state (per-voice meters)
+    static void holdPeak(float blockPeak, float& held, uint32_t& holdLeft, uint32_t frames, uint32_t sampleRate);
+
+private:
+    static constexpr uint32_t kChunkFrames = 256;
+    static constexpr uint32_t kOversample = 4;
+    static constexpr uint32_t kPhaseTaps = 12;
+    static constexpr int kShortTermBlocks = 30; // 3 s of 100 ms sub-blocks
+    static constexpr int kMomentaryBlocks = 4;  // 400 ms
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+    struct ChannelState
+    {
+        double s1[2] = {0.0, 0.0}; // transposed direct form II, one pair per K-weighting stage
+        double s2[2] = {0.0, 0.0};
+    };
+
+    void configure(uint32_t channels, uint32_t sampleRate);
+    void clear();
+    void measureChunk(const float* interleaved, uint32_t frames, float& peak, float& truePeak, double& sumSquares);
+    void endSubBlock();
+
+    uint32_t m_channels = 0;
+    uint32_t m_sampleRate = 0;
+    Biquad m_shelf;
+    Biquad m_highpass;
+    std::vector<ChannelState> m_state;
+    std::vector<float> m_history; // per channel: last kPhaseTaps - 1 samples, then the current chunk
+    float m_phases[kOversample][kPhaseTaps] = {};
+
+    // Loudness
+    double m_subBlockEnergy = 0.0; // K-weighted sum of squares, all channels
+    uint32_t m_subBlockFrames = 0;
+    uint32_t m_subBlockLength = 0;
+    double m_blocks[kShortTermBlocks] = {};
+    int m_blockHead = 0;
+    int m_blockCount = 0;
+
+    // Ballistics
+    double m_meanSquare = 0.0;
+    float m_peakHold = 0.0f;
+    float m_truePeakHold = 0.0f;
+    uint32_t m_peakHoldLeft = 0;
+    uint32_t m_truePeakHoldLeft = 0;
+    float m_momentaryLufs = kSilenceLufs;
+    float m_shortTermLufs = kSilenceLufs;
+
+    std::atomic<bool> m_resetRequested{false};
+    Seqlock<Reading> m_published;
+};
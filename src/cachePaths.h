@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+/**
+ * @brief Path helpers shared by the on-disk caches
+ *
+ * The engine carries file paths as UTF-8 std::string; these convert to and
+ * from std::filesystem::path without going through the narrow locale, and
+ * name a cache entry after its source file.
+ */
+inline std::filesystem::path pathFromUtf8(const std::string& utf8)
+{
+    return std::filesystem::path(std::u8string(reinterpret_cast<const char8_t*>(utf8.data()), utf8.size()));
+}
+
+inline std::string utf8FromPath(const std::filesystem::path& path)
+{
+    const std::u8string u8 = path.u8string();
+    return std::string(reinterpret_cast<const char*>(u8.data()), u8.size());
+}
+
+// FNV-1a of the path as 16 hex digits: stable across runs, so sidecar files are found again
+inline std::string pathHash(const std::string& path)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : path) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)hash);
+    return buf;
+}
@@ -0,0 +1,74 @@
+#include "callbackProfiler.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+uint32_t clampNs(int64_t ns)
+{
+    return (uint32_t)std::clamp<int64_t>(ns, 0, std::numeric_limits<uint32_t>::max());
+}
+} // namespace
+
+void CallbackProfiler::record(int64_t elapsedNs, uint32_t frames, uint32_t sampleRate)
+{
+    if (m_resetRequested.load(std::memory_order_relaxed)) {
+        m_resetRequested.store(false, std::memory_order_relaxed);
+        m_blocks.store(0, std::memory_order_relaxed);
+        m_deadlineMisses.store(0, std::memory_order_relaxed);
+        m_avgNs.store(0, std::memory_order_relaxed);
+        m_worstCurrentNs.store(0, std::memory_order_relaxed);
+        m_worstPreviousNs.store(0, std::memory_order_relaxed);
+        m_windowNs = 0;
+    }
+
+    const uint32_t ns = clampNs(elapsedNs);
+    const int64_t periodNs = sampleRate > 0 ? (int64_t)frames * 1000000000 / sampleRate : 0;
+
+    m_lastNs.store(ns, std::memory_order_relaxed);
+    m_periodNs.store(clampNs(periodNs), std::memory_order_relaxed);
+
+    // Seed the average with the first block so it does not ramp up from zero
+    const uint64_t blocks = m_blocks.load(std::memory_order_relaxed);
+    const uint32_t avg = m_avgNs.load(std::memory_order_relaxed);
+    const int64_t nextAvg = blocks == 0 ? ns : (int64_t)avg + (((int64_t)ns - (int64_t)avg) >> kAvgShift);
+    m_avgNs.store(clampNs(nextAvg), std::memory_order_relaxed);
+    m_blocks.store(blocks + 1, std::memory_order_relaxed);
+
+    if (periodNs > 0 && ns > periodNs)
+        m_deadlineMisses.store(m_deadlineMisses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (ns > m_worstCurrentNs.load(std::memory_order_relaxed))
+        m_worstCurrentNs.store(ns, std::memory_order_relaxed);
+
+    m_windowNs += periodNs;
+    if (m_windowNs >= kHalfWindowNs) {
+        m_windowNs = 0;
+        m_worstPreviousNs.store(m_worstCurrentNs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_worstCurrentNs.store(0, std::memory_order_relaxed);
+    }
+}
+
+CallbackProfiler::Snapshot CallbackProfiler::snapshot() const
+{
+    Snapshot s;
+    s.blocks = m_blocks.load(std::memory_order_relaxed);
+    s.deadlineMisses = m_deadlineMisses.load(std::memory_order_relaxed);
+    s.periodUs = m_periodNs.load(std::memory_order_relaxed) / 1000.0;
+    s.lastUs = m_lastNs.load(std::memory_order_relaxed) / 1000.0;
+    s.avgUs = m_avgNs.load(std::memory_order_relaxed) / 1000.0;
+    s.worstUs = std::max(m_worstCurrentNs.load(std::memory_order_relaxed),
+                         m_worstPreviousNs.load(std::memory_order_relaxed)) /
+                1000.0;
+    if (s.periodUs > 0.0) {
+        s.avgLoad = s.avgUs / s.periodUs;
+        s.worstLoad = s.worstUs / s.periodUs;
+    }
+    return s;
+}
+
+void CallbackProfiler::reset()
+{
+    m_resetRequested.store(true, std::memory_order_relaxed);
+}
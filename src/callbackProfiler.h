@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Per-block timing for one audio device callback
+ *
+ * record() is called once per block from the callback that owns the profiler
+ * (single writer) and only touches relaxed atomics, so it never blocks the
+ * audio thread. Any thread may take a snapshot() or request a reset().
+ *
+ * The worst case covers a sliding window of one to two seconds of audio:
+ * two half-windows are kept and the older one is dropped every second.
+ */
+class CallbackProfiler
+{
+public:
+    struct Snapshot
+    {
+        uint64_t blocks = 0;
+        uint64_t deadlineMisses = 0; // blocks that took longer than their own period
+        double periodUs = 0.0;       // audio duration of the last block
+        double lastUs = 0.0;
+        double avgUs = 0.0; // moving average over ~64 blocks
+        double worstUs = 0.0;
+        double avgLoad = 0.0; // avgUs / periodUs; 1.0 = the whole deadline
+        double worstLoad = 0.0;
+    };
+
+    // Audio thread only
+    void record(int64_t elapsedNs, uint32_t frames, uint32_t sampleRate);
+
+    Snapshot snapshot() const;
+    void reset(); // applied by the next record()
+
+private:
+    static constexpr int64_t kHalfWindowNs = 1000000000; // 1 s of audio
+    static constexpr int kAvgShift = 6;                  // EMA weight 1/64
+
+    std::atomic<uint64_t> m_blocks{0};
+    std::atomic<uint64_t> m_deadlineMisses{0};
+    std::atomic<uint32_t> m_periodNs{0};
+    std::atomic<uint32_t> m_lastNs{0};
+    std::atomic<uint32_t> m_avgNs{0};
+    std::atomic<uint32_t> m_worstCurrentNs{0};
+    std::atomic<uint32_t> m_worstPreviousNs{0};
+    std::atomic<bool> m_resetRequested{false};
+
+    int64_t m_windowNs = 0; // audio time in the current half-window (writer only)
+};
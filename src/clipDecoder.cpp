@@ -0,0 +1,316 @@
+#include "clipDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <windows.h>
+
+static std::wstring utf8ToWideClip(const std::string& utf8)
+{
+    if (utf8.empty())
+        return std::wstring();
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, nullptr, 0);
+    if (wlen <= 0)
+        return std::wstring();
+    std::wstring wstr(wlen, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), -1, &wstr[0], wlen);
+    if (!wstr.empty() && wstr.back() == L'\0')
+        wstr.pop_back();
+    return wstr;
+}
+#endif
+
+namespace
+{
+// Frames decoded at the file's rate per refill of the resampler's input
+constexpr size_t kResampleChunkFrames = 1024;
+} // namespace
+
+ClipDecoder::~ClipDecoder()
+{
+    close();
+}
+
+bool ClipDecoder::open(const std::string& filePath, uint32_t outputSampleRate, uint32_t outputChannels,
+                       DecoderBackend preferred)
+{
+    close();
+
+    if (preferred == DecoderBackend::Unknown)
+        preferred = defaultBackendFor(filePath);
+    const DecoderBackend fallback =
+        preferred == DecoderBackend::FFmpeg ? DecoderBackend::Miniaudio : DecoderBackend::FFmpeg;
+
+    if (openWith(preferred, filePath, outputSampleRate, outputChannels))
+        return true;
+
+    // Wrong guess for this file (Opus in .ogg, an odd WAV codec, ...) - try the other one
+    auto name = [](DecoderBackend b) { return b == DecoderBackend::FFmpeg ? "FFmpeg" : "miniaudio"; };
+    std::cout << "[ClipDecoder] " << name(preferred) << " failed for: " << filePath << ", trying " << name(fallback)
+              << "...\n";
+    if (openWith(fallback, filePath, outputSampleRate, outputChannels))
+        return true;
+
+    std::cerr << "[ClipDecoder] Both miniaudio and FFmpeg failed for: " << filePath << "\n";
+    return false;
+}
+
+DecoderBackend ClipDecoder::defaultBackendFor(const std::string& filePath)
+{
+    // miniaudio opens these without format probing and decodes them at least as fast as
+    // libavcodec (talkless_decoder_bench); everything else is FFmpeg territory.
+    const std::string ext = MediaInfoCache::fileExtension(filePath);
+    if (ext == "wav" || ext == "flac" || ext == "mp3" || ext == "ogg")
+        return DecoderBackend::Miniaudio;
+
+#if defined(TALKLESS_HAS_FFMPEG) && TALKLESS_HAS_FFMPEG
+    return DecoderBackend::FFmpeg;
+#else
+    return DecoderBackend::Miniaudio;
+#endif
+}
+
+bool ClipDecoder::openWith(DecoderBackend backend, const std::string& filePath, uint32_t outputSampleRate,
+                           uint32_t outputChannels)
+{
+    if (backend == DecoderBackend::FFmpeg)
+        return openFFmpeg(filePath, outputSampleRate, outputChannels);
+    return openMiniaudio(filePath, outputSampleRate, outputChannels);
+}
+
+bool ClipDecoder::openMiniaudio(const std::string& filePath, uint32_t outputSampleRate, uint32_t outputChannels)
+{
+    // Native rate out of miniaudio (its built-in converter is linear only); m_resampler does the rest
+    ma_decoder_config cfg = ma_decoder_config_init(ma_format_f32, outputChannels, 0);
+
+    // Decode straight out of the shared mapping; plain file I/O only if the file can't be mapped
+    m_mapping = MappedFile::acquire(filePath);
+    if (m_mapping) {
+        if (ma_decoder_init_memory(m_mapping->data(), m_mapping->size(), &cfg, &m_maDecoder) != MA_SUCCESS) {
+            m_mapping.reset();
+            return false;
+        }
+    } else {
+#ifdef _WIN32
+        std::wstring wpath = utf8ToWideClip(filePath);
+        if (ma_decoder_init_file_w(wpath.c_str(), &cfg, &m_maDecoder) != MA_SUCCESS)
+            return false;
+#else
+        if (ma_decoder_init_file(filePath.c_str(), &cfg, &m_maDecoder) != MA_SUCCESS)
+            return false;
+#endif
+    }
+
+    m_backend = DecoderBackend::Miniaudio;
+    m_sampleRate = m_maDecoder.outputSampleRate;
+    m_channels = m_maDecoder.outputChannels;
+    m_codec = MediaInfoCache::fileExtension(filePath);
+
+    if (outputSampleRate != 0 && outputSampleRate != m_sampleRate &&
+        m_resampler.init(m_channels, m_sampleRate, outputSampleRate, m_resamplerQuality)) {
+        m_resampling = true;
+        m_resampleInput.resize(kResampleChunkFrames * m_channels);
+        m_resampleInputPos = 0;
+        m_resampleInputFrames = 0;
+        m_flushFrames = m_resampler.inputLookahead();
+        m_sourceEnded = false;
+        m_outputCursor = 0;
+        m_sampleRate = outputSampleRate;
+    }
+    return true;
+}
+
+bool ClipDecoder::openFFmpeg(const std::string& filePath, uint32_t outputSampleRate, uint32_t outputChannels)
+{
+    if (!m_ffmpeg.open(filePath, outputSampleRate, outputChannels))
+        return false;
+
+    m_backend = DecoderBackend::FFmpeg;
+    m_sampleRate = m_ffmpeg.getSampleRate();
+    m_channels = m_ffmpeg.getChannels();
+    m_codec = m_ffmpeg.getCodecName();
+    return true;
+}
+
+void ClipDecoder::close()
+{
+    if (m_backend == DecoderBackend::Miniaudio) {
+        ma_decoder_uninit(&m_maDecoder);
+    } else if (m_backend == DecoderBackend::FFmpeg) {
+        m_ffmpeg.close();
+    }
+    m_mapping.reset();
+    m_resampling = false;
+    m_backend = DecoderBackend::Unknown;
+    m_seekIndex.reset();
+    m_sampleRate = 0;
+    m_channels = 0;
+    m_codec.clear();
+}
+
+ma_result ClipDecoder::readPcmFrames(float* out, uint64_t frameCount, uint64_t* framesRead)
+{
+    if (framesRead)
+        *framesRead = 0;
+
+    if (m_backend == DecoderBackend::Miniaudio && m_resampling)
+        return readResampled(out, frameCount, framesRead);
+
+    if (m_backend == DecoderBackend::Miniaudio) {
+        ma_uint64 read = 0;
+        ma_result result = ma_decoder_read_pcm_frames(&m_maDecoder, out, frameCount, &read);
+        if (framesRead)
+            *framesRead = read;
+        return result;
+    }
+
+    if (m_backend == DecoderBackend::FFmpeg) {
+        const uint64_t read = m_ffmpeg.readPcmFrames(out, frameCount);
+        if (framesRead)
+            *framesRead = read;
+        return read > 0 ? MA_SUCCESS : MA_AT_END;
+    }
+
+    return MA_INVALID_OPERATION;
+}
+
+ma_result ClipDecoder::readResampled(float* out, uint64_t frameCount, uint64_t* framesRead)
+{
+    uint64_t total = 0;
+    while (total < frameCount) {
+        if (m_resampleInputPos == m_resampleInputFrames) {
+            m_resampleInputPos = 0;
+            m_resampleInputFrames = 0;
+            if (!m_sourceEnded) {
+                ma_uint64 read = 0;
+                const ma_result result =
+                    ma_decoder_read_pcm_frames(&m_maDecoder, m_resampleInput.data(), kResampleChunkFrames, &read);
+                m_resampleInputFrames = (size_t)read;
+                if (read == 0 || (result != MA_SUCCESS && result != MA_AT_END))
+                    m_sourceEnded = true;
+            }
+            if (m_sourceEnded && m_resampleInputFrames == 0) {
+                // Push the filter's lookahead through so the last input frames come out too
+                if (m_flushFrames == 0)
+                    break;
+                m_resampleInputFrames = std::min(m_flushFrames, kResampleChunkFrames);
+                m_flushFrames -= m_resampleInputFrames;
+                std::memset(m_resampleInput.data(), 0, m_resampleInputFrames * m_channels * sizeof(float));
+            }
+        }
+
+        size_t inFrames = m_resampleInputFrames - m_resampleInputPos;
+        size_t outFrames = (size_t)std::min<uint64_t>(frameCount - total, kResampleChunkFrames * 8);
+        m_resampler.process(m_resampleInput.data() + m_resampleInputPos * m_channels, inFrames,
+                            out + total * m_channels, outFrames);
+        m_resampleInputPos += inFrames;
+        total += outFrames;
+    }
+
+    m_outputCursor += total;
+    if (framesRead)
+        *framesRead = total;
+    return total > 0 ? MA_SUCCESS : MA_AT_END;
+}
+
+bool ClipDecoder::seekToPcmFrame(uint64_t frameIndex)
+{
+    if (m_backend == DecoderBackend::Miniaudio && m_resampling) {
+        // Output frame -> exact input position, then replay enough history to fill the filter
+        const uint64_t inputTime = frameIndex * m_resampler.phaseStep();
+        const uint64_t inputFrame = inputTime / m_resampler.phaseCount();
+        const uint32_t phase = (uint32_t)(inputTime % m_resampler.phaseCount());
+        const uint64_t history = std::min<uint64_t>(inputFrame, m_resampler.inputLookahead() - 1);
+        if (ma_decoder_seek_to_pcm_frame(&m_maDecoder, inputFrame - history) != MA_SUCCESS)
+            return false;
+        m_resampler.reset((size_t)history, phase);
+        m_resampleInputPos = 0;
+        m_resampleInputFrames = 0;
+        m_flushFrames = m_resampler.inputLookahead();
+        m_sourceEnded = false;
+        m_outputCursor = frameIndex;
+        return true;
+    }
+    if (m_backend == DecoderBackend::Miniaudio)
+        return ma_decoder_seek_to_pcm_frame(&m_maDecoder, frameIndex) == MA_SUCCESS;
+    if (m_backend == DecoderBackend::FFmpeg)
+        return m_ffmpeg.seekToPcmFrame(frameIndex);
+    return false;
+}
+
+uint64_t ClipDecoder::getCursorInPcmFrames()
+{
+    if (m_backend == DecoderBackend::Miniaudio && m_resampling)
+        return m_outputCursor;
+    if (m_backend == DecoderBackend::Miniaudio) {
+        ma_uint64 cursor = 0;
+        ma_decoder_get_cursor_in_pcm_frames(&m_maDecoder, &cursor);
+        return cursor;
+    }
+    if (m_backend == DecoderBackend::FFmpeg)
+        return m_ffmpeg.getCursorInPcmFrames();
+    return 0;
+}
+
+uint64_t ClipDecoder::getLengthInPcmFrames()
+{
+    if (m_backend == DecoderBackend::Miniaudio) {
+        const uint64_t length = nativeLengthInPcmFrames();
+        return m_resampling ? m_resampler.outputFramesFor(length) : length;
+    }
+    if (m_backend == DecoderBackend::FFmpeg)
+        return m_ffmpeg.getLengthInPcmFrames();
+    return 0;
+}
+
+uint64_t ClipDecoder::nativeLengthInPcmFrames()
+{
+    ma_uint64 length = 0;
+    if (ma_decoder_get_length_in_pcm_frames(&m_maDecoder, &length) != MA_SUCCESS)
+        return 0;
+    return length;
+}
+
+bool ClipDecoder::buildSeekIndex(SeekIndex& out)
+{
+    out = SeekIndex();
+
+    if (m_backend == DecoderBackend::Miniaudio) {
+        // WAV/FLAC seek directly; only MP3 has to scan frame headers
+        if (m_codec != "mp3")
+            return false;
+        // One point every ~0.5 s of audio
+        const uint64_t length = nativeLengthInPcmFrames();
+        const uint64_t spacing = std::max<uint64_t>(1, m_maDecoder.outputSampleRate / 2);
+        const uint32_t pointCount = (uint32_t)std::clamp<uint64_t>(length / spacing, 1, 1u << 16);
+        const bool built = buildMp3SeekIndex(&m_maDecoder, pointCount, out);
+        if (m_resampling)
+            seekToPcmFrame(0);
+        return built;
+    }
+
+    if (m_backend == DecoderBackend::FFmpeg) {
+        // Uncompressed PCM is seekable by arithmetic already
+        if (m_codec.rfind("pcm_", 0) == 0)
+            return false;
+        return m_ffmpeg.buildSeekIndex(out);
+    }
+
+    return false;
+}
+
+void ClipDecoder::setSeekIndex(std::shared_ptr<const SeekIndex> index)
+{
+    if (!index || index->empty())
+        return;
+
+    if (m_backend == DecoderBackend::Miniaudio && index->kind == SeekIndex::Kind::Mp3SeekPoints) {
+        if (bindMp3SeekIndex(&m_maDecoder, *index))
+            m_seekIndex = std::move(index);
+    } else if (m_backend == DecoderBackend::FFmpeg && index->kind == SeekIndex::Kind::PacketTable) {
+        m_ffmpeg.setSeekIndex(index);
+        m_seekIndex = std::move(index);
+    }
+}
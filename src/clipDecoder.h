@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ffmpeg_decoder.h"
+#include "mappedFile.h"
+#include "mediaInfoCache.h"
+#include "miniaudio.h"
+#include "resampler.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One decoder interface over miniaudio and FFmpeg
+ *
+ * Output is interleaved float32. An output rate/channel count of 0 keeps the
+ * file's native format. With a preferred backend the other one is only tried
+ * as a fallback; backend() reports which one actually opened the file.
+ * Without one, defaultBackendFor() picks the first attempt by container.
+ *
+ * miniaudio decodes at the file's rate and a Resampler converts to the output
+ * rate at the quality set beforehand. FFmpeg output goes through swresample.
+ */
+class ClipDecoder
+{
+public:
+    ClipDecoder() = default;
+    ~ClipDecoder();
+
+    ClipDecoder(const ClipDecoder&) = delete;
+    ClipDecoder& operator=(const ClipDecoder&) = delete;
+
+    bool open(const std::string& filePath, uint32_t outputSampleRate, uint32_t outputChannels,
+              DecoderBackend preferred = DecoderBackend::Unknown);
+    void close();
+    bool isOpen() const { return m_backend != DecoderBackend::Unknown; }
+
+    // Used by the next open() when the file's rate differs from the output rate
+    void setResamplerQuality(ResamplerQuality quality) { m_resamplerQuality = quality; }
+
+    // Same contract as ma_decoder_read_pcm_frames (MA_AT_END once nothing is left)
+    ma_result readPcmFrames(float* out, uint64_t frameCount, uint64_t* framesRead);
+    bool seekToPcmFrame(uint64_t frameIndex);
+    uint64_t getCursorInPcmFrames();
+    uint64_t getLengthInPcmFrames();
+
+    // Build a seek index for the open file (MP3 via miniaudio, compressed formats via FFmpeg).
+    // Leaves the cursor at the start. Returns false if the format doesn't benefit from one.
+    bool buildSeekIndex(SeekIndex& out);
+    // Attach an index built earlier for the same file; used by all following seeks
+    void setSeekIndex(std::shared_ptr<const SeekIndex> index);
+
+    uint32_t getSampleRate() const { return m_sampleRate; }
+    uint32_t getChannels() const { return m_channels; }
+    DecoderBackend backend() const { return m_backend; }
+    const std::string& codecName() const { return m_codec; }
+
+    // First backend to try for a file with no decode history (see bench/decoderBench.cpp)
+    static DecoderBackend defaultBackendFor(const std::string& filePath);
+
+private:
+    bool openMiniaudio(const std::string& filePath, uint32_t outputSampleRate, uint32_t outputChannels);
+    bool openFFmpeg(const std::string& filePath, uint32_t outputSampleRate, uint32_t outputChannels);
+    bool openWith(DecoderBackend backend, const std::string& filePath, uint32_t outputSampleRate,
+                  uint32_t outputChannels);
+    ma_result readResampled(float* out, uint64_t frameCount, uint64_t* framesRead);
+    uint64_t nativeLengthInPcmFrames();
+
+    ma_decoder m_maDecoder{};
+    std::shared_ptr<const MappedFile> m_mapping; // backs m_maDecoder when the file could be mapped
+    FFmpegDecoder m_ffmpeg;
+    std::shared_ptr<const SeekIndex> m_seekIndex;
+
+    // miniaudio path when the output rate differs from the file's
+    ResamplerQuality m_resamplerQuality = ResamplerQuality::Sinc32;
+    Resampler m_resampler;
+    bool m_resampling = false;
+    std::vector<float> m_resampleInput; // decoded frames at the file's rate, not yet consumed
+    size_t m_resampleInputPos = 0;
+    size_t m_resampleInputFrames = 0;
+    size_t m_flushFrames = 0; // zero frames still owed to the resampler once the file ends
+    bool m_sourceEnded = false;
+    uint64_t m_outputCursor = 0;
+
+    DecoderBackend m_backend = DecoderBackend::Unknown;
+    uint32_t m_sampleRate = 0;
+    uint32_t m_channels = 0;
+    std::string m_codec;
+};
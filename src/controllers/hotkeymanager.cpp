@@ -1,6 +1,7 @@
 #include "hotkeymanager.h"
 #include "hotkeyvalidator.h"
 #include "services/soundboardService.h"
+#include "latencyHistogram.h"
 #include <QHotkey>
 #include <QDebug>
 
@@ -22,6 +23,8 @@ void HotkeyManager::setSoundboardService(SoundboardService* service) {
         // Reload soundboard hotkeys when boards change
         connect(m_soundboardService, &SoundboardService::boardsChanged,
                 this, &HotkeyManager::reloadSoundboardHotkeys);
+        connect(m_soundboardService, &SoundboardService::macrosChanged,
+                this, &HotkeyManager::reloadSoundboardHotkeys);
         
         // Reload clip hotkeys when active board changes
         connect(m_soundboardService, &SoundboardService::activeBoardChanged,
@@ -55,6 +58,19 @@ void HotkeyManager::reloadSoundboardHotkeys() {
         item.enabled = true;
         pref.push_back(item);
     }
+
+    const auto macros = m_soundboardService->listMacros();
+    for (const auto& macro : macros) {
+        HotkeyItem item;
+        item.id = kMacroItemIdBase + macro.id;  // Keep clear of board IDs
+        item.title = QString("Macro: %1").arg(macro.name);
+        item.hotkey = macro.hotkey;
+        item.defaultHotkey = "";
+        item.actionId = QString("macro.%1").arg(macro.id);
+        item.isSystem = false;
+        item.enabled = true;
+        pref.push_back(item);
+    }
     
     m_pref.setItems(pref);
     m_nextPrefId = 1000;  // Soundboards use their own IDs
@@ -81,7 +97,8 @@ void HotkeyManager::reloadClipHotkeys() {
             if (portable.isEmpty()) continue;
             
             // Create action ID for clip
-            QString actionId = QString("clip.%1").arg(clip.id);
+            const int clipId = clip.id;
+            QString actionId = QString("clip.%1").arg(clipId);
             
             // Check if already registered in system/board hotkeys (avoid overrides)
             if (m_registered.contains(portable)) {
@@ -95,7 +112,11 @@ void HotkeyManager::reloadClipHotkeys() {
             // Register the hotkey
             QHotkey* hk = new QHotkey(QKeySequence(portable), true, this);
             if (hk->isRegistered()) {
-                connect(hk, &QHotkey::activated, this, [this, actionId]() {
+                connect(hk, &QHotkey::activated, this, [this, actionId, clipId]() {
+                    const qint64 pressNs = latencyClockNs();
+                    // Straight into the engine when the clip is loaded; full action chain otherwise
+                    if (m_soundboardService && m_soundboardService->triggerClipFast(clipId, pressNs)) return;
+                    if (m_soundboardService) m_soundboardService->noteHotkeyPressed(pressNs);
                     emit actionTriggered(actionId);
                 });
                 m_clipRegistered[portable] = hk;
@@ -127,16 +148,10 @@ void HotkeyManager::saveHotkeysOnClose() {
     // Save system hotkeys to QSettings
     saveUserSettings();
     
-    // Save soundboard hotkeys directly (without emitting signals that trigger reload)
+    // Save soundboard and macro hotkeys directly (without emitting signals that trigger reload)
     if (m_soundboardService) {
         for (const auto& item : m_pref.items()) {
-            if (item.actionId.startsWith("board.")) {
-                bool ok;
-                int boardId = item.actionId.mid(6).toInt(&ok);
-                if (ok) {
-                    m_soundboardService->setBoardHotkey(boardId, item.hotkey);
-                }
-            }
+            storePreferenceHotkey(item.actionId, item.hotkey);
         }
     }
     
@@ -287,6 +302,7 @@ void HotkeyManager::rebuildRegistrations() {
         m_registered.insert(portable, hk);
 
         connect(hk, &QHotkey::activated, this, [this, it]() {
+            if (m_soundboardService) m_soundboardService->noteHotkeyPressed(latencyClockNs());
             emit actionTriggered(it.actionId);
         });
     };
@@ -356,14 +372,39 @@ void HotkeyManager::reassignPreference(int id) {
 }
 
 void HotkeyManager::deletePreference(int id) {
+    const auto* item = m_pref.findById(id);
+    const bool isMacro = item && item->actionId.startsWith("macro.");
+
     // Clear the hotkey in soundboard service first
     if (m_soundboardService) {
-        m_soundboardService->setBoardHotkey(id, "");
+        if (isMacro) {
+            storePreferenceHotkey(item->actionId, "");
+        } else {
+            m_soundboardService->setBoardHotkey(id, "");
+        }
     }
     
-    // The model will be refreshed when boardsChanged is emitted
+    // The model will be refreshed when boardsChanged/macrosChanged is emitted
     rebuildRegistrations();
-    emit showMessage("Soundboard hotkey deleted.");
+    emit showMessage(isMacro ? "Macro hotkey deleted." : "Soundboard hotkey deleted.");
+}
+
+void HotkeyManager::storePreferenceHotkey(const QString& actionId, const QString& hotkey) {
+    if (!m_soundboardService) return;
+
+    // actionId format: "board.123" / "macro.7"
+    bool ok = false;
+    if (actionId.startsWith("board.")) {
+        int boardId = actionId.mid(6).toInt(&ok);
+        if (ok) {
+            m_soundboardService->setBoardHotkey(boardId, hotkey);
+        }
+    } else if (actionId.startsWith("macro.")) {
+        int macroId = actionId.mid(6).toInt(&ok);
+        if (ok) {
+            m_soundboardService->setMacroHotkey(macroId, hotkey);
+        }
+    }
 }
 
 void HotkeyManager::undoHotkeyChanges() {
@@ -379,14 +420,7 @@ void HotkeyManager::saveHotkeys() {
     // Also save preference hotkeys to soundboard service
     if (m_soundboardService) {
         for (const auto& item : m_pref.items()) {
-            // Extract board ID from actionId (format: "board.123")
-            if (item.actionId.startsWith("board.")) {
-                bool ok;
-                int boardId = item.actionId.mid(6).toInt(&ok);
-                if (ok) {
-                    m_soundboardService->setBoardHotkey(boardId, item.hotkey);
-                }
-            }
+            storePreferenceHotkey(item.actionId, item.hotkey);
         }
     }
     
@@ -445,15 +479,11 @@ void HotkeyManager::applyCapturedHotkey(const QString& hotkeyText) {
     } else if (m_target == CaptureTarget::Preference) {
         m_pref.setHotkeyById(m_targetId, hotkeyText);
         
-        // For preference hotkeys (soundboards), also save to service immediately
+        // For preference hotkeys (soundboards, macros), also save to service immediately
         if (m_soundboardService) {
             const auto* item = m_pref.findById(m_targetId);
-            if (item && item->actionId.startsWith("board.")) {
-                bool ok;
-                int boardId = item->actionId.mid(6).toInt(&ok);
-                if (ok) {
-                    m_soundboardService->setBoardHotkey(boardId, hotkeyText);
-                }
+            if (item) {
+                storePreferenceHotkey(item->actionId, hotkeyText);
             }
         }
     } else if (m_target == CaptureTarget::Clip) {
@@ -494,6 +524,12 @@ void HotkeyManager::resetAllHotkeys() {
         for (const auto& board : boards) {
             m_soundboardService->setBoardHotkey(board.id, "");
         }
+
+        // Clear macro hotkeys
+        const auto macros = m_soundboardService->listMacros();
+        for (const auto& macro : macros) {
+            m_soundboardService->setMacroHotkey(macro.id, "");
+        }
         
         // Clear clip hotkeys for all boards
         // We'll need a method in SoundboardService for this or loop through boards
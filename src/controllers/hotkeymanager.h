@@ -90,6 +90,9 @@ private:
 
     // Id generator for preference hotkeys
     int m_nextPrefId = 1000;
+
+    // Macro preference items use kMacroItemIdBase + macro id
+    static constexpr int kMacroItemIdBase = 100000;
     
     // Soundboard service reference
     QPointer<SoundboardService> m_soundboardService;
@@ -110,6 +113,9 @@ private:
     void reloadClipHotkeys();
     void clearClipRegistrations();
 
+    // Persist a "board.<id>" / "macro.<id>" hotkey through the soundboard service
+    void storePreferenceHotkey(const QString& actionId, const QString& hotkey);
+
     bool isValidHotkey(const QString& text) const;
     bool hasConflictPortable(const QString& portableKey, int ignoreId, CaptureTarget ignoreTarget, QString* conflictTitle) const;
 
@@ -15,6 +15,7 @@ extern "C" {
 }
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
 
@@ -31,12 +32,43 @@ static std::wstring utf8ToWideFFmpeg(const std::string& utf8) {
 }
 #endif
 
+// Bytes FFmpeg pulls from the mapping per read; the copy stays in cache
+static constexpr int kMappedIoBufferSize = 64 * 1024;
+
 FFmpegDecoder::FFmpegDecoder() = default;
 
 FFmpegDecoder::~FFmpegDecoder() {
     close();
 }
 
+int FFmpegDecoder::readMapped(void* opaque, uint8_t* buf, int bufSize) {
+    auto* self = static_cast<FFmpegDecoder*>(opaque);
+    const int64_t size = (int64_t)self->m_mapping->size();
+    if (self->m_mappedPos >= size) return AVERROR_EOF;
+
+    const int n = (int)std::min<int64_t>(bufSize, size - self->m_mappedPos);
+    std::memcpy(buf, self->m_mapping->data() + self->m_mappedPos, (size_t)n);
+    self->m_mappedPos += n;
+    return n;
+}
+
+int64_t FFmpegDecoder::seekMapped(void* opaque, int64_t offset, int whence) {
+    auto* self = static_cast<FFmpegDecoder*>(opaque);
+    const int64_t size = (int64_t)self->m_mapping->size();
+
+    int64_t pos = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+    case AVSEEK_SIZE: return size;
+    case SEEK_SET: pos = offset; break;
+    case SEEK_CUR: pos = self->m_mappedPos + offset; break;
+    case SEEK_END: pos = size + offset; break;
+    default: return AVERROR(EINVAL);
+    }
+    if (pos < 0 || pos > size) return AVERROR(EINVAL);
+    self->m_mappedPos = pos;
+    return pos;
+}
+
 bool FFmpegDecoder::open(const std::string& filePath, uint32_t targetSampleRate, uint32_t targetChannels) {
     close();
 
@@ -47,7 +79,27 @@ bool FFmpegDecoder::open(const std::string& filePath, uint32_t targetSampleRate,
     m_formatCtx = nullptr;
     // avformat_open_input will allocate the context
 
+    // Read through the shared mapping when possible (no per-open file handle or read syscalls)
+    m_mapping = MappedFile::acquire(filePath);
+    if (m_mapping) {
+        m_formatCtx = avformat_alloc_context();
+        uint8_t* ioBuffer = (uint8_t*)av_malloc(kMappedIoBufferSize);
+        if (m_formatCtx && ioBuffer) {
+            m_mappedPos = 0;
+            m_ioCtx = avio_alloc_context(ioBuffer, kMappedIoBufferSize, 0, this, &FFmpegDecoder::readMapped, nullptr,
+                                         &FFmpegDecoder::seekMapped);
+        }
+        if (!m_ioCtx) {
+            av_free(ioBuffer);
+            avformat_free_context(m_formatCtx);
+            m_formatCtx = nullptr;
+            m_mapping.reset();
+        } else {
+            m_formatCtx->pb = m_ioCtx;
+        }
+    }
 
+    // The URL still names the file: probing uses its extension as a hint
     int ret = avformat_open_input(&m_formatCtx, filePath.c_str(), nullptr, nullptr);
     if (ret < 0) {
         char errbuf[256];
@@ -82,6 +134,7 @@ bool FFmpegDecoder::open(const std::string& filePath, uint32_t targetSampleRate,
     }
 
     std::cout << "[FFmpegDecoder] Using codec: " << codec->name << "\n";
+    m_codecName = codec->name;
 
     // Allocate codec context
     m_codecCtx = avcodec_alloc_context3(codec);
@@ -105,6 +158,12 @@ bool FFmpegDecoder::open(const std::string& filePath, uint32_t targetSampleRate,
         return false;
     }
 
+    // 0 = keep the source format
+    if (targetSampleRate == 0) targetSampleRate = (uint32_t)m_codecCtx->sample_rate;
+    if (targetChannels == 0) targetChannels = (uint32_t)m_codecCtx->ch_layout.nb_channels;
+    m_outSampleRate = targetSampleRate;
+    m_outChannels = targetChannels;
+
     // Setup resampler
     AVChannelLayout outLayout;
     av_channel_layout_default(&outLayout, targetChannels);
@@ -178,10 +237,25 @@ void FFmpegDecoder::close() {
         avformat_close_input(&m_formatCtx);
         m_formatCtx = nullptr;
     }
+    if (m_ioCtx) {
+        // Custom I/O is never freed by avformat_close_input
+        av_freep(&m_ioCtx->buffer);
+        avio_context_free(&m_ioCtx);
+        m_ioCtx = nullptr;
+    }
+    m_mapping.reset();
+    m_mappedPos = 0;
 
     m_audioStreamIndex = -1;
     m_totalFrames = 0;
     m_currentFrame = 0;
+    m_codecName.clear();
+    m_seekIndex.reset();
+    m_decodePos = 0;
+    m_decodePosKnown = true;
+    m_discardUntilFrame = 0;
+    m_discardPending = false;
+    m_anchorPending = false;
     m_resampleBuffer.clear();
     m_resampleBufferPos = 0;
     m_resampleBufferSize = 0;
@@ -206,6 +280,13 @@ bool FFmpegDecoder::decodeNextPacket() {
             continue;
         }
 
+        // After a byte seek the demuxer may not know where it landed; the seek index does
+        if (m_anchorPending) {
+            m_packet->pts = m_anchorPts;
+            m_packet->dts = m_anchorPts;
+            m_anchorPending = false;
+        }
+
         ret = avcodec_send_packet(m_codecCtx, m_packet);
         av_packet_unref(m_packet);
 
@@ -225,6 +306,21 @@ bool FFmpegDecoder::decodeNextPacket() {
             return false;
         }
 
+        // Frame position in output frames, from its timestamp when known (otherwise keep counting)
+        int64_t ts = m_frame->best_effort_timestamp;
+        if (ts == AV_NOPTS_VALUE) ts = m_frame->pts;
+        if (ts != AV_NOPTS_VALUE) {
+            m_decodePos = outputFrameAt(ts);
+            m_decodePosKnown = true;
+        } else if (!m_decodePosKnown) {
+            // Landed somewhere unknown and nothing says where: decode-and-discard from the start instead
+            av_frame_unref(m_frame);
+            if (!rewindToStart()) {
+                return false;
+            }
+            continue;
+        }
+
         // We have a decoded frame - resample it
         int outSamples = swr_get_out_samples(m_swrCtx, m_frame->nb_samples);
         if (outSamples <= 0) {
@@ -245,7 +341,21 @@ bool FFmpegDecoder::decodeNextPacket() {
         av_frame_unref(m_frame);
 
         if (converted > 0) {
-            m_resampleBufferPos = 0;
+            size_t skipFrames = 0;
+            if (m_discardPending) {
+                // Pre-roll: everything before the seek target is decoded only to settle the decoder state
+                if (m_decodePos + (uint64_t)converted <= m_discardUntilFrame) {
+                    m_decodePos += (uint64_t)converted;
+                    continue;
+                }
+                if (m_discardUntilFrame > m_decodePos) {
+                    skipFrames = (size_t)(m_discardUntilFrame - m_decodePos);
+                }
+                m_discardPending = false;
+            }
+            m_decodePos += (uint64_t)converted;
+
+            m_resampleBufferPos = skipFrames * m_outChannels;
             m_resampleBufferSize = converted * m_outChannels;
             return true;
         }
@@ -286,38 +396,150 @@ uint64_t FFmpegDecoder::readPcmFrames(float* buffer, uint64_t framesToRead) {
     return framesRead;
 }
 
+int64_t FFmpegDecoder::streamStartPts() const {
+    const AVStream* stream = m_formatCtx->streams[m_audioStreamIndex];
+    return stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+}
+
 bool FFmpegDecoder::seekToPcmFrame(uint64_t frameIndex) {
     if (!m_isOpen || !m_formatCtx) return false;
 
     AVStream* stream = m_formatCtx->streams[m_audioStreamIndex];
-    
-    // Convert frame index to stream timestamp
-    double timestampSec = (double)frameIndex / m_outSampleRate;
-    int64_t timestamp = (int64_t)(timestampSec / av_q2d(stream->time_base));
+    const double timeBase = av_q2d(stream->time_base);
+
+    // Start decoding a little early so the decoder state has converged by the target
+    // (Opus needs its 80 ms pre-roll, MP3 the bit reservoir of the previous frames)
+    const int sourceRate = m_codecCtx->sample_rate > 0 ? m_codecCtx->sample_rate : (int)m_outSampleRate;
+    const int prerollSamples = std::max(stream->codecpar->seek_preroll, 2 * stream->codecpar->frame_size);
+    const double targetSec = (double)frameIndex / m_outSampleRate;
+    const double seekSec = std::max(0.0, targetSec - (double)prerollSamples / sourceRate);
+    const int64_t seekTs = streamStartPts() + (int64_t)(seekSec / timeBase);
+
+    bool seeked = false;
+    int64_t landedPts = AV_NOPTS_VALUE; // where the demuxer will resume, when we know it
+    m_anchorPending = false;
+
+    if (m_seekIndex && m_seekIndex->kind == SeekIndex::Kind::PacketTable && !m_seekIndex->points.empty()) {
+        const auto& points = m_seekIndex->points;
+        auto it = std::upper_bound(points.begin(), points.end(), seekTs,
+            [](int64_t ts, const SeekIndex::Point& p) { return ts < p.pts; });
+        if (it != points.begin()) --it;
+
+        // Raw streams (MP3/ADTS) only have approximate timestamp seeking; jump to the exact packet offset
+        // instead and stamp it with the timestamp we recorded at import
+        const bool byteSeekable = it->bytePos >= 0 && !(m_formatCtx->iformat->flags & AVFMT_NO_BYTE_SEEK) &&
+            (std::strcmp(m_formatCtx->iformat->name, "mp3") == 0 || std::strcmp(m_formatCtx->iformat->name, "aac") == 0);
+        if (byteSeekable && av_seek_frame(m_formatCtx, m_audioStreamIndex, it->bytePos, AVSEEK_FLAG_BYTE) >= 0) {
+            m_anchorPts = it->pts;
+            m_anchorPending = true;
+            landedPts = it->pts;
+            seeked = true;
+        } else if (av_seek_frame(m_formatCtx, m_audioStreamIndex, it->pts, AVSEEK_FLAG_BACKWARD) >= 0) {
+            landedPts = it->pts;
+            seeked = true;
+        }
+    }
 
-    // Seek to the requested position
-    int ret = av_seek_frame(m_formatCtx, m_audioStreamIndex, timestamp, AVSEEK_FLAG_BACKWARD);
-    if (ret < 0) {
-        // Try seeking in the file instead
-        int64_t fileTimestamp = (int64_t)(timestampSec * AV_TIME_BASE);
-        ret = av_seek_frame(m_formatCtx, -1, fileTimestamp, AVSEEK_FLAG_BACKWARD);
+    if (!seeked) {
+        int ret = av_seek_frame(m_formatCtx, m_audioStreamIndex, seekTs, AVSEEK_FLAG_BACKWARD);
         if (ret < 0) {
-            return false;
+            // Try seeking in the file instead
+            int64_t fileTimestamp = (int64_t)(seekSec * AV_TIME_BASE);
+            ret = av_seek_frame(m_formatCtx, -1, fileTimestamp, AVSEEK_FLAG_BACKWARD);
+            if (ret < 0) {
+                return false;
+            }
+        }
+        if (seekTs <= streamStartPts()) {
+            landedPts = streamStartPts();
         }
     }
 
-    // Flush codec buffers
+    // Flush codec and resampler state
     avcodec_flush_buffers(m_codecCtx);
+    swr_init(m_swrCtx);
 
-    // Clear resample buffer
+    // Clear resample buffer; decodeNextPacket() drops output until the exact target frame, counting from the
+    // seek point, or from the first decoded timestamp when the demuxer could have landed anywhere before it
     m_resampleBufferPos = 0;
     m_resampleBufferSize = 0;
+    m_decodePos = landedPts != AV_NOPTS_VALUE ? outputFrameAt(landedPts) : 0;
+    m_decodePosKnown = landedPts != AV_NOPTS_VALUE;
+    m_discardUntilFrame = frameIndex;
+    m_discardPending = true;
     m_currentFrame = frameIndex;
     m_eof = false;
 
     return true;
 }
 
+bool FFmpegDecoder::buildSeekIndex(SeekIndex& out) {
+    if (!m_isOpen || !m_formatCtx) return false;
+
+    AVStream* stream = m_formatCtx->streams[m_audioStreamIndex];
+    const double timeBase = av_q2d(stream->time_base);
+    const int64_t startPts = streamStartPts();
+    const int sourceRate = m_codecCtx->sample_rate > 0 ? m_codecCtx->sample_rate : (int)m_outSampleRate;
+
+    // One entry every ~250 ms bounds the decode-and-discard work per seek while keeping the table small
+    const int64_t spacing = std::max<int64_t>(1, (int64_t)(0.25 / timeBase));
+
+    out.kind = SeekIndex::Kind::PacketTable;
+    out.points.clear();
+
+    while (av_read_frame(m_formatCtx, m_packet) >= 0) {
+        if (m_packet->stream_index == m_audioStreamIndex) {
+            const int64_t ts = m_packet->pts != AV_NOPTS_VALUE ? m_packet->pts : m_packet->dts;
+            if (ts != AV_NOPTS_VALUE && (out.points.empty() || ts - out.points.back().pts >= spacing)) {
+                SeekIndex::Point p;
+                p.pts = ts;
+                p.bytePos = m_packet->pos;
+                p.pcmFrame = ts > startPts ? (uint64_t)((double)(ts - startPts) * timeBase * sourceRate + 0.5) : 0;
+                out.points.push_back(p);
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+
+    // Back to the start for normal decoding
+    av_seek_frame(m_formatCtx, m_audioStreamIndex, startPts, AVSEEK_FLAG_BACKWARD);
+    avcodec_flush_buffers(m_codecCtx);
+    swr_init(m_swrCtx);
+    m_resampleBufferPos = 0;
+    m_resampleBufferSize = 0;
+    m_decodePos = 0;
+    m_decodePosKnown = true;
+    m_discardPending = false;
+    m_anchorPending = false;
+    m_currentFrame = 0;
+    m_eof = false;
+
+    if (out.points.empty()) {
+        out.kind = SeekIndex::Kind::None;
+        return false;
+    }
+    return true;
+}
+
+bool FFmpegDecoder::rewindToStart() {
+    if (av_seek_frame(m_formatCtx, m_audioStreamIndex, streamStartPts(), AVSEEK_FLAG_BACKWARD) < 0 &&
+        av_seek_frame(m_formatCtx, m_audioStreamIndex, 0, AVSEEK_FLAG_BYTE) < 0) {
+        return false;
+    }
+    avcodec_flush_buffers(m_codecCtx);
+    swr_init(m_swrCtx);
+    m_decodePos = 0;
+    m_decodePosKnown = true;
+    m_anchorPending = false;
+    return true;
+}
+
+uint64_t FFmpegDecoder::outputFrameAt(int64_t pts) const {
+    const AVStream* stream = m_formatCtx->streams[m_audioStreamIndex];
+    const double posSec = (double)(pts - streamStartPts()) * av_q2d(stream->time_base);
+    return posSec > 0.0 ? (uint64_t)(posSec * m_outSampleRate + 0.5) : 0;
+}
+
 uint64_t FFmpegDecoder::getCursorInPcmFrames() const {
     return m_currentFrame;
 }
@@ -362,11 +584,17 @@ bool FFmpegDecoder::open(const std::string&, uint32_t, uint32_t) {
 void FFmpegDecoder::close() {}
 uint64_t FFmpegDecoder::readPcmFrames(float*, uint64_t) { return 0; }
 bool FFmpegDecoder::seekToPcmFrame(uint64_t) { return false; }
+bool FFmpegDecoder::buildSeekIndex(SeekIndex&) { return false; }
+int64_t FFmpegDecoder::streamStartPts() const { return 0; }
+bool FFmpegDecoder::rewindToStart() { return false; }
+uint64_t FFmpegDecoder::outputFrameAt(int64_t) const { return 0; }
 uint64_t FFmpegDecoder::getCursorInPcmFrames() const { return 0; }
 uint64_t FFmpegDecoder::getLengthInPcmFrames() const { return 0; }
 bool FFmpegDecoder::canDecode(const std::string&) { return false; }
 bool FFmpegDecoder::decodeNextPacket() { return false; }
 void FFmpegDecoder::drainResampler() {}
+int FFmpegDecoder::readMapped(void*, uint8_t*, int) { return -1; }
+int64_t FFmpegDecoder::seekMapped(void*, int64_t, int) { return -1; }
 
 #endif // TALKLESS_HAS_FFMPEG
 
@@ -385,10 +613,14 @@ bool FFmpegDecoder::open(const std::string&, uint32_t, uint32_t) {
 void FFmpegDecoder::close() {}
 uint64_t FFmpegDecoder::readPcmFrames(float*, uint64_t) { return 0; }
 bool FFmpegDecoder::seekToPcmFrame(uint64_t) { return false; }
+bool FFmpegDecoder::buildSeekIndex(SeekIndex&) { return false; }
+int64_t FFmpegDecoder::streamStartPts() const { return 0; }
 uint64_t FFmpegDecoder::getCursorInPcmFrames() const { return 0; }
 uint64_t FFmpegDecoder::getLengthInPcmFrames() const { return 0; }
 bool FFmpegDecoder::canDecode(const std::string&) { return false; }
 bool FFmpegDecoder::decodeNextPacket() { return false; }
 void FFmpegDecoder::drainResampler() {}
+int FFmpegDecoder::readMapped(void*, uint8_t*, int) { return -1; }
+int64_t FFmpegDecoder::seekMapped(void*, int64_t, int) { return -1; }
 
 #endif // TALKLESS_HAS_FFMPEG
@@ -2,12 +2,17 @@
 // FFmpeg-based audio decoder for formats not supported by miniaudio (e.g., Opus)
 #pragma once
 
+#include "mappedFile.h"
+#include "seekIndex.h"
+
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 // Forward declarations - avoid including FFmpeg headers in header file
 struct AVFormatContext;
+struct AVIOContext;
 struct AVCodecContext;
 struct AVFrame;
 struct AVPacket;
@@ -23,6 +28,7 @@ public:
     FFmpegDecoder& operator=(const FFmpegDecoder&) = delete;
 
     // Open an audio file. Returns true on success.
+    // A target sample rate/channel count of 0 keeps the source format.
     bool open(const std::string& filePath, uint32_t targetSampleRate = 48000, uint32_t targetChannels = 2);
 
     // Close and release resources
@@ -32,9 +38,15 @@ public:
     // Returns number of frames actually read (0 = EOF or error)
     uint64_t readPcmFrames(float* buffer, uint64_t framesToRead);
 
-    // Seek to a specific PCM frame
+    // Seek to a specific PCM frame (sample-accurate: decodes a short pre-roll and discards up to the target)
     bool seekToPcmFrame(uint64_t frameIndex);
 
+    // Scan every audio packet once and record timestamps/byte offsets. Rewinds to the start afterwards.
+    bool buildSeekIndex(SeekIndex& out);
+
+    // Use a previously built packet table for seeks
+    void setSeekIndex(std::shared_ptr<const SeekIndex> index) { m_seekIndex = std::move(index); }
+
     // Get cursor position in PCM frames
     uint64_t getCursorInPcmFrames() const;
 
@@ -47,6 +59,9 @@ public:
     // Get output channels
     uint32_t getChannels() const { return m_outChannels; }
 
+    // Get codec name of the audio stream (e.g. "opus", "aac")
+    const std::string& getCodecName() const { return m_codecName; }
+
     // Check if decoder is open and valid
     bool isOpen() const { return m_isOpen; }
 
@@ -55,10 +70,20 @@ public:
     static bool canDecode(const std::string& filePath);
 
 private:
+    // AVIO callbacks reading from m_mapping
+    static int readMapped(void* opaque, uint8_t* buf, int bufSize);
+    static int64_t seekMapped(void* opaque, int64_t offset, int whence);
+
     bool decodeNextPacket();
     void drainResampler();
+    int64_t streamStartPts() const;
+    bool rewindToStart();                         // back to the first packet, counting output frames from 0
+    uint64_t outputFrameAt(int64_t pts) const;    // stream timestamp -> output frame
 
     AVFormatContext* m_formatCtx = nullptr;
+    AVIOContext* m_ioCtx = nullptr;              // custom input over m_mapping; null = FFmpeg's own file I/O
+    std::shared_ptr<const MappedFile> m_mapping;
+    int64_t m_mappedPos = 0;
     AVCodecContext* m_codecCtx = nullptr;
     AVFrame* m_frame = nullptr;
     AVPacket* m_packet = nullptr;
@@ -69,6 +94,16 @@ private:
     uint32_t m_outChannels = 2;
     uint64_t m_totalFrames = 0;
     uint64_t m_currentFrame = 0;
+    std::string m_codecName;
+
+    // Seeking
+    std::shared_ptr<const SeekIndex> m_seekIndex;
+    uint64_t m_decodePos = 0;         // output frame of the next decoded sample
+    bool m_decodePosKnown = true;     // false after a seek whose landing point only the next timestamp reveals
+    uint64_t m_discardUntilFrame = 0; // drop decoded output before this frame after a seek
+    bool m_discardPending = false;
+    int64_t m_anchorPts = 0;          // timestamp to stamp on the first packet after a byte seek
+    bool m_anchorPending = false;
 
     // Internal buffer for resampled audio
     std::vector<float> m_resampleBuffer;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief Linear parameter ramp, evaluated one audio block at a time
+ *
+ * Owned by a single audio callback. rampTo() starts a straight line from
+ * wherever the value is now, so retargeting mid-ramp never jumps. apply()
+ * multiplies a per-frame gain buffer by the ramp and advances it; both of its
+ * loops are branch-free so the compiler vectorizes them.
+ */
+struct GainRamp
+{
+    float current = 1.0f;
+    float target = 1.0f;
+    float step = 0.0f;
+    uint32_t framesLeft = 0;
+
+    void snap(float value)
+    {
+        current = target = value;
+        step = 0.0f;
+        framesLeft = 0;
+    }
+
+    void rampTo(float value, uint32_t frames)
+    {
+        target = value;
+        if (frames == 0) {
+            snap(value);
+            return;
+        }
+        step = (value - current) / (float)frames;
+        framesLeft = frames;
+    }
+
+    bool isFlat() const { return framesLeft == 0; }
+
+    // gains[f] *= value at frame f, for f < frames
+    void apply(float* gains, uint32_t frames)
+    {
+        const uint32_t ramped = std::min(frames, framesLeft);
+        const float start = current;
+        const float delta = step;
+        for (uint32_t f = 0; f < ramped; ++f)
+            gains[f] *= start + delta * (float)(f + 1);
+
+        framesLeft -= ramped;
+        // Land exactly on the target so float error never accumulates
+        current = framesLeft == 0 ? target : start + delta * (float)ramped;
+
+        const float hold = current;
+        for (uint32_t f = ramped; f < frames; ++f)
+            gains[f] *= hold;
+    }
+};
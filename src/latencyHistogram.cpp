@@ -0,0 +1,77 @@
+#include "latencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+int LatencyHistogram::bucketFor(double ms)
+{
+    if (!(ms >= kMinMs))
+        return 0; // underflow (and NaN)
+    const int b = 1 + (int)std::floor(std::log10(ms / kMinMs) * kBucketsPerDecade);
+    return std::min(b, kBucketCount - 1);
+}
+
+double LatencyHistogram::bucketUpperMs(int bucket)
+{
+    if (bucket <= 0)
+        return kMinMs;
+    return kMinMs * std::pow(10.0, (double)bucket / kBucketsPerDecade);
+}
+
+void LatencyHistogram::record(double ms)
+{
+    ms = std::max(0.0, ms);
+    m_buckets[bucketFor(ms)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t us = (uint64_t)std::llround(ms * 1000.0);
+    m_sumUs.fetch_add(us, std::memory_order_relaxed);
+    uint64_t prevMax = m_maxUs.load(std::memory_order_relaxed);
+    while (us > prevMax && !m_maxUs.compare_exchange_weak(prevMax, us, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& b : m_buckets)
+        b.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumUs.store(0, std::memory_order_relaxed);
+    m_maxUs.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::percentileMs(double p) const
+{
+    uint64_t total = 0;
+    for (const auto& b : m_buckets)
+        total += b.load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0.0;
+
+    const uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * total));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Never report past the largest sample actually seen; overflow has no upper edge
+            const double maxMs = m_maxUs.load(std::memory_order_relaxed) / 1000.0;
+            return i == kBucketCount - 1 ? maxMs : std::min(bucketUpperMs(i), maxMs);
+        }
+    }
+    return m_maxUs.load(std::memory_order_relaxed) / 1000.0;
+}
+
+LatencyHistogram::Summary LatencyHistogram::summary() const
+{
+    Summary s;
+    s.count = m_count.load(std::memory_order_relaxed);
+    if (s.count == 0)
+        return s;
+
+    s.p50Ms = percentileMs(50.0);
+    s.p95Ms = percentileMs(95.0);
+    s.p99Ms = percentileMs(99.0);
+    s.maxMs = m_maxUs.load(std::memory_order_relaxed) / 1000.0;
+    s.meanMs = (m_sumUs.load(std::memory_order_relaxed) / 1000.0) / (double)s.count;
+    return s;
+}
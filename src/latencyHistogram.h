@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Monotonic timestamp shared by every latency probe (UI thread, decoder threads, audio callbacks)
+inline int64_t latencyClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Lock-free latency histogram with log-spaced buckets
+ *
+ * 20 buckets per decade from 10 us to 10 s (about 12% resolution), plus an
+ * underflow and an overflow bucket. record() is wait-free and safe to call
+ * from the audio callbacks; the readers tolerate concurrent updates (a
+ * snapshot may be off by the samples recorded while it is taken).
+ */
+class LatencyHistogram
+{
+public:
+    struct Summary
+    {
+        uint64_t count = 0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        double meanMs = 0.0;
+    };
+
+    void record(double ms);
+    void reset();
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    double percentileMs(double p) const; // p in 0..100; upper edge of the bucket holding it
+    Summary summary() const;
+
+private:
+    static constexpr double kMinMs = 0.01;
+    static constexpr int kBucketsPerDecade = 20;
+    static constexpr int kDecades = 6; // 0.01 ms .. 10 s
+    static constexpr int kBucketCount = kBucketsPerDecade * kDecades + 2;
+
+    static int bucketFor(double ms);
+    static double bucketUpperMs(int bucket);
+
+    std::array<std::atomic<uint32_t>, kBucketCount> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sumUs{0};
+    std::atomic<uint64_t> m_maxUs{0};
+};
@@ -0,0 +1,323 @@
+#include "macroSequencer.h"
+
+#include "audioEngine.h"
+
+#include <algorithm>
+
+namespace
+{
+// Upper bound on a single sleep, so a changed device clock is picked up quickly
+constexpr auto kMaxSleep = std::chrono::milliseconds(10);
+// Re-check interval while waiting on a clip this macro did not start
+constexpr double kPollMs = 5.0;
+} // namespace
+
+MacroSequencer::MacroSequencer(AudioEngine& engine) : m_engine(engine)
+{
+    m_thread = std::thread(&MacroSequencer::threadFunc, this);
+}
+
+MacroSequencer::~MacroSequencer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void MacroSequencer::setStepCallback(StepCallback cb)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_stepCallback = std::move(cb);
+}
+
+void MacroSequencer::setFinishedCallback(FinishedCallback cb)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_finishedCallback = std::move(cb);
+}
+
+// ------------------------------------------------------------
+// Control
+// ------------------------------------------------------------
+void MacroSequencer::start(int macroId, std::vector<Step> steps, double leadMs)
+{
+    bool restarted = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = std::find_if(m_runs.begin(), m_runs.end(), [&](const Run& r) { return r.macroId == macroId; });
+        if (it != m_runs.end()) {
+            endRun(*it);
+            m_runs.erase(it);
+            restarted = true;
+        }
+
+        Run run;
+        run.macroId = macroId;
+        run.steps = std::move(steps);
+        run.leadFrames = msToFrames(leadMs);
+        run.cursor = nowFrame() + run.leadFrames;
+        m_runs.push_back(std::move(run));
+    }
+    m_cv.notify_all();
+
+    if (restarted) {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (m_finishedCallback)
+            m_finishedCallback(macroId, false);
+    }
+}
+
+void MacroSequencer::stop(int macroId)
+{
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_runs.begin(), m_runs.end(), [&](const Run& r) { return r.macroId == macroId; });
+        if (it != m_runs.end()) {
+            endRun(*it);
+            m_runs.erase(it);
+            found = true;
+        }
+    }
+    m_cv.notify_all();
+
+    if (found) {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (m_finishedCallback)
+            m_finishedCallback(macroId, false);
+    }
+}
+
+void MacroSequencer::stopAll()
+{
+    std::vector<int> stopped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Run& run : m_runs) {
+            endRun(run);
+            stopped.push_back(run.macroId);
+        }
+        m_runs.clear();
+    }
+    m_cv.notify_all();
+
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    if (m_finishedCallback) {
+        for (int macroId : stopped)
+            m_finishedCallback(macroId, false);
+    }
+}
+
+bool MacroSequencer::isRunning(int macroId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::any_of(m_runs.begin(), m_runs.end(), [&](const Run& r) { return r.macroId == macroId; });
+}
+
+// ------------------------------------------------------------
+// Sequencer thread
+// ------------------------------------------------------------
+void MacroSequencer::threadFunc()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_quit) {
+        if (m_runs.empty()) {
+            m_cv.wait(lock, [this] { return m_quit || !m_runs.empty(); });
+            continue;
+        }
+
+        std::vector<std::pair<int, int>> executed; // macroId, step index
+        std::vector<int> finished;
+        uint64_t nextDue = UINT64_MAX;
+
+        const uint64_t now = nowFrame();
+        for (auto it = m_runs.begin(); it != m_runs.end();) {
+            Run& run = *it;
+
+            while (run.next < run.steps.size() && now >= issueFrame(run)) {
+                if (!executeStep(run, run.steps[run.next], now))
+                    break;
+                executed.emplace_back(run.macroId, (int)run.next);
+                ++run.next;
+            }
+            applyDeferred(run, now);
+
+            // Done once the last step's time (e.g. a trailing wait) has passed
+            uint64_t due = issueFrame(run);
+            if (!run.deferred.empty())
+                due = std::min(due, run.deferred.front().first);
+            if (run.next >= run.steps.size() && run.deferred.empty() && now >= due) {
+                endRun(run);
+                finished.push_back(run.macroId);
+                it = m_runs.erase(it);
+                continue;
+            }
+
+            nextDue = std::min(nextDue, due);
+            ++it;
+        }
+
+        if (!executed.empty() || !finished.empty()) {
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> cbLock(m_callbackMutex);
+                if (m_stepCallback) {
+                    for (const auto& [macroId, stepIndex] : executed)
+                        m_stepCallback(macroId, stepIndex);
+                }
+                if (m_finishedCallback) {
+                    for (int macroId : finished)
+                        m_finishedCallback(macroId, true);
+                }
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (nextDue == UINT64_MAX)
+            continue;
+
+        const uint32_t sampleRate = std::max<uint32_t>(1, m_engine.getSampleRate());
+        const auto untilDue = std::chrono::microseconds((nextDue - now) * 1000000ull / sampleRate);
+        m_cv.wait_for(lock, std::clamp<std::chrono::microseconds>(untilDue, std::chrono::microseconds(500),
+                                                                  kMaxSleep));
+    }
+}
+
+uint64_t MacroSequencer::issueFrame(const Run& run) const
+{
+    if (run.next >= run.steps.size())
+        return run.cursor;
+
+    const Step& step = run.steps[run.next];
+    switch (step.type) {
+    case Step::Type::PlayClip:
+    case Step::Type::StopClip:
+    case Step::Type::StopAll:
+        return run.cursor > run.leadFrames ? run.cursor - run.leadFrames : 0;
+    case Step::Type::Wait:
+        // Pure cursor arithmetic: resolve right away so the following start still gets its full lead
+        return 0;
+    case Step::Type::WaitClipEnd:
+        return run.slotStartFrame.count(step.slotId) > 0 ? 0 : run.cursor;
+    case Step::Type::SetGain:
+    case Step::Type::DuckMic:
+        return 0; // queued for the cursor frame, see applyDeferred
+    }
+    return run.cursor;
+}
+
+bool MacroSequencer::executeStep(Run& run, const Step& step, uint64_t now)
+{
+    using Type = Step::Type;
+
+    switch (step.type) {
+    case Type::PlayClip:
+        postClipCommand(true, step.slotId, run.cursor);
+        run.slotStartFrame[step.slotId] = run.cursor;
+        break;
+
+    case Type::StopClip:
+        postClipCommand(false, step.slotId, run.cursor);
+        run.slotStartFrame.erase(step.slotId);
+        break;
+
+    case Type::Wait:
+        run.cursor += msToFrames(step.value);
+        break;
+
+    case Type::WaitClipEnd: {
+        auto started = run.slotStartFrame.find(step.slotId);
+        if (started != run.slotStartFrame.end()) {
+            const uint64_t length = msToFrames(m_engine.getClipPlayableMs(step.slotId));
+            run.cursor = std::max(run.cursor, started->second + length);
+        } else if (m_engine.isClipPlaying(step.slotId)) {
+            // Started outside this macro: no start frame to count from, so poll until it stops
+            run.cursor = std::max(run.cursor, now + msToFrames(kPollMs));
+            return false;
+        }
+        break;
+    }
+
+    case Type::SetGain:
+    case Type::DuckMic:
+        // Not frame-accurate in the engine, so hold them back until the cursor is reached
+        // without also holding back the clip starts behind them
+        run.deferred.emplace_back(run.cursor, step);
+        break;
+
+    case Type::StopAll:
+        for (int slotId = 0; slotId < AudioEngine::MAX_CLIPS; ++slotId) {
+            // A start this run posted may not have reached the engine yet
+            if (m_engine.isClipPlaying(slotId) || run.slotStartFrame.count(slotId) > 0)
+                postClipCommand(false, slotId, run.cursor);
+        }
+        run.slotStartFrame.clear();
+        break;
+    }
+    return true;
+}
+
+void MacroSequencer::postClipCommand(bool start, int slotId, uint64_t frame)
+{
+    AudioEngine::Command cmd;
+    cmd.type = start ? AudioEngine::Command::Type::PlayClipAt : AudioEngine::Command::Type::StopClipAt;
+    cmd.slotId = slotId;
+    cmd.frame = frame;
+    if (m_engine.postCommand(cmd))
+        return;
+
+    // Queue full: run it here; the slot's lifecycle lock still serializes it with the command thread
+    if (start)
+        m_engine.playClipAt(slotId, frame);
+    else
+        m_engine.stopClipAt(slotId, frame);
+}
+
+void MacroSequencer::applyDeferred(Run& run, uint64_t now)
+{
+    // Cursor only moves forward, so the queue is already in frame order
+    while (!run.deferred.empty() && run.deferred.front().first <= now) {
+        const Step& step = run.deferred.front().second;
+        if (step.type == Step::Type::SetGain) {
+            m_engine.setClipGain(step.slotId, (float)step.value);
+        } else if (step.type == Step::Type::DuckMic) {
+            m_engine.setMicDuckDB((float)step.value);
+            run.duckedMic = step.value < 0.0;
+        }
+        run.deferred.pop_front();
+    }
+}
+
+void MacroSequencer::endRun(Run& run)
+{
+    // A macro that ducked the mic and ended (or was cancelled) before restoring it must not leave it ducked
+    if (run.duckedMic) {
+        m_engine.setMicDuckDB(0.0f);
+        run.duckedMic = false;
+    }
+}
+
+// ------------------------------------------------------------
+// Clock
+// ------------------------------------------------------------
+uint64_t MacroSequencer::nowFrame() const
+{
+    if (m_engine.isDeviceRunning())
+        return m_engine.getEngineFrameTime();
+
+    const auto elapsed = std::chrono::steady_clock::now() - m_fallbackEpoch;
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    return (uint64_t)us * m_engine.getSampleRate() / 1000000ull;
+}
+
+uint64_t MacroSequencer::msToFrames(double ms) const
+{
+    return (uint64_t)((std::max(0.0, ms) / 1000.0) * m_engine.getSampleRate() + 0.5);
+}
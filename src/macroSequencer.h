@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class AudioEngine;
+
+/**
+ * @brief Runs timed clip sequences (macros) on the engine's sample clock
+ *
+ * Each macro is a list of steps resolved to engine slots. The sequencer keeps
+ * a cursor in engine frames per running macro: waits advance the cursor by an
+ * exact number of frames, and "wait until clip end" advances it by the clip's
+ * trimmed length from the frame the clip was started at, so a sequence never
+ * drifts by how late a thread woke up.
+ *
+ * Clip starts and stops are posted to the engine's command queue (PlayClipAt /
+ * StopClipAt) a lead time ahead of the cursor and land on the exact frame; the
+ * command thread does the slot start/stop, as for hotkey triggers. Gain and mic
+ * ducking are applied when the cursor is reached (one audio block of jitter).
+ *
+ * Without a running main output there is no engine clock; the sequencer then
+ * counts frames off the system clock instead.
+ */
+class MacroSequencer
+{
+public:
+    struct Step
+    {
+        enum class Type : uint8_t {
+            PlayClip,
+            StopClip,
+            Wait,
+            WaitClipEnd, // one pass for looping clips
+            SetGain,
+            DuckMic,
+            StopAll
+        };
+
+        Type type = Type::Wait;
+        int slotId = -1;
+        double value = 0.0; // ms for Wait, dB for SetGain/DuckMic
+    };
+
+    // Called on the sequencer thread
+    using StepCallback = std::function<void(int macroId, int stepIndex)>;
+    using FinishedCallback = std::function<void(int macroId, bool completed)>;
+
+    explicit MacroSequencer(AudioEngine& engine);
+    ~MacroSequencer();
+
+    MacroSequencer(const MacroSequencer&) = delete;
+    MacroSequencer& operator=(const MacroSequencer&) = delete;
+
+    void setStepCallback(StepCallback cb);
+    void setFinishedCallback(FinishedCallback cb);
+
+    // First step lands leadMs from now; restarts the macro if it is already running
+    void start(int macroId, std::vector<Step> steps, double leadMs);
+    void stop(int macroId);
+    void stopAll();
+    bool isRunning(int macroId) const;
+
+private:
+    struct Run
+    {
+        int macroId = -1;
+        std::vector<Step> steps;
+        size_t next = 0;
+        uint64_t cursor = 0;                              // engine frame the next step happens at
+        uint64_t leadFrames = 0;                          // clip starts/stops are issued this early
+        std::unordered_map<int, uint64_t> slotStartFrame; // slots this run started
+        std::deque<std::pair<uint64_t, Step>> deferred;   // gain/duck steps waiting for their frame
+        bool duckedMic = false;
+    };
+
+    void threadFunc();
+    bool executeStep(Run& run, const Step& step, uint64_t now); // false = step not finished yet
+    uint64_t issueFrame(const Run& run) const; // engine frame the next step (or completion) is due at
+    void postClipCommand(bool start, int slotId, uint64_t frame); // via the engine's command thread
+    void applyDeferred(Run& run, uint64_t now);
+    void endRun(Run& run);
+    uint64_t nowFrame() const;
+    uint64_t msToFrames(double ms) const;
+
+    AudioEngine& m_engine;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Run> m_runs;
+    bool m_quit = false;
+
+    std::mutex m_callbackMutex;
+    StepCallback m_stepCallback;
+    FinishedCallback m_finishedCallback;
+
+    std::chrono::steady_clock::time_point m_fallbackEpoch = std::chrono::steady_clock::now();
+    std::thread m_thread;
+};
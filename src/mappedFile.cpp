@@ -0,0 +1,240 @@
+#include "mappedFile.h"
+
+#include "cachePaths.h"
+#include "mediaInfoCache.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #if defined(__linux__)
+        #include <sys/vfs.h>
+    #else
+        #include <sys/mount.h>
+        #include <sys/param.h>
+    #endif
+#endif
+
+namespace
+{
+// Mappings kept alive with no decoder attached: a soundboard's worth of recently played clips.
+// Only address space and page cache; resident pages are the kernel's to reclaim.
+constexpr size_t kRetainedMappings = 64;
+
+// Faulted in up front so the first decoded block after open doesn't wait on the disk/network
+constexpr size_t kPrefetchBytes = 256 * 1024;
+
+struct Registry
+{
+    struct Entry
+    {
+        std::shared_ptr<const MappedFile> file;
+        uint64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        uint64_t lastUse = 0;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t useClock = 0;
+
+    // Drop least recently used mappings nobody else holds (caller holds the mutex)
+    void trimLocked()
+    {
+        while (entries.size() > kRetainedMappings) {
+            auto victim = entries.end();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                if (it->second.file.use_count() > 1)
+                    continue;
+                if (victim == entries.end() || it->second.lastUse < victim->second.lastUse)
+                    victim = it;
+            }
+            if (victim == entries.end())
+                return; // all in use
+            entries.erase(victim);
+        }
+    }
+};
+
+Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+} // namespace
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+std::shared_ptr<const MappedFile> MappedFile::acquire(const std::string& filePath)
+{
+    uint64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+    if (!MediaInfoCache::statFile(filePath, fileSize, modifiedTime) || fileSize == 0 ||
+        fileSize > (uint64_t)std::numeric_limits<size_t>::max())
+        return nullptr;
+
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto it = reg.entries.find(filePath);
+        if (it != reg.entries.end() && it->second.fileSize == fileSize && it->second.modifiedTime == modifiedTime) {
+            it->second.lastUse = ++reg.useClock;
+            return it->second.file;
+        }
+    }
+
+    // Map outside the lock: opening a file on a network share can take a while
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    if (!file->map(filePath)) {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.entries.erase(filePath);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    Registry::Entry& entry = reg.entries[filePath];
+    if (!entry.file || entry.fileSize != fileSize || entry.modifiedTime != modifiedTime) {
+        // Replaces a stale mapping; its current readers keep their reference
+        entry.file = std::move(file);
+        entry.fileSize = fileSize;
+        entry.modifiedTime = modifiedTime;
+    }
+    entry.lastUse = ++reg.useClock;
+    std::shared_ptr<const MappedFile> result = entry.file;
+    reg.trimLocked();
+    return result;
+}
+
+void MappedFile::evict(const std::string& filePath)
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.entries.erase(filePath);
+}
+
+#ifdef _WIN32
+
+bool MappedFile::map(const std::string& filePath)
+{
+    const std::filesystem::path path = pathFromUtf8(filePath);
+
+    // Network drives and UNC shares: a dropped connection would fault the reader, see the header
+    wchar_t volume[MAX_PATH] = {};
+    if (!GetVolumePathNameW(path.c_str(), volume, MAX_PATH) || GetDriveTypeW(volume) == DRIVE_REMOTE)
+        return false;
+
+    // Share write/delete so the mapping never blocks the user replacing or removing the file
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+        (uint64_t)size.QuadPart > (uint64_t)std::numeric_limits<size_t>::max()) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // the view keeps the section alive
+    if (!view)
+        return false;
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::unmap()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#else
+
+namespace
+{
+// Network and FUSE filesystems can lose pages under a mapping, see the header. Unknown answers count as remote.
+bool isLocalFilesystem(int fd)
+{
+    struct statfs fs{};
+    if (::fstatfs(fd, &fs) != 0)
+        return false;
+    #if defined(__linux__)
+    switch ((unsigned long)fs.f_type) {
+    case 0x6969UL:     // NFS
+    case 0x517BUL:     // SMB
+    case 0xFF534D42UL: // CIFS
+    case 0xFE534D42UL: // SMB2
+    case 0x65735546UL: // FUSE (sshfs, rclone, gvfs, ...)
+    case 0x01021997UL: // 9P
+    case 0x00C36400UL: // Ceph
+    case 0x5346414FUL: // AFS
+        return false;
+    default:
+        return true;
+    }
+    #else
+    return (fs.f_flags & MNT_LOCAL) != 0 && std::string_view(fs.f_fstypename).find("fuse") == std::string_view::npos;
+    #endif
+}
+} // namespace
+
+bool MappedFile::map(const std::string& filePath)
+{
+    const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+        (uint64_t)st.st_size > (uint64_t)std::numeric_limits<size_t>::max() || !isLocalFilesystem(fd)) {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = (size_t)st.st_size;
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping holds its own reference to the file
+    if (addr == MAP_FAILED)
+        return false;
+
+    // Clips are streamed front to back: read ahead aggressively, and start on the head now
+    ::posix_madvise(addr, size, POSIX_MADV_SEQUENTIAL);
+    ::posix_madvise(addr, std::min(size, kPrefetchBytes), POSIX_MADV_WILLNEED);
+
+    m_data = static_cast<const uint8_t*>(addr);
+    m_size = size;
+    return true;
+}
+
+void MappedFile::unmap()
+{
+    if (m_data)
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
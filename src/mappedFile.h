@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file, shared between decoders
+ *
+ * acquire() returns one mapping per path. Every decoder open of that file
+ * reads the same pages, so re-triggering a clip skips the open/read syscalls
+ * and the copy into a stdio buffer. The registry keeps the most recently used
+ * mappings alive after their last decoder closes. A mapping is replaced when
+ * the file's size or modification time changes; decoders already holding the
+ * old one keep reading it until they close.
+ *
+ * Mappings are advised for sequential access with the head prefetched, which
+ * matches how clips are streamed. Files that cannot be mapped (empty, special,
+ * or a failed mmap) return nullptr, and callers fall back to normal file I/O.
+ *
+ * A page that can no longer be read (file truncated under the mapping, network
+ * share gone) faults the reading thread (SIGBUS, or an in-page error on
+ * Windows) where buffered I/O would just fail the read. So files on network
+ * or FUSE filesystems are never mapped: they take the buffered path, whose
+ * errors the decoders already handle. Local files are only truncated by other
+ * programs; the app's editing tools (trim, normalize, effects) always write a
+ * new file.
+ */
+class MappedFile
+{
+public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    static std::shared_ptr<const MappedFile> acquire(const std::string& filePath);
+    // Drop the registry's reference, e.g. before deleting the file (Windows won't while it is mapped)
+    static void evict(const std::string& filePath);
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    MappedFile() = default;
+
+    bool map(const std::string& filePath);
+    void unmap();
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    uint64_t m_fileSize = 0;
+    int64_t m_modifiedTime = 0;
+};
@@ -0,0 +1,405 @@
+#include "mediaInfoCache.h"
+
+#include "cachePaths.h"
+#include "clipDecoder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+constexpr const char* kCacheFileName = "media_info.tsv";
+constexpr const char* kCacheHeader = "# talkless media info v1";
+constexpr const char* kSeekIndexDir = "seek";
+
+std::vector<std::string> splitTabs(const std::string& line)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        const size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+        if (tab == std::string::npos)
+            break;
+        start = tab + 1;
+    }
+    return fields;
+}
+} // namespace
+
+// ------------------------------------------------------------
+// Persistence
+// ------------------------------------------------------------
+MediaInfoCache::~MediaInfoCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit.store(true, std::memory_order_relaxed);
+    }
+    m_indexCv.notify_all();
+    if (m_indexWorker.joinable())
+        m_indexWorker.join();
+
+    flush();
+}
+
+void MediaInfoCache::setStorageDirectory(const std::string& directory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::error_code ec;
+    const std::filesystem::path dir = pathFromUtf8(directory);
+    std::filesystem::create_directories(dir, ec);
+    m_storageFile = dir / kCacheFileName;
+    loadLocked();
+}
+
+void MediaInfoCache::loadLocked()
+{
+    std::ifstream in(m_storageFile);
+    if (!in)
+        return;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        // path, size, mtime, codec, rate, channels, frames, backend, seekTable
+        const std::vector<std::string> f = splitTabs(line);
+        if (f.size() != 9)
+            continue;
+
+        Entry entry;
+        try {
+            entry.info.fileSize = std::stoull(f[1]);
+            entry.info.modifiedTime = std::stoll(f[2]);
+            entry.info.codec = f[3];
+            entry.info.nativeSampleRate = (uint32_t)std::stoul(f[4]);
+            entry.info.channels = (uint32_t)std::stoul(f[5]);
+            entry.info.frameCount = std::stoull(f[6]);
+            entry.info.backend = static_cast<DecoderBackend>(std::stoi(f[7]));
+            entry.info.hasSeekTable = f[8] == "1";
+        } catch (...) {
+            continue;
+        }
+        if (!entry.info.isValid())
+            continue;
+
+        m_extensionBackend[fileExtension(f[0])] = entry.info.backend;
+        m_entries[f[0]] = std::move(entry);
+    }
+}
+
+void MediaInfoCache::saveLocked() const
+{
+    if (m_storageFile.empty())
+        return;
+
+    std::filesystem::path tmpFile = m_storageFile;
+    tmpFile += ".tmp";
+    {
+        std::ofstream out(tmpFile, std::ios::trunc);
+        if (!out)
+            return;
+
+        out << kCacheHeader << "\n";
+        for (const auto& [path, entry] : m_entries) {
+            const MediaInfo& i = entry.info;
+            out << path << '\t' << i.fileSize << '\t' << i.modifiedTime << '\t' << i.codec << '\t'
+                << i.nativeSampleRate << '\t' << i.channels << '\t' << i.frameCount << '\t' << (int)i.backend << '\t'
+                << (i.hasSeekTable ? 1 : 0) << "\n";
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpFile, m_storageFile, ec);
+    if (ec) {
+        std::cerr << "[MediaInfoCache] Failed to write " << m_storageFile.string() << ": " << ec.message() << "\n";
+    }
+}
+
+void MediaInfoCache::markDirtyLocked()
+{
+    m_dirty = true;
+    m_lastChange = std::chrono::steady_clock::now();
+}
+
+void MediaInfoCache::flush(std::chrono::milliseconds settle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_dirty || std::chrono::steady_clock::now() - m_lastChange < settle)
+        return;
+
+    saveLocked();
+    m_dirty = false;
+}
+
+std::filesystem::path MediaInfoCache::seekIndexFileLocked(const std::string& filePath) const
+{
+    if (m_storageFile.empty())
+        return std::filesystem::path();
+    return m_storageFile.parent_path() / kSeekIndexDir / (pathHash(filePath) + ".idx");
+}
+
+// ------------------------------------------------------------
+// Lookup / probe
+// ------------------------------------------------------------
+std::optional<MediaInfo> MediaInfoCache::lookup(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(filePath);
+    if (it == m_entries.end())
+        return std::nullopt;
+
+    if (!it->second.verified) {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        if (!statFile(filePath, size, mtime) || size != it->second.info.fileSize ||
+            mtime != it->second.info.modifiedTime) {
+            // File was replaced (normalize/effects write new files, users edit files in place)
+            m_entries.erase(it);
+            m_seekIndexes.erase(filePath);
+            return std::nullopt;
+        }
+        it->second.verified = true;
+    }
+
+    return it->second.info;
+}
+
+MediaInfo MediaInfoCache::probe(const std::string& filePath)
+{
+    if (auto cached = lookup(filePath)) {
+        // e.g. the app was closed before last session's build finished
+        if (!cached->hasSeekTable && wantsSeekIndex(*cached))
+            queueSeekIndex(filePath);
+        return *cached;
+    }
+
+    MediaInfo info = probeFile(filePath, preferredBackend(filePath));
+    if (!info.isValid())
+        return info;
+
+    store(filePath, info);
+    if (wantsSeekIndex(info))
+        queueSeekIndex(filePath);
+    return info;
+}
+
+std::shared_ptr<const SeekIndex> MediaInfoCache::seekIndex(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto cached = m_seekIndexes.find(filePath);
+    if (cached != m_seekIndexes.end())
+        return cached->second;
+
+    auto it = m_entries.find(filePath);
+    if (it == m_entries.end() || !it->second.info.hasSeekTable)
+        return nullptr;
+
+    auto index = std::make_shared<SeekIndex>();
+    if (!index->load(seekIndexFileLocked(filePath))) {
+        // Sidecar missing or stale format - next probe rebuilds it
+        m_entries.erase(it);
+        markDirtyLocked();
+        return nullptr;
+    }
+
+    m_seekIndexes[filePath] = index;
+    return index;
+}
+
+void MediaInfoCache::store(const std::string& filePath, const MediaInfo& info)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entry& entry = m_entries[filePath];
+    entry.info = info;
+    entry.verified = true;
+    if (info.backend != DecoderBackend::Unknown) {
+        m_extensionBackend[fileExtension(filePath)] = info.backend;
+    }
+    markDirtyLocked();
+}
+
+void MediaInfoCache::updateBackend(const std::string& filePath, DecoderBackend backend)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_extensionBackend[fileExtension(filePath)] = backend;
+
+    auto it = m_entries.find(filePath);
+    if (it != m_entries.end() && it->second.info.backend != backend) {
+        it->second.info.backend = backend;
+        markDirtyLocked();
+    }
+}
+
+void MediaInfoCache::invalidate(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_seekIndexes.erase(filePath);
+    if (m_entries.erase(filePath) > 0) {
+        std::error_code ec;
+        std::filesystem::remove(seekIndexFileLocked(filePath), ec);
+        markDirtyLocked();
+    }
+}
+
+// ------------------------------------------------------------
+// Seek index builds
+// ------------------------------------------------------------
+bool MediaInfoCache::wantsSeekIndex(const MediaInfo& info)
+{
+    // Same rule as ClipDecoder::buildSeekIndex: WAV/FLAC/PCM seek by arithmetic already
+    if (info.backend == DecoderBackend::Miniaudio)
+        return info.codec == "mp3";
+    if (info.backend == DecoderBackend::FFmpeg)
+        return info.codec.rfind("pcm_", 0) != 0;
+    return false;
+}
+
+void MediaInfoCache::queueSeekIndex(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_quit.load(std::memory_order_relaxed) || m_seekIndexes.count(filePath) > 0 ||
+        m_indexPending.count(filePath) > 0 || m_indexFailed.count(filePath) > 0)
+        return;
+
+    m_indexPending.insert(filePath);
+    m_indexJobs.push_back(filePath);
+    if (!m_indexWorker.joinable())
+        m_indexWorker = std::thread(&MediaInfoCache::seekIndexWorkerLoop, this);
+    m_indexCv.notify_one();
+}
+
+void MediaInfoCache::seekIndexWorkerLoop()
+{
+    for (;;) {
+        std::string filePath;
+        DecoderBackend backend = DecoderBackend::Unknown;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_indexCv.wait(lock, [this] { return m_quit.load(std::memory_order_relaxed) || !m_indexJobs.empty(); });
+            if (m_quit.load(std::memory_order_relaxed))
+                return;
+            filePath = std::move(m_indexJobs.front());
+            m_indexJobs.pop_front();
+            auto it = m_entries.find(filePath);
+            if (it != m_entries.end())
+                backend = it->second.info.backend;
+        }
+
+        SeekIndex index;
+        const MediaInfo scanned = probeFile(filePath, backend, &index);
+
+        std::shared_ptr<const SeekIndex> built;
+        std::filesystem::path indexFile;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_indexPending.erase(filePath);
+
+            // Dropped or replaced on disk while we scanned: the next probe queues it again
+            auto it = m_entries.find(filePath);
+            if (it == m_entries.end() || it->second.info.fileSize != scanned.fileSize ||
+                it->second.info.modifiedTime != scanned.modifiedTime)
+                continue;
+
+            if (!scanned.isValid() || index.empty()) {
+                m_indexFailed.insert(filePath);
+                continue;
+            }
+
+            built = std::make_shared<const SeekIndex>(std::move(index));
+            m_seekIndexes[filePath] = built; // serves this session even if the sidecar cannot be written
+            indexFile = seekIndexFileLocked(filePath);
+        }
+
+        if (indexFile.empty() || !built->save(indexFile))
+            continue;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(filePath);
+        auto current = m_seekIndexes.find(filePath);
+        if (it != m_entries.end() && current != m_seekIndexes.end() && current->second == built) {
+            it->second.info.hasSeekTable = true;
+            markDirtyLocked();
+        }
+    }
+}
+
+DecoderBackend MediaInfoCache::preferredBackend(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(filePath);
+    if (it != m_entries.end())
+        return it->second.info.backend;
+
+    auto ext = m_extensionBackend.find(fileExtension(filePath));
+    if (ext != m_extensionBackend.end())
+        return ext->second;
+
+    return DecoderBackend::Unknown;
+}
+
+MediaInfo MediaInfoCache::probeFile(const std::string& filePath, DecoderBackend preferred, SeekIndex* seekIndexOut)
+{
+    MediaInfo info;
+    if (!statFile(filePath, info.fileSize, info.modifiedTime))
+        return info;
+
+    // Native format: no resampling, no channel conversion
+    ClipDecoder decoder;
+    if (!decoder.open(filePath, 0, 0, preferred))
+        return info;
+
+    info.codec = decoder.codecName();
+    info.nativeSampleRate = decoder.getSampleRate();
+    info.channels = decoder.getChannels();
+    info.frameCount = decoder.getLengthInPcmFrames();
+    info.backend = decoder.backend();
+
+    if (seekIndexOut != nullptr && decoder.buildSeekIndex(*seekIndexOut)) {
+        info.hasSeekTable = true;
+    }
+    return info;
+}
+
+// ------------------------------------------------------------
+// Helpers
+// ------------------------------------------------------------
+bool MediaInfoCache::statFile(const std::string& filePath, uint64_t& size, int64_t& modifiedTime)
+{
+    std::error_code ec;
+    const std::filesystem::path p = pathFromUtf8(filePath);
+
+    size = std::filesystem::file_size(p, ec);
+    if (ec)
+        return false;
+
+    const auto mtime = std::filesystem::last_write_time(p, ec);
+    if (ec)
+        return false;
+    modifiedTime = (int64_t)mtime.time_since_epoch().count();
+    return true;
+}
+
+std::string MediaInfoCache::fileExtension(const std::string& filePath)
+{
+    const size_t dot = filePath.find_last_of('.');
+    const size_t slash = filePath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return std::string();
+
+    std::string ext = filePath.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "seekIndex.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Which decoder implementation handles a file
+enum class DecoderBackend : uint8_t {
+    Unknown = 0,
+    Miniaudio = 1,
+    FFmpeg = 2
+};
+
+/**
+ * @brief Probed properties of an audio file
+ *
+ * Frame count is expressed at the file's native sample rate.
+ * fileSize/modifiedTime identify the version of the file the info was probed from.
+ */
+struct MediaInfo
+{
+    std::string codec; // e.g. "mp3", "flac", "opus"
+    uint32_t nativeSampleRate = 0;
+    uint32_t channels = 0;
+    uint64_t frameCount = 0;
+    DecoderBackend backend = DecoderBackend::Unknown;
+    bool hasSeekTable = false;
+
+    uint64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+
+    bool isValid() const { return backend != DecoderBackend::Unknown && nativeSampleRate > 0 && frameCount > 0; }
+    double durationSec() const { return nativeSampleRate > 0 ? (double)frameCount / (double)nativeSampleRate : 0.0; }
+};
+
+/**
+ * @brief Thread-safe, persisted cache of MediaInfo keyed by file path
+ *
+ * Entries loaded from disk are re-validated against the file's size and
+ * modification time the first time they are used in a session; after that
+ * lookups are pure in-memory operations.
+ *
+ * The cache also remembers which backend ended up decoding each file
+ * extension, so a new file of a type miniaudio cannot open (e.g. Opus)
+ * goes straight to FFmpeg instead of failing through miniaudio first.
+ *
+ * Compressed files also get a seek index, built by scanning the file on a
+ * background thread after the probe (a long MP3 takes a while to scan). It is
+ * stored as a sidecar under <storage dir>/seek/ and loaded on demand by
+ * seekIndex(); until it exists seekIndex() returns nullptr and decoders seek
+ * the plain way.
+ *
+ * Changes are only written to disk by flush() (and on destruction), so
+ * importing many files rewrites the cache file once rather than per file.
+ *
+ * Not for use from the audio callbacks (takes a mutex).
+ */
+class MediaInfoCache
+{
+public:
+    MediaInfoCache() = default;
+    ~MediaInfoCache();
+
+    MediaInfoCache(const MediaInfoCache&) = delete;
+    MediaInfoCache& operator=(const MediaInfoCache&) = delete;
+
+    // Directory where the cache file lives; loads any persisted entries
+    void setStorageDirectory(const std::string& directory);
+
+    // Cached info only (no decoding). Returns nullopt on miss or if the file changed.
+    std::optional<MediaInfo> lookup(const std::string& filePath);
+
+    // Cached info, or probe the file and remember the result. Invalid info on failure.
+    // Queues the seek index build for files that need one; never scans the whole file itself.
+    MediaInfo probe(const std::string& filePath);
+
+    // Seek index for the file, or nullptr if it has none (yet)
+    std::shared_ptr<const SeekIndex> seekIndex(const std::string& filePath);
+
+    // Record info for a file (e.g. after a decoder had to fall back to another backend)
+    void store(const std::string& filePath, const MediaInfo& info);
+    void updateBackend(const std::string& filePath, DecoderBackend backend);
+    void invalidate(const std::string& filePath);
+
+    // Backend to try first for this file (file entry, then per-extension history)
+    DecoderBackend preferredBackend(const std::string& filePath);
+
+    // Write pending changes to disk, once nothing has changed for at least `settle`
+    void flush(std::chrono::milliseconds settle = std::chrono::milliseconds(0));
+
+    // Open the file with a throwaway decoder and read its native properties.
+    // With seekIndexOut set, also scans the file once to build its seek index.
+    static MediaInfo probeFile(const std::string& filePath, DecoderBackend preferred = DecoderBackend::Unknown,
+                               SeekIndex* seekIndexOut = nullptr);
+
+    static bool statFile(const std::string& filePath, uint64_t& size, int64_t& modifiedTime);
+    static std::string fileExtension(const std::string& filePath);
+
+private:
+    struct Entry
+    {
+        MediaInfo info;
+        bool verified = false; // checked against the file on disk this session
+    };
+
+    void loadLocked();
+    void saveLocked() const;
+    void markDirtyLocked();
+    void queueSeekIndex(const std::string& filePath);
+    void seekIndexWorkerLoop();
+    static bool wantsSeekIndex(const MediaInfo& info);
+    std::filesystem::path seekIndexFileLocked(const std::string& filePath) const;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_entries;
+    std::unordered_map<std::string, DecoderBackend> m_extensionBackend;
+    std::unordered_map<std::string, std::shared_ptr<const SeekIndex>> m_seekIndexes;
+    std::filesystem::path m_storageFile;
+    bool m_dirty = false;
+    std::chrono::steady_clock::time_point m_lastChange;
+
+    // Background seek index builds
+    std::condition_variable m_indexCv;
+    std::deque<std::string> m_indexJobs;
+    std::set<std::string> m_indexPending; // queued or being scanned
+    std::set<std::string> m_indexFailed;  // not retried this session
+    std::atomic<bool> m_quit{false};
+    std::thread m_indexWorker; // started with the first job
+};
@@ -14,3 +14,75 @@
 // (must be after miniaudio since it uses the declarations above)
 #undef STB_VORBIS_HEADER_ONLY
 #include "stb_vorbis.c"
+
+// ------------------------------------------------------------
+// MP3 seek tables
+// ma_mp3 / ma_dr_mp3 are only visible in the implementation, so the
+// helpers that read and bind dr_mp3 seek points live here.
+// ------------------------------------------------------------
+#include "seekIndex.h"
+
+#include <vector>
+
+static ma_mp3* mp3Backend(ma_decoder* decoder)
+{
+    if (decoder == nullptr || decoder->pBackendVTable != &g_ma_decoding_backend_vtable_mp3)
+        return nullptr;
+    return (ma_mp3*)decoder->pBackend;
+}
+
+bool buildMp3SeekIndex(ma_decoder* decoder, uint32_t pointCount, SeekIndex& out)
+{
+    ma_mp3* mp3 = mp3Backend(decoder);
+    if (mp3 == nullptr || pointCount == 0)
+        return false;
+
+    std::vector<ma_dr_mp3_seek_point> points(pointCount);
+    ma_uint32 count = pointCount;
+    if (!ma_dr_mp3_calculate_seek_points(&mp3->dr, &count, points.data()) || count == 0)
+        return false;
+
+    out.kind = SeekIndex::Kind::Mp3SeekPoints;
+    out.points.clear();
+    out.points.reserve(count);
+    for (ma_uint32 i = 0; i < count; ++i) {
+        SeekIndex::Point p;
+        p.pcmFrame = points[i].pcmFrameIndex;
+        p.bytePos = (int64_t)points[i].seekPosInBytes;
+        p.mp3FramesToDiscard = points[i].mp3FramesToDiscard;
+        p.pcmFramesToDiscard = points[i].pcmFramesToDiscard;
+        out.points.push_back(p);
+    }
+    return true;
+}
+
+bool bindMp3SeekIndex(ma_decoder* decoder, const SeekIndex& index)
+{
+    ma_mp3* mp3 = mp3Backend(decoder);
+    if (mp3 == nullptr || index.kind != SeekIndex::Kind::Mp3SeekPoints || index.points.empty())
+        return false;
+
+    const ma_uint32 count = (ma_uint32)index.points.size();
+    ma_dr_mp3_seek_point* points =
+        (ma_dr_mp3_seek_point*)ma_malloc(sizeof(ma_dr_mp3_seek_point) * count, &decoder->allocationCallbacks);
+    if (points == nullptr)
+        return false;
+
+    for (ma_uint32 i = 0; i < count; ++i) {
+        points[i].seekPosInBytes = (ma_uint64)index.points[i].bytePos;
+        points[i].pcmFrameIndex = index.points[i].pcmFrame;
+        points[i].mp3FramesToDiscard = index.points[i].mp3FramesToDiscard;
+        points[i].pcmFramesToDiscard = index.points[i].pcmFramesToDiscard;
+    }
+
+    if (!ma_dr_mp3_bind_seek_table(&mp3->dr, count, points)) {
+        ma_free(points, &decoder->allocationCallbacks);
+        return false;
+    }
+
+    // ma_mp3_uninit() frees whatever table is attached here
+    ma_free(mp3->pSeekPoints, &decoder->allocationCallbacks);
+    mp3->pSeekPoints = points;
+    mp3->seekPointCount = count;
+    return true;
+}
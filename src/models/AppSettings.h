@@ -24,10 +24,23 @@ struct AppSettings
     // Noise cancellation settings (WebRTC APM)
     // Level: 0=Off, 1=Low, 2=Moderate, 3=High, 4=VeryHigh
     int noiseSuppressionLevel = 2; // Default to Moderate
+    bool noiseSuppressionOnDspThread = false; // Off the capture callback, +1 buffer +10 ms (applies on restart)
+    int recordingInputNoiseSuppressionLevel = 2; // Extra recording device, same scale
 
     // Audio buffer settings
     int bufferSizeFrames = 1024;    // Period size in frames (512, 1024, 2048, 4096)
     int bufferPeriods = 3;          // Number of periods (2, 3, 4)
-    int sampleRate = 48000;         // Sample rate (44100, 48000, 96000)
+    int sampleRate = 0;             // Sample rate (44100, 48000, 96000; 0 = playback device's native rate)
     int channels = 2;               // Channels (1=Mono, 2=Stereo)
+    int resamplerQuality = 2;       // Clips at another rate: 0=Linear, 1=Sinc16, 2=Sinc32, 3=Sinc64
+
+    double clipFadeMs = 5.0; // De-click fade at trim points and on stop (0 = off)
+    int voiceStealPolicy = 0; // All voices busy: 0=Oldest, 1=Quietest, 2=Lowest priority
+
+    // Duck clips on the main output while the mic picks up speech
+    bool voiceDuckingEnabled = false;
+    double voiceDuckThreshold = 0.6; // VAD probability 0..1
+    double voiceDuckAttackMs = 10.0;
+    double voiceDuckReleaseMs = 400.0;
+    double voiceDuckDepthDb = -12.0;
 };
@@ -28,6 +28,9 @@ struct Clip
 
     bool isPlaying = false; // UI state
     bool isRepeat = false;  // loop flag
+    double loopCrossfadeMs = 0.0; // equal-power crossfade at the loop point (0 = hard gapless loop)
+    int polyphony = 1;            // Overlay mode: instances of this clip that may sound at once
+    int voicePriority = 0;        // 0-10; higher is stolen last under the "lowest priority" policy
     bool locked = false;    // read-only while playing
 
     // Reproduction mode (0=Overlay, 1=Play/Pause, 2=Play/Stop, 3=Repeat,   4=Loop)
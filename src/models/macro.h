@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+struct MacroStep
+{
+    // Stored by name in macros.json, so only append
+    enum class Type {
+        PlayClip,    // start clipId
+        StopClip,    // stop clipId
+        Wait,        // pause the sequence for durationMs
+        WaitClipEnd, // until clipId (started earlier in this macro) reaches its end
+        SetGain,     // clipId's volume to gainDb
+        DuckMic,     // mic by gainDb (0 = restore)
+        StopAll      // every playing clip
+    };
+
+    Type type = Type::Wait;
+    int clipId = -1;
+    double durationMs = 0.0;
+    double gainDb = 0.0;
+};
+
+struct Macro
+{
+    int id = -1;
+    QString name;
+    QString hotkey; // e.g. "Ctrl+Shift+1"
+    QVector<MacroStep> steps;
+};
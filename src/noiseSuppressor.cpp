@@ -1,6 +1,9 @@
 #include "noiseSuppressor.h"
 
+#include "resampler.h"
+
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -11,20 +14,75 @@
     // RNNoise header
     #include <rnnoise.h>
 
+namespace
+{
+// Host audio is pushed through the pipeline in pieces of at most this many frames,
+// which bounds every FIFO below no matter how large a callback block is
+constexpr int kHostChunkFrames = 256;
+
+// Quality of the host <-> 48 kHz conversion: flat well past the speech band, ~1 ms lookahead
+constexpr ResamplerQuality kResamplerQuality = ResamplerQuality::Sinc32;
+
+/**
+ * @brief Fixed-capacity sample FIFO with contiguous read and write spans
+ *
+ * Unread samples are moved to the front when the write span runs short, so the
+ * resampler and RNNoise can work on plain pointers. Never grows after allocate().
+ */
+struct SampleFifo
+{
+    std::vector<float> data;
+    size_t head = 0;
+    size_t tail = 0;
+
+    void allocate(size_t capacity)
+    {
+        data.assign(capacity, 0.0f);
+        clear();
+    }
+    void clear() { head = tail = 0; }
+    size_t size() const { return tail - head; }
+    const float* readPtr() const { return data.data() + head; }
+    void consume(size_t n)
+    {
+        head += n;
+        if (head == tail)
+            head = tail = 0;
+    }
+
+    // Writable span at the end, compacted first if that makes it longer
+    float* writePtr(size_t& room)
+    {
+        if (head > 0) {
+            std::memmove(data.data(), data.data() + head, size() * sizeof(float));
+            tail -= head;
+            head = 0;
+        }
+        room = data.size() - tail;
+        return data.data() + tail;
+    }
+    void commit(size_t n) { tail += n; }
+};
+} // namespace
+
 // Implementation struct containing RNNoise state
 struct NoiseSuppressor::Impl
 {
     DenoiseState* denoiseState = nullptr;
 
-    // Buffer for RNNoise processing (480 samples at 48kHz)
-    std::vector<float> rnnoiseBuffer;
+    // One RNNoise frame, in RNNoise's int16 scale (processed in place)
+    float rnnoiseFrame[RNNOISE_FRAME_SIZE] = {};
 
-    // Resampling buffers (for non-48kHz audio)
-    std::vector<float> resampleInputBuffer;
-    std::vector<float> resampleOutputBuffer;
+    // Host rate -> 48 kHz -> RNNoise -> host rate, state kept across calls
+    bool resampling = false;
+    Resampler upsampler;
+    Resampler downsampler;
+    SampleFifo input48k;  // waiting for a complete RNNoise frame
+    SampleFifo output48k; // denoised, waiting to be resampled back
+    SampleFifo output;    // at the host rate; primed with the latency so reads never run dry
 
-    // Leftover samples from previous process() call
-    std::vector<float> leftoverSamples;
+    // Set when processing (re)starts after being off; the audio thread resets the streams
+    std::atomic<bool> resetPending{true};
 
     ~Impl()
     {
@@ -36,9 +94,10 @@ struct NoiseSuppressor::Impl
 };
 
 NoiseSuppressor::NoiseSuppressor(int sampleRate, NoiseSuppressionLevel level)
-    : m_sampleRate(sampleRate), m_level(level), m_previousLevel(level), m_impl(std::make_unique<Impl>())
+    : m_sampleRate(sampleRate), m_level(NoiseSuppressionLevel::Off), m_previousLevel(level),
+      m_impl(std::make_unique<Impl>())
 {
-    // Update attenuation factor based on level
+    // Update attenuation factor based on level (starting from Off, so the call is never a no-op)
     setSuppressionLevel(level);
 }
 
@@ -67,23 +126,31 @@ bool NoiseSuppressor::init()
             return false;
         }
 
-        // Allocate buffer for RNNoise (fixed 480 samples)
-        m_impl->rnnoiseBuffer.resize(RNNOISE_FRAME_SIZE);
-
-        // Allocate resampling buffers if needed
-        if (m_sampleRate != RNNOISE_SAMPLE_RATE) {
-            // Calculate max buffer size needed for resampling
-            // For simplicity, we'll use a generous buffer
-            int maxFrames = (RNNOISE_FRAME_SIZE * m_sampleRate) / RNNOISE_SAMPLE_RATE + 16;
-            m_impl->resampleInputBuffer.resize(maxFrames);
-            m_impl->resampleOutputBuffer.resize(maxFrames);
+        // Everything process() touches is sized here, for the worst case of one host chunk
+        const double toHost = (double)m_sampleRate / RNNOISE_SAMPLE_RATE;
+        const size_t chunk48k = (size_t)std::ceil(kHostChunkFrames / toHost) + 2;
+        m_impl->resampling = m_sampleRate != RNNOISE_SAMPLE_RATE;
+        if (m_impl->resampling) {
+            if (!m_impl->upsampler.init(1, (uint32_t)m_sampleRate, RNNOISE_SAMPLE_RATE, kResamplerQuality) ||
+                !m_impl->downsampler.init(1, RNNOISE_SAMPLE_RATE, (uint32_t)m_sampleRate, kResamplerQuality)) {
+                std::cerr << "[NoiseSuppressor] Unsupported sample rate " << m_sampleRate << "\n";
+                return false;
+            }
+            // A frame can only be denoised once it is complete, and each resampler waits for its lookahead
+            m_latencyFrames = (int)m_impl->upsampler.inputLookahead() +
+                              (int)std::ceil((RNNOISE_FRAME_SIZE + m_impl->downsampler.inputLookahead()) * toHost) + 2;
+        } else {
+            m_latencyFrames = RNNOISE_FRAME_SIZE;
         }
-
-        m_impl->leftoverSamples.clear();
+        m_impl->input48k.allocate(RNNOISE_FRAME_SIZE + chunk48k);
+        m_impl->output48k.allocate(2 * RNNOISE_FRAME_SIZE + chunk48k);
+        m_impl->output.allocate((size_t)m_latencyFrames + 2 * kHostChunkFrames +
+                                (size_t)std::ceil(2 * RNNOISE_FRAME_SIZE * toHost) + 16);
+        m_impl->resetPending.store(true, std::memory_order_relaxed);
 
         m_initialized = true;
         std::cout << "[NoiseSuppressor] RNNoise initialized with sample rate " << m_sampleRate << ", level "
-                  << static_cast<int>(m_level) << "\n";
+                  << static_cast<int>(m_level) << ", latency " << m_latencyFrames << " frames\n";
         return true;
 
     } catch (const std::exception& e) {
@@ -92,142 +159,156 @@ bool NoiseSuppressor::init()
     }
 }
 
-// Simple linear resampling helper
-static void resampleLinear(const float* input, int inputLen, float* output, int outputLen)
+void NoiseSuppressor::resetStreams()
 {
-    if (inputLen <= 0 || outputLen <= 0)
-        return;
+    m_impl->upsampler.reset();
+    m_impl->downsampler.reset();
+    m_impl->input48k.clear();
+    m_impl->output48k.clear();
+    m_impl->output.clear();
+
+    // The reported latency is exactly this much silence ahead of the first processed sample
+    size_t room = 0;
+    float* primed = m_impl->output.writePtr(room);
+    std::fill(primed, primed + m_latencyFrames, 0.0f);
+    m_impl->output.commit((size_t)m_latencyFrames);
+}
 
-    float ratio = static_cast<float>(inputLen - 1) / static_cast<float>(outputLen - 1);
-    for (int i = 0; i < outputLen; ++i) {
-        float srcIdx = i * ratio;
-        int idx0 = static_cast<int>(srcIdx);
-        int idx1 = std::min(idx0 + 1, inputLen - 1);
-        float frac = srcIdx - idx0;
-        output[i] = input[idx0] * (1.0f - frac) + input[idx1] * frac;
+void NoiseSuppressor::denoiseFrame(const float* in, float* out)
+{
+    float* frame = m_impl->rnnoiseFrame;
+
+    // RNNoise expects values in range [-32768, 32767]
+    for (int i = 0; i < RNNOISE_FRAME_SIZE; ++i) {
+        frame[i] = in[i] * 32767.0f;
+    }
+
+    m_lastVadProbability = rnnoise_process_frame(m_impl->denoiseState, frame, frame);
+
+    // Blend between original and processed based on attenuation
+    const float wet = m_attenuationFactor;
+    for (int i = 0; i < RNNOISE_FRAME_SIZE; ++i) {
+        out[i] = (frame[i] / 32767.0f) * wet + in[i] * (1.0f - wet);
     }
 }
 
-void NoiseSuppressor::process(float* samples, int frameCount)
+bool NoiseSuppressor::isProcessing() const
 {
-    if (!m_initialized || !m_impl->denoiseState || m_level == NoiseSuppressionLevel::Off) {
-        return; // Pass through unchanged
-    }
+    return m_initialized && m_impl->denoiseState && m_level != NoiseSuppressionLevel::Off;
+}
 
-    // RNNoise expects audio at 48kHz
-    // If our sample rate is different, we need to resample
-
-    if (m_sampleRate == RNNOISE_SAMPLE_RATE) {
-        // Direct processing at 48kHz
-        // Combine leftover samples with new samples
-        std::vector<float> combinedSamples;
-        combinedSamples.reserve(m_impl->leftoverSamples.size() + frameCount);
-        combinedSamples.insert(combinedSamples.end(), m_impl->leftoverSamples.begin(), m_impl->leftoverSamples.end());
-        combinedSamples.insert(combinedSamples.end(), samples, samples + frameCount);
-
-        int totalSamples = static_cast<int>(combinedSamples.size());
-        int processedSamples = 0;
-        int outputIdx = 0;
-
-        // Process complete frames
-        while (processedSamples + RNNOISE_FRAME_SIZE <= totalSamples) {
-            // Copy to RNNoise buffer (RNNoise expects values in range [-32768, 32767])
-            for (int i = 0; i < RNNOISE_FRAME_SIZE; ++i) {
-                m_impl->rnnoiseBuffer[i] = combinedSamples[processedSamples + i] * 32767.0f;
-            }
+bool NoiseSuppressor::providesVad() const
+{
+    return isProcessing();
+}
 
-            // Process with RNNoise
-            float vad =
-                rnnoise_process_frame(m_impl->denoiseState, m_impl->rnnoiseBuffer.data(), m_impl->rnnoiseBuffer.data());
-            m_lastVadProbability = vad;
+void NoiseSuppressor::pushHost(const float* block, size_t frames)
+{
+    Impl& d = *m_impl;
+    if (d.resetPending.exchange(false, std::memory_order_acq_rel)) {
+        resetStreams();
+    }
 
-            // Apply attenuation based on suppression level and copy back
-            // The attenuation factor adjusts how aggressively we suppress
-            for (int i = 0; i < RNNOISE_FRAME_SIZE; ++i) {
-                float processed = m_impl->rnnoiseBuffer[i] / 32767.0f;
+    // Host rate -> 48 kHz
+    size_t room = 0;
+    float* dst = d.input48k.writePtr(room);
+    if (d.resampling) {
+        size_t inFrames = frames;
+        size_t outFrames = room;
+        d.upsampler.process(block, inFrames, dst, outFrames);
+        d.input48k.commit(outFrames);
+    } else {
+        const size_t count = std::min(frames, room);
+        std::memcpy(dst, block, count * sizeof(float));
+        d.input48k.commit(count);
+    }
+}
 
-                // Blend between original and processed based on attenuation
-                float original = combinedSamples[processedSamples + i];
-                combinedSamples[processedSamples + i] =
-                    processed * m_attenuationFactor + original * (1.0f - m_attenuationFactor);
-            }
+bool NoiseSuppressor::denoiseNext()
+{
+    Impl& d = *m_impl;
+    if (d.input48k.size() < (size_t)RNNOISE_FRAME_SIZE)
+        return false;
 
-            processedSamples += RNNOISE_FRAME_SIZE;
-        }
+    SampleFifo& denoised = d.resampling ? d.output48k : d.output;
+    size_t room = 0;
+    float* out = denoised.writePtr(room);
+    if (room < (size_t)RNNOISE_FRAME_SIZE)
+        return false; // cannot happen with init()'s sizes; keep the samples for the next call
 
-        // Copy processed samples back to output (only the new samples, not leftovers)
-        int leftoverCount = static_cast<int>(m_impl->leftoverSamples.size());
-        int outputCount = std::min(frameCount, static_cast<int>(combinedSamples.size()) - leftoverCount);
-        for (int i = 0; i < outputCount; ++i) {
-            samples[i] = combinedSamples[leftoverCount + i];
-        }
+    denoiseFrame(d.input48k.readPtr(), out);
+    denoised.commit(RNNOISE_FRAME_SIZE);
+    d.input48k.consume(RNNOISE_FRAME_SIZE);
+    return true;
+}
 
-        // Save leftover samples for next call
-        m_impl->leftoverSamples.clear();
-        if (processedSamples < totalSamples) {
-            // Keep unprocessed samples as leftovers
-            int remainingNew = totalSamples - processedSamples;
-            // But only keep what came from the new input
-            int newLeftovers = std::max(0, remainingNew - leftoverCount);
-            if (newLeftovers > 0) {
-                m_impl->leftoverSamples.insert(m_impl->leftoverSamples.end(),
-                                               combinedSamples.begin() + processedSamples, combinedSamples.end());
-            }
+void NoiseSuppressor::pullHost(float* block, size_t frames)
+{
+    Impl& d = *m_impl;
+
+    // 48 kHz -> host rate
+    if (d.resampling) {
+        while (d.output48k.size() > 0) {
+            size_t room = 0;
+            float* out = d.output.writePtr(room);
+            size_t inFrames = d.output48k.size();
+            size_t outFrames = room;
+            d.downsampler.process(d.output48k.readPtr(), inFrames, out, outFrames);
+            d.output.commit(outFrames);
+            d.output48k.consume(inFrames);
+            if (inFrames == 0 && outFrames == 0)
+                break;
         }
+    }
 
-    } else {
-        // Need to resample to 48kHz, process, then resample back
-        // Calculate equivalent frame count at 48kHz
-        int frames48k = (frameCount * RNNOISE_SAMPLE_RATE) / m_sampleRate;
-
-        if (frames48k < RNNOISE_FRAME_SIZE) {
-            // Not enough samples for a full RNNoise frame
-            // Just pass through for now (could accumulate for better handling)
-            return;
-        }
+    // Oldest frames out; the primed latency covers everything still in flight
+    const size_t ready = std::min(frames, d.output.size());
+    std::memcpy(block, d.output.readPtr(), ready * sizeof(float));
+    std::fill(block + ready, block + frames, 0.0f);
+    d.output.consume(ready);
+}
 
-        // Ensure buffers are large enough
-        if (m_impl->resampleInputBuffer.size() < static_cast<size_t>(frames48k)) {
-            m_impl->resampleInputBuffer.resize(frames48k);
-        }
-        if (m_impl->resampleOutputBuffer.size() < static_cast<size_t>(frames48k)) {
-            m_impl->resampleOutputBuffer.resize(frames48k);
+void NoiseSuppressor::process(float* samples, int frameCount)
+{
+    NoiseSuppressor* self = this;
+    processBatch(&self, &samples, 1, frameCount);
+}
+
+void NoiseSuppressor::processBatch(NoiseSuppressor* const* suppressors, float* const* samples, int count,
+                                   int frameCount)
+{
+    // Fixed-size groups keep this allocation-free; which streams run is decided once per group
+    constexpr int kGroup = NoiseSuppressorPool::MAX_STREAMS;
+    for (int first = 0; first < count; first += kGroup) {
+        NoiseSuppressor* group[kGroup];
+        float* blocks[kGroup];
+        int active = 0;
+        for (int i = first; i < std::min(count, first + kGroup); ++i) {
+            if (suppressors[i] && samples[i] && suppressors[i]->isProcessing()) {
+                group[active] = suppressors[i];
+                blocks[active] = samples[i];
+                ++active;
+            }
         }
 
-        // Upsample to 48kHz
-        resampleLinear(samples, frameCount, m_impl->resampleInputBuffer.data(), frames48k);
+        for (int done = 0; done < frameCount;) {
+            const size_t n = (size_t)std::min(frameCount - done, kHostChunkFrames);
 
-        // Process at 48kHz
-        int processed = 0;
-        while (processed + RNNOISE_FRAME_SIZE <= frames48k) {
-            // Copy to RNNoise buffer
-            for (int i = 0; i < RNNOISE_FRAME_SIZE; ++i) {
-                m_impl->rnnoiseBuffer[i] = m_impl->resampleInputBuffer[processed + i] * 32767.0f;
-            }
+            for (int s = 0; s < active; ++s)
+                group[s]->pushHost(blocks[s] + done, n);
 
-            // Process
-            float vad =
-                rnnoise_process_frame(m_impl->denoiseState, m_impl->rnnoiseBuffer.data(), m_impl->rnnoiseBuffer.data());
-            m_lastVadProbability = vad;
-
-            // Copy back with attenuation
-            for (int i = 0; i < RNNOISE_FRAME_SIZE; ++i) {
-                float processedSample = m_impl->rnnoiseBuffer[i] / 32767.0f;
-                float original = m_impl->resampleInputBuffer[processed + i];
-                m_impl->resampleOutputBuffer[processed + i] =
-                    processedSample * m_attenuationFactor + original * (1.0f - m_attenuationFactor);
+            // One frame per stream per round, so consecutive rnnoise_process_frame calls share warm weights
+            for (bool any = true; any;) {
+                any = false;
+                for (int s = 0; s < active; ++s)
+                    any |= group[s]->denoiseNext();
             }
 
-            processed += RNNOISE_FRAME_SIZE;
-        }
+            for (int s = 0; s < active; ++s)
+                group[s]->pullHost(blocks[s] + done, n);
 
-        // Copy remaining unprocessed samples
-        for (int i = processed; i < frames48k; ++i) {
-            m_impl->resampleOutputBuffer[i] = m_impl->resampleInputBuffer[i];
+            done += (int)n;
         }
-
-        // Downsample back to original sample rate
-        resampleLinear(m_impl->resampleOutputBuffer.data(), frames48k, samples, frameCount);
     }
 }
 
@@ -236,6 +317,11 @@ void NoiseSuppressor::setSuppressionLevel(NoiseSuppressionLevel level)
     if (m_level == level)
         return;
 
+    // Coming back from Off: whatever was left in the pipeline is stale
+    if (m_level == NoiseSuppressionLevel::Off) {
+        m_impl->resetPending.store(true, std::memory_order_release);
+    }
+
     m_level = level;
     if (level != NoiseSuppressionLevel::Off) {
         m_previousLevel = level;
@@ -322,6 +408,15 @@ void NoiseSuppressor::process(float* /*samples*/, int /*frameCount*/)
     // Pass-through: no processing when RNNoise is not available
 }
 
+void NoiseSuppressor::processBatch(NoiseSuppressor* const* /*suppressors*/, float* const* /*samples*/, int /*count*/,
+                                   int /*frameCount*/)
+{}
+
+bool NoiseSuppressor::providesVad() const
+{
+    return false;
+}
+
 void NoiseSuppressor::setSuppressionLevel(NoiseSuppressionLevel level)
 {
     m_level = level;
@@ -347,3 +442,39 @@ bool NoiseSuppressor::setSampleRate(int sampleRate)
 }
 
 #endif // TALKLESS_HAS_RNNOISE
+
+// ------------------------------------------------------------
+// NoiseSuppressorPool
+// ------------------------------------------------------------
+NoiseSuppressorPool::NoiseSuppressorPool(int sampleRate, int streamCount, NoiseSuppressionLevel level)
+{
+    streamCount = std::clamp(streamCount, 1, MAX_STREAMS);
+    m_streams.reserve((size_t)streamCount);
+    for (int i = 0; i < streamCount; ++i)
+        m_streams.push_back(std::make_unique<NoiseSuppressor>(sampleRate, level));
+}
+
+bool NoiseSuppressorPool::init()
+{
+    bool ok = true;
+    for (auto& s : m_streams)
+        ok = s->init() && ok;
+    return ok;
+}
+
+bool NoiseSuppressorPool::setSampleRate(int sampleRate)
+{
+    bool ok = true;
+    for (auto& s : m_streams)
+        ok = s->setSampleRate(sampleRate) && ok;
+    return ok;
+}
+
+void NoiseSuppressorPool::processBatch(const int* streams, float* const* samples, int count, int frameCount)
+{
+    NoiseSuppressor* suppressors[MAX_STREAMS];
+    count = std::min(count, MAX_STREAMS);
+    for (int i = 0; i < count; ++i)
+        suppressors[i] = (streams[i] >= 0 && streams[i] < streamCount()) ? m_streams[streams[i]].get() : nullptr;
+    NoiseSuppressor::processBatch(suppressors, samples, count, frameCount);
+}
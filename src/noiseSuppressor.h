@@ -29,7 +29,10 @@ enum class NoiseSuppressionLevel {
  * high-quality noise removal with low computational cost.
  *
  * Note: RNNoise operates at 48kHz with a fixed frame size of 480 samples (10ms).
- * Audio at different sample rates will be resampled internally.
+ * Audio at other sample rates goes through a streaming resampler on the way in
+ * and out. Output is delayed by a constant getLatencyFrames() (one RNNoise
+ * frame plus the resamplers' lookahead), whatever the host block size, and
+ * process() never allocates.
  *
  * Usage:
  *   1. Create instance with sample rate and desired suppression level
@@ -72,10 +75,21 @@ public:
      * @param frameCount Number of samples to process
      *
      * Note: RNNoise processes in fixed frame sizes of 480 samples at 48kHz.
-     * Larger frames will be processed in chunks internally.
+     * Any frameCount works; the output is the input delayed by getLatencyFrames().
      */
     void process(float* samples, int frameCount);
 
+    /**
+     * @brief Process several independent streams' blocks together, each in-place
+     * @param suppressors One suppressor per stream (each keeps its own state and level)
+     * @param samples One mono block per stream, all frameCount long
+     * @param count Number of streams
+     *
+     * Same output as calling process() on each, but the RNNoise frames of all
+     * streams run back to back, so the model weights stay in cache between them.
+     */
+    static void processBatch(NoiseSuppressor* const* suppressors, float* const* samples, int count, int frameCount);
+
     /**
      * @brief Set the noise suppression level
      * @param level New suppression level
@@ -110,13 +124,32 @@ public:
      */
     bool setSampleRate(int sampleRate);
 
+    /**
+     * @brief Delay process() adds, in frames at the current sample rate (0 when RNNoise is unavailable)
+     */
+    int getLatencyFrames() const { return m_latencyFrames; }
+
     /**
      * @brief Get the last VAD (Voice Activity Detection) probability
      * @return Probability between 0.0 and 1.0 that voice is present
      */
     float getLastVadProbability() const { return m_lastVadProbability; }
 
+    /**
+     * @brief Whether process() is running RNNoise, i.e. getLastVadProbability() is live
+     */
+    bool providesVad() const;
+
 private:
+    // Stages of one host chunk, see processBatch()
+    bool isProcessing() const;
+    void pushHost(const float* block, size_t frames);
+    bool denoiseNext();
+    void pullHost(float* block, size_t frames);
+
+    void resetStreams();
+    void denoiseFrame(const float* in, float* out);
+
     int m_sampleRate;
     NoiseSuppressionLevel m_level;
     NoiseSuppressionLevel m_previousLevel; // For enable/disable toggling
@@ -126,6 +159,9 @@ private:
     static constexpr int RNNOISE_FRAME_SIZE = 480;
     static constexpr int RNNOISE_SAMPLE_RATE = 48000;
 
+    // Constant delay of the streaming pipeline, at m_sampleRate
+    int m_latencyFrames = 0;
+
     // Last VAD probability from RNNoise
     float m_lastVadProbability = 0.0f;
 
@@ -136,3 +172,34 @@ private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
 };
+
+/**
+ * @brief Independent noise suppressors for several mono streams at one sample rate
+ *
+ * Each stream (e.g. the main mic and the recording input) has its own RNNoise
+ * state and level. Streams whose blocks are ready together go through
+ * NoiseSuppressor::processBatch().
+ */
+class NoiseSuppressorPool
+{
+public:
+    NoiseSuppressorPool(int sampleRate, int streamCount, NoiseSuppressionLevel level = NoiseSuppressionLevel::Moderate);
+
+    int streamCount() const { return (int)m_streams.size(); }
+    NoiseSuppressor& stream(int index) { return *m_streams[index]; }
+    const NoiseSuppressor& stream(int index) const { return *m_streams[index]; }
+
+    // Initializes every stream; true if all succeeded
+    bool init();
+    bool setSampleRate(int sampleRate);
+
+    void process(int stream, float* samples, int frameCount) { m_streams[stream]->process(samples, frameCount); }
+
+    // Denoises streams[i]'s block samples[i] for each i < count (at most MAX_STREAMS), all frameCount long
+    void processBatch(const int* streams, float* const* samples, int count, int frameCount);
+
+    static constexpr int MAX_STREAMS = 8;
+
+private:
+    std::vector<std::unique_ptr<NoiseSuppressor>> m_streams;
+};
@@ -2,6 +2,8 @@
 
 #include <QUrl>
 
+#include <algorithm>
+
 ClipsListModel::ClipsListModel(QObject* parent) : QAbstractListModel(parent) {}
 
 void ClipsListModel::setService(SoundboardService* service)
@@ -310,3 +312,21 @@ void ClipsListModel::setClipRepeat(int clipId, bool repeat)
         }
     }
 }
+
+void ClipsListModel::setVisibleRange(int firstRow, int lastRow)
+{
+    if (!m_service || m_cache.isEmpty())
+        return;
+
+    firstRow = std::max(0, firstRow);
+    lastRow = std::min(lastRow, static_cast<int>(m_cache.size()) - 1);
+    if (firstRow > lastRow)
+        return;
+
+    QList<int> clipIds;
+    clipIds.reserve(lastRow - firstRow + 1);
+    for (int i = firstRow; i <= lastRow; ++i) {
+        clipIds.append(m_cache[i].id);
+    }
+    m_service->prioritizeClipWaveforms(clipIds);
+}
@@ -69,6 +69,7 @@ public:
     Q_INVOKABLE bool updateClipAudioSettings(int clipId, int volume, double speed);
     Q_INVOKABLE void setClipVolume(int clipId, int volume);  // Real-time volume update
     Q_INVOKABLE void setClipRepeat(int clipId, bool repeat); // Toggle repeat mode
+    Q_INVOKABLE void setVisibleRange(int firstRow, int lastRow); // Rows on screen get their waveforms first
 
 signals:
     void serviceChanged();
@@ -0,0 +1,173 @@
+#include "resampledClipCache.h"
+
+#include "cachePaths.h"
+#include "clipDecoder.h"
+#include "mediaInfoCache.h"
+#include "miniaudio.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+bool initEncoder(const std::filesystem::path& path, uint32_t channels, uint32_t sampleRate, ma_encoder& encoder)
+{
+    ma_encoder_config cfg = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, channels, sampleRate);
+#ifdef _WIN32
+    return ma_encoder_init_file_w(path.c_str(), &cfg, &encoder) == MA_SUCCESS;
+#else
+    return ma_encoder_init_file(path.c_str(), &cfg, &encoder) == MA_SUCCESS;
+#endif
+}
+} // namespace
+
+ResampledClipCache::~ResampledClipCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit.store(true, std::memory_order_relaxed);
+    }
+    m_cv.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void ResampledClipCache::setStorageDirectory(const std::string& directory)
+{
+    std::error_code ec;
+    const std::filesystem::path dir = pathFromUtf8(directory);
+    std::filesystem::create_directories(dir, ec);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = ec ? std::filesystem::path() : dir;
+}
+
+std::string ResampledClipCache::acquire(const std::string& sourcePath, uint32_t sampleRate)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty() || sampleRate == 0)
+        return std::string();
+
+    const std::filesystem::path dest = cachePathLocked(sourcePath, sampleRate);
+    if (dest.empty())
+        return std::string();
+
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(dest, ec))
+        return utf8FromPath(dest);
+
+    if (m_pending.count(dest) == 0 && m_failed.count(dest) == 0) {
+        m_pending.insert(dest);
+        m_jobs.push_back(Job{sourcePath, dest, sampleRate});
+        if (!m_worker.joinable())
+            m_worker = std::thread(&ResampledClipCache::workerLoop, this);
+        m_cv.notify_one();
+    }
+    return std::string();
+}
+
+std::filesystem::path ResampledClipCache::cachePathLocked(const std::string& sourcePath, uint32_t sampleRate) const
+{
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (!MediaInfoCache::statFile(sourcePath, size, mtime))
+        return std::filesystem::path();
+
+    const std::string name = pathHash(sourcePath) + "_" + std::to_string(size) + "_" + std::to_string(mtime) + "_" +
+                             std::to_string(sampleRate) + ".wav";
+    return m_directory / name;
+}
+
+void ResampledClipCache::workerLoop()
+{
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_quit.load(std::memory_order_relaxed) || !m_jobs.empty(); });
+            if (m_quit.load(std::memory_order_relaxed))
+                return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        // Written under a temporary name so acquire() never sees a half-written copy
+        std::filesystem::path part = job.destPath;
+        part += ".part";
+        bool ok = convertFile(job.sourcePath, part, job.sampleRate, &m_quit);
+
+        std::error_code ec;
+        if (ok) {
+            std::filesystem::rename(part, job.destPath, ec);
+            ok = !ec;
+        }
+        if (ok) {
+            removeStaleCopies(job.destPath);
+            std::cout << "[ResampledClipCache] " << job.sourcePath << " -> " << job.sampleRate << " Hz\n";
+        } else {
+            std::filesystem::remove(part, ec);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.erase(job.destPath);
+        if (!ok && !m_quit.load(std::memory_order_relaxed))
+            m_failed.insert(job.destPath);
+    }
+}
+
+void ResampledClipCache::removeStaleCopies(const std::filesystem::path& keep)
+{
+    // Same source hash prefix = an older version of the file or another rate
+    const std::string keepName = utf8FromPath(keep.filename());
+    const std::string prefix = keepName.substr(0, keepName.find('_') + 1);
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(keep.parent_path(), ec)) {
+        const std::string name = utf8FromPath(entry.path().filename());
+        if (name != keepName && name.rfind(prefix, 0) == 0 && entry.path().extension() == ".wav")
+            std::filesystem::remove(entry.path(), ec);
+    }
+}
+
+bool ResampledClipCache::convertFile(const std::string& sourcePath, const std::filesystem::path& destPath,
+                                     uint32_t sampleRate, const std::atomic<bool>* cancel)
+{
+    // The slowest tier is fine here: it runs once per clip, off the audio path
+    ClipDecoder decoder;
+    decoder.setResamplerQuality(ResamplerQuality::Sinc64);
+    if (sampleRate == 0 || !decoder.open(sourcePath, sampleRate, 0))
+        return false;
+
+    const uint32_t channels = decoder.getChannels();
+    if (channels == 0)
+        return false;
+
+    ma_encoder encoder;
+    if (!initEncoder(destPath, channels, sampleRate, encoder))
+        return false;
+
+    constexpr uint64_t kChunkFrames = 4096;
+    std::vector<float> buffer((size_t)kChunkFrames * channels);
+    uint64_t written = 0;
+    bool ok = true;
+
+    for (;;) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            ok = false;
+            break;
+        }
+        uint64_t read = 0;
+        const ma_result res = decoder.readPcmFrames(buffer.data(), kChunkFrames, &read);
+        if (read > 0 && ma_encoder_write_pcm_frames(&encoder, buffer.data(), read, nullptr) != MA_SUCCESS) {
+            ok = false;
+            break;
+        }
+        written += read;
+        if (read == 0 || res != MA_SUCCESS)
+            break;
+    }
+
+    ma_encoder_uninit(&encoder);
+    return ok && written > 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+/**
+ * @brief On-disk copies of clips converted to the output sample rate
+ *
+ * A clip whose native rate differs from the device rate is converted once, on
+ * a background thread, with the best Resampler tier. The result is a float
+ * WAV next to the media cache. Voices then decode that copy at the device
+ * rate, so they never resample live. Until the copy exists, acquire() returns
+ * nothing and the caller resamples as before.
+ *
+ * Copies are keyed by source path, size, modification time and rate. A stale
+ * copy is simply never matched and is removed when its replacement is written.
+ * Disabled until setStorageDirectory() is called.
+ */
+class ResampledClipCache
+{
+public:
+    ResampledClipCache() = default;
+    ~ResampledClipCache();
+
+    ResampledClipCache(const ResampledClipCache&) = delete;
+    ResampledClipCache& operator=(const ResampledClipCache&) = delete;
+
+    void setStorageDirectory(const std::string& directory);
+
+    // Path of a finished copy at sampleRate, or empty (then one is queued for conversion)
+    std::string acquire(const std::string& sourcePath, uint32_t sampleRate);
+
+    // Decode sourcePath and write it to destPath as float WAV at sampleRate, native channel count.
+    // Gives up (false) as soon as cancel is set.
+    static bool convertFile(const std::string& sourcePath, const std::filesystem::path& destPath, uint32_t sampleRate,
+                            const std::atomic<bool>* cancel = nullptr);
+
+private:
+    struct Job
+    {
+        std::string sourcePath;
+        std::filesystem::path destPath;
+        uint32_t sampleRate = 0;
+    };
+
+    std::filesystem::path cachePathLocked(const std::string& sourcePath, uint32_t sampleRate) const;
+    void workerLoop();
+    static void removeStaleCopies(const std::filesystem::path& keep);
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::filesystem::path m_directory;
+    std::deque<Job> m_jobs;
+    std::set<std::filesystem::path> m_pending; // queued or being converted
+    std::set<std::filesystem::path> m_failed;  // not retried this session
+    std::atomic<bool> m_quit{false};
+    std::thread m_worker; // started with the first job
+};
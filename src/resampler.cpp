@@ -0,0 +1,281 @@
+#include "resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define TALKLESS_RESAMPLER_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define TALKLESS_RESAMPLER_NEON 1
+#endif
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+// Above this many phases the table snaps to the nearest of kMaxPhases (timing error < 1/2048 frame)
+constexpr uint32_t kMaxPhases = 1024;
+// Input frames buffered per channel on top of the filter span
+constexpr size_t kBlockFrames = 512;
+// Kernel width limit for extreme decimation (e.g. 192 kHz -> 8 kHz)
+constexpr size_t kMaxTaps = 1024;
+
+struct SincTier
+{
+    size_t taps;        // at or above unity ratio
+    double stopbandDb;  // Kaiser design attenuation
+};
+
+SincTier sincTier(ResamplerQuality quality)
+{
+    switch (quality) {
+    case ResamplerQuality::Sinc16:
+        return {16, 60.0};
+    case ResamplerQuality::Sinc64:
+        return {64, 100.0};
+    case ResamplerQuality::Sinc32:
+    default:
+        return {32, 80.0};
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind (series; converges fast for beta <= 12)
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    const double q = x * x / 4.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= q / (double(k) * double(k));
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+// Sinc taps are a multiple of 8, linear is 2
+inline float dot(const float* a, const float* b, size_t n)
+{
+#if TALKLESS_RESAMPLER_SSE
+    if ((n & 7) == 0) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (size_t i = 0; i < n; i += 8) {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        __m128 acc = _mm_add_ps(acc0, acc1);
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        return _mm_cvtss_f32(acc);
+    }
+#elif TALKLESS_RESAMPLER_NEON
+    if ((n & 7) == 0) {
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        for (size_t i = 0; i < n; i += 8) {
+            acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+            acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        }
+        const float32x4_t acc = vaddq_f32(acc0, acc1);
+    #if defined(__aarch64__) || defined(_M_ARM64)
+        return vaddvq_f32(acc);
+    #else
+        return vgetq_lane_f32(acc, 0) + vgetq_lane_f32(acc, 1) + vgetq_lane_f32(acc, 2) + vgetq_lane_f32(acc, 3);
+    #endif
+    }
+#endif
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+} // namespace
+
+bool Resampler::init(uint32_t channels, uint32_t inRate, uint32_t outRate, ResamplerQuality quality)
+{
+    m_channels = 0;
+    if (channels == 0 || inRate == 0 || outRate == 0)
+        return false;
+
+    const uint32_t g = std::gcd(inRate, outRate);
+    m_up = outRate / g;
+    m_down = inRate / g;
+    m_inRate = inRate;
+    m_outRate = outRate;
+    m_quality = quality;
+    m_tablePhases = std::min(m_up, kMaxPhases);
+
+    if (quality == ResamplerQuality::Linear) {
+        m_taps = 2;
+    } else {
+        // Keep the same number of output-rate periods under the kernel when decimating
+        const double ratio = std::min(1.0, double(outRate) / double(inRate));
+        const size_t taps = (size_t)std::ceil(double(sincTier(quality).taps) / ratio);
+        m_taps = std::min(kMaxTaps, (taps + 7) & ~size_t(7));
+    }
+    m_half = m_taps / 2;
+
+    const size_t stepFrames = m_down / m_up;
+    m_capacity = m_taps + stepFrames + 2 + kBlockFrames;
+    m_history.assign((size_t)channels * m_capacity, 0.0f);
+
+    m_channels = channels;
+    buildTable();
+    reset();
+    return true;
+}
+
+void Resampler::buildTable()
+{
+    const size_t rows = (size_t)m_tablePhases + 1; // the last row (offset 1.0) absorbs rounding up
+    m_table.assign(rows * m_taps, 0.0f);
+
+    double cutoff = 0.5; // cycles per input frame
+    double beta = 0.0;
+    if (m_quality != ResamplerQuality::Linear) {
+        // Kaiser estimate: place the transition band so its far edge lands on the lower Nyquist
+        const SincTier tier = sincTier(m_quality);
+        const double transition = (tier.stopbandDb - 7.95) / (14.36 * double(tier.taps));
+        const double ratio = std::min(1.0, double(m_outRate) / double(m_inRate));
+        cutoff = ratio * (0.5 - transition / 2.0);
+        beta = 0.1102 * (tier.stopbandDb - 8.7);
+    }
+    const double i0Beta = besselI0(beta);
+
+    for (size_t row = 0; row < rows; ++row) {
+        const double frac = double(row) / double(m_tablePhases);
+        float* coeffs = m_table.data() + row * m_taps;
+        double sum = 0.0;
+        for (size_t k = 0; k < m_taps; ++k) {
+            // Distance from the output instant back to this tap's input frame
+            const double d = frac + double(m_half - 1) - double(k);
+            double h = 0.0;
+            if (m_quality == ResamplerQuality::Linear) {
+                h = std::max(0.0, 1.0 - std::abs(d));
+            } else {
+                const double r = d / double(m_half);
+                if (std::abs(r) < 1.0) {
+                    const double x = 2.0 * cutoff * d;
+                    const double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+                    h = 2.0 * cutoff * sinc * besselI0(beta * std::sqrt(1.0 - r * r)) / i0Beta;
+                }
+            }
+            coeffs[k] = (float)h;
+            sum += h;
+        }
+        // Unity gain at DC for every phase, so a constant input stays constant
+        if (sum != 0.0) {
+            for (size_t k = 0; k < m_taps; ++k)
+                coeffs[k] = (float)(coeffs[k] / sum);
+        }
+    }
+}
+
+void Resampler::reset(size_t historyFrames, uint32_t phase)
+{
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_pos = m_half - 1;
+    m_filled = m_pos - std::min(historyFrames, m_pos);
+    m_phase = m_up ? phase % m_up : 0;
+}
+
+uint64_t Resampler::outputFramesFor(uint64_t inputFrames) const
+{
+    // Outputs k with k * M / L < inputFrames
+    return (inputFrames * m_up + m_down - 1) / m_down;
+}
+
+const char* Resampler::qualityName(ResamplerQuality quality)
+{
+    switch (quality) {
+    case ResamplerQuality::Linear:
+        return "linear";
+    case ResamplerQuality::Sinc16:
+        return "sinc16";
+    case ResamplerQuality::Sinc32:
+        return "sinc32";
+    case ResamplerQuality::Sinc64:
+        return "sinc64";
+    }
+    return "unknown";
+}
+
+void Resampler::compact()
+{
+    // Everything before the first tap of the next output is dead
+    const size_t start = std::min(m_pos + 1 - m_half, m_filled);
+    if (start == 0)
+        return;
+
+    const size_t keep = m_filled - start;
+    for (uint32_t ch = 0; ch < m_channels; ++ch) {
+        float* plane = m_history.data() + (size_t)ch * m_capacity;
+        std::memmove(plane, plane + start, keep * sizeof(float));
+    }
+    m_filled = keep;
+    m_pos -= start;
+}
+
+void Resampler::process(const float* in, size_t& inFrames, float* out, size_t& outFrames)
+{
+    const size_t inAvailable = inFrames;
+    const size_t outCapacity = outFrames;
+    size_t inUsed = 0;
+    size_t outMade = 0;
+
+    if (m_channels == 0) {
+        inFrames = 0;
+        outFrames = 0;
+        return;
+    }
+
+    const uint32_t stepFrames = m_down / m_up;
+    const uint32_t stepPhase = m_down % m_up;
+    const bool exactPhases = m_tablePhases == m_up;
+
+    for (;;) {
+        while (outMade < outCapacity && m_pos + m_half < m_filled) {
+            const size_t row = exactPhases ? m_phase
+                                           : (size_t)(((uint64_t)m_phase * m_tablePhases + m_up / 2) / m_up);
+            const float* coeffs = m_table.data() + row * m_taps;
+            const size_t first = m_pos + 1 - m_half;
+            float* frame = out + outMade * m_channels;
+            for (uint32_t ch = 0; ch < m_channels; ++ch)
+                frame[ch] = dot(m_history.data() + (size_t)ch * m_capacity + first, coeffs, m_taps);
+            ++outMade;
+
+            m_pos += stepFrames;
+            m_phase += stepPhase;
+            if (m_phase >= m_up) {
+                m_phase -= m_up;
+                ++m_pos;
+            }
+        }
+        if (outMade == outCapacity || inUsed == inAvailable)
+            break;
+
+        compact();
+        const size_t take = std::min(m_capacity - m_filled, inAvailable - inUsed);
+        if (take == 0)
+            break;
+
+        // De-interleave into the planar history so each channel's taps are contiguous
+        const float* src = in + inUsed * m_channels;
+        for (uint32_t ch = 0; ch < m_channels; ++ch) {
+            float* dst = m_history.data() + (size_t)ch * m_capacity + m_filled;
+            for (size_t i = 0; i < take; ++i)
+                dst[i] = src[i * m_channels + ch];
+        }
+        m_filled += take;
+        inUsed += take;
+    }
+
+    inFrames = inUsed;
+    outFrames = outMade;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Sample-rate quality tiers, cheapest first
+ *
+ * Tap counts are per output sample when upsampling; downsampling widens the
+ * kernel by the rate ratio so the filter keeps its stopband at the new Nyquist.
+ */
+enum class ResamplerQuality {
+    Linear = 0, // 2-tap interpolation, no anti-aliasing (cheapest, audibly aliases)
+    Sinc16 = 1, // Kaiser-windowed sinc, ~60 dB stopband
+    Sinc32 = 2, // ~80 dB stopband, flat to ~16.5 kHz at 48 kHz
+    Sinc64 = 3  // ~100 dB stopband, flat to ~19 kHz at 48 kHz (offline work)
+};
+
+/**
+ * @brief Streaming polyphase resampler for interleaved float audio
+ *
+ * The rate ratio is reduced to L/M and one filter phase is precomputed per
+ * output position. That is exact for every common pair of rates (up to 1024
+ * phases). For odd pairs it falls back to the nearest of 1024 phases; time is
+ * still tracked exactly, so there is no drift. The inner dot products use
+ * SSE or NEON when the target has it.
+ *
+ * State carries across process() calls, so output doesn't depend on how the
+ * input is split into blocks. Output is phase-aligned with the input: output
+ * frame k sits at input time k * M / L. To produce it, the resampler needs
+ * inputLookahead() frames past that point, so a finished stream has to be
+ * flushed with that many zero frames. Only init() allocates.
+ */
+class Resampler
+{
+public:
+    Resampler() = default;
+
+    bool init(uint32_t channels, uint32_t inRate, uint32_t outRate, ResamplerQuality quality);
+    bool isInitialized() const { return m_channels != 0; }
+
+    /**
+     * @brief Back to the start of a stream
+     * @param historyFrames Input frames the caller will feed before the first output
+     *        instant (at most inputLookahead() - 1; the rest of the history is zeros)
+     * @param phase First output sits phase / phaseCount() input frames after them
+     */
+    void reset(size_t historyFrames = 0, uint32_t phase = 0);
+
+    /**
+     * @brief Consume input and produce output, both interleaved
+     *
+     * On return inFrames holds the frames consumed and outFrames the frames
+     * written. Stops when the output is full or the input is used up. Input is
+     * always consumed once there is room for it.
+     */
+    void process(const float* in, size_t& inFrames, float* out, size_t& outFrames);
+
+    // Input frames needed past an output instant before it can be produced
+    size_t inputLookahead() const { return m_half; }
+    // Output frames that inputFrames of input make, from the start of the stream
+    uint64_t outputFramesFor(uint64_t inputFrames) const;
+
+    // One output frame advances the input by phaseStep() / phaseCount() frames
+    uint32_t phaseCount() const { return m_up; }
+    uint32_t phaseStep() const { return m_down; }
+
+    uint32_t channels() const { return m_channels; }
+    uint32_t inputRate() const { return m_inRate; }
+    uint32_t outputRate() const { return m_outRate; }
+    ResamplerQuality quality() const { return m_quality; }
+    size_t taps() const { return m_taps; }
+
+    static const char* qualityName(ResamplerQuality quality);
+
+private:
+    void buildTable();
+    void compact();
+
+    ResamplerQuality m_quality = ResamplerQuality::Sinc32;
+    uint32_t m_channels = 0;
+    uint32_t m_inRate = 0;
+    uint32_t m_outRate = 0;
+    uint32_t m_up = 1;   // L
+    uint32_t m_down = 1; // M
+    uint32_t m_tablePhases = 1;
+    size_t m_taps = 2;
+    size_t m_half = 1;
+
+    std::vector<float> m_table; // (m_tablePhases + 1) rows of m_taps coefficients
+    std::vector<float> m_history; // planar, m_capacity frames per channel
+    size_t m_capacity = 0;
+    size_t m_filled = 0; // frames held per channel
+    size_t m_pos = 0;    // index of the input frame at or before the next output instant
+    uint32_t m_phase = 0; // next output instant is m_pos + m_phase / m_up
+};
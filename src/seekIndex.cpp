@@ -0,0 +1,76 @@
+#include "seekIndex.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+constexpr char kMagic[4] = {'T', 'L', 'S', 'I'};
+constexpr uint32_t kVersion = 1;
+
+template <typename T> void writePod(std::ofstream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> bool readPod(std::ifstream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+} // namespace
+
+bool SeekIndex::save(const std::filesystem::path& file) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(file.parent_path(), ec);
+
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+
+    out.write(kMagic, sizeof(kMagic));
+    writePod(out, kVersion);
+    writePod(out, static_cast<uint8_t>(kind));
+    writePod(out, static_cast<uint32_t>(points.size()));
+    for (const Point& p : points) {
+        writePod(out, p.pcmFrame);
+        writePod(out, p.bytePos);
+        writePod(out, p.pts);
+        writePod(out, p.mp3FramesToDiscard);
+        writePod(out, p.pcmFramesToDiscard);
+    }
+    return static_cast<bool>(out);
+}
+
+bool SeekIndex::load(const std::filesystem::path& file)
+{
+    kind = Kind::None;
+    points.clear();
+
+    std::ifstream in(file, std::ios::binary);
+    if (!in)
+        return false;
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint8_t rawKind = 0;
+    uint32_t count = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+        return false;
+    if (!readPod(in, version) || version != kVersion)
+        return false;
+    if (!readPod(in, rawKind) || !readPod(in, count))
+        return false;
+
+    std::vector<Point> loaded(count);
+    for (Point& p : loaded) {
+        if (!readPod(in, p.pcmFrame) || !readPod(in, p.bytePos) || !readPod(in, p.pts) ||
+            !readPod(in, p.mp3FramesToDiscard) || !readPod(in, p.pcmFramesToDiscard)) {
+            return false;
+        }
+    }
+
+    kind = static_cast<Kind>(rawKind);
+    points = std::move(loaded);
+    return true;
+}
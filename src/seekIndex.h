@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+struct ma_decoder;
+
+/**
+ * @brief Precomputed seek points for a compressed file
+ *
+ * Built once at import and stored next to the media info cache, so seeks
+ * jump straight to a nearby entry and only decode a short pre-roll instead
+ * of scanning from the start of the file.
+ *
+ * Mp3SeekPoints: dr_mp3 seek table used by the miniaudio backend.
+ * PacketTable:   audio packet timestamps and byte offsets from the FFmpeg demuxer.
+ */
+struct SeekIndex
+{
+    enum class Kind : uint8_t {
+        None = 0,
+        Mp3SeekPoints = 1,
+        PacketTable = 2
+    };
+
+    struct Point
+    {
+        uint64_t pcmFrame = 0;            // native sample rate
+        int64_t bytePos = -1;             // -1 if unknown
+        int64_t pts = 0;                  // stream time base (PacketTable only)
+        uint16_t mp3FramesToDiscard = 0;  // Mp3SeekPoints only
+        uint16_t pcmFramesToDiscard = 0;  // Mp3SeekPoints only
+    };
+
+    Kind kind = Kind::None;
+    std::vector<Point> points;
+
+    bool empty() const { return kind == Kind::None || points.empty(); }
+
+    bool save(const std::filesystem::path& file) const;
+    bool load(const std::filesystem::path& file);
+};
+
+// dr_mp3 seek tables live behind miniaudio's private types; implemented in miniaudio_impl.cpp.
+// Both return false if the decoder is not using the MP3 backend.
+bool buildMp3SeekIndex(ma_decoder* decoder, uint32_t pointCount, SeekIndex& out);
+bool bindMp3SeekIndex(ma_decoder* decoder, const SeekIndex& index);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Latest value of a small struct, written by one thread and copied out by any
+ *
+ * The writer makes the sequence odd, stores the payload and makes it even
+ * again; it never waits. A reader retries while the sequence is odd or moved
+ * under it. The payload lives in relaxed atomic words, so a copy that raced
+ * the writer is merely thrown away rather than undefined behaviour.
+ */
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload is copied word by word");
+
+public:
+    // Single writer
+    void store(const T& value)
+    {
+        uint32_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i)
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        uint32_t words[kWords];
+        for (;;) {
+            const uint32_t before = m_seq.load(std::memory_order_acquire);
+            if (before & 1u)
+                continue;
+            for (size_t i = 0; i < kWords; ++i)
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == before)
+                break;
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> m_seq{0};
+    std::array<std::atomic<uint32_t>, kWords> m_words{};
+};
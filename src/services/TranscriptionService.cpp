@@ -9,6 +9,9 @@
 #include <QSettings>
 #include <QThread>
 
+#include <algorithm>
+#include <cmath>
+
 TranscriptionService::TranscriptionService(QObject* parent)
     : QObject(parent)
     , m_webSocket(std::make_unique<ix::WebSocket>())
@@ -237,6 +240,14 @@ void TranscriptionService::startAudioCapture()
     
     qDebug() << "[TranscriptionService] Audio format:" << format.sampleRate() << "Hz";
 
+    // The device may not do 48 kHz; the resampler handles whatever it picked
+    if (!m_downsampler.init(1, static_cast<uint32_t>(format.sampleRate()), API_SAMPLE_RATE, ResamplerQuality::Sinc32)) {
+        m_errorMessage = "Unsupported microphone format";
+        emit sttError(m_errorMessage);
+        stopListening();
+        return;
+    }
+
     m_audioSource = std::make_unique<QAudioSource>(audioDevice, format);
     m_audioDevice = m_audioSource->start();
 
@@ -273,19 +284,33 @@ void TranscriptionService::sendAudioChunk()
         return;
     }
     
-    // Downsample from 48kHz to 24kHz (2:1 decimation)
+    // Resample to 24kHz (band-limited, so speech above 12kHz doesn't alias into the band)
     const int16_t* samples = reinterpret_cast<const int16_t*>(audioData.constData());
-    int sampleCount = audioData.size() / 2;
-    
+    const size_t sampleCount = static_cast<size_t>(audioData.size() / 2);
+
+    m_downsampleIn.resize(sampleCount);
+    for (size_t i = 0; i < sampleCount; ++i) {
+        m_downsampleIn[i] = samples[i] / 32768.0f;
+    }
+    m_downsampleOut.resize(m_downsampler.outputFramesFor(sampleCount) + 1);
+
     QByteArray downsampled;
-    downsampled.reserve(audioData.size() / 2);
-    
-    for (int i = 0; i < sampleCount - 1; i += 2) {
-        int32_t avg = (static_cast<int32_t>(samples[i]) + static_cast<int32_t>(samples[i + 1])) / 2;
-        int16_t sample = static_cast<int16_t>(avg);
-        downsampled.append(reinterpret_cast<const char*>(&sample), 2);
+    size_t consumed = 0;
+    for (;;) {
+        size_t inFrames = sampleCount - consumed;
+        size_t outFrames = m_downsampleOut.size();
+        m_downsampler.process(m_downsampleIn.data() + consumed, inFrames, m_downsampleOut.data(), outFrames);
+        consumed += inFrames;
+        for (size_t i = 0; i < outFrames; ++i) {
+            const float v = std::clamp(m_downsampleOut[i] * 32768.0f, -32768.0f, 32767.0f);
+            const int16_t sample = static_cast<int16_t>(std::lrint(v));
+            downsampled.append(reinterpret_cast<const char*>(&sample), 2);
+        }
+        if (consumed == sampleCount && outFrames == 0) {
+            break;
+        }
     }
-    
+
     if (downsampled.isEmpty()) {
         return;
     }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "resampler.h"
+
 #include <QAudioFormat>
 #include <QAudioSource>
 #include <QByteArray>
@@ -12,6 +14,7 @@
 #include <ixwebsocket/IXWebSocket.h>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 /**
  * @brief OpenAI Realtime Transcription service
@@ -102,6 +105,11 @@ private:
     QByteArray m_audioBuffer;
     std::mutex m_audioMutex;
 
+    // Capture rate -> API_SAMPLE_RATE, state kept across chunks
+    Resampler m_downsampler;
+    std::vector<float> m_downsampleIn;
+    std::vector<float> m_downsampleOut;
+
     static constexpr int INACTIVITY_TIMEOUT_MS = 10000;  // 10 seconds
     static constexpr int CAPTURE_SAMPLE_RATE = 48000;    // Native capture rate
     static constexpr int API_SAMPLE_RATE = 24000;        // API requires 24kHz
@@ -1,7 +1,9 @@
 #include "soundboardService.h"
 
 #include "audioEngine.h"
-#include "ffmpeg_decoder.h"
+#include "clipDecoder.h"
+#include "macroSequencer.h"
+#include "mappedFile.h"
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
@@ -17,11 +19,27 @@
 #include <QMutexLocker>
 #include <QProcess>
 #include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
 #include <QUrl>
 #include <QtConcurrent>
 
 #include <cmath>
 
+// Ramp length when a clip stops or mutes the clips already playing
+static constexpr double kOtherSoundsFadeMs = 150.0;
+
+static AudioEngine::VoiceDuckSettings voiceDuckSettings(const AppSettings& s)
+{
+    AudioEngine::VoiceDuckSettings d;
+    d.enabled = s.voiceDuckingEnabled;
+    d.threshold = (float)s.voiceDuckThreshold;
+    d.attackMs = (float)s.voiceDuckAttackMs;
+    d.releaseMs = (float)s.voiceDuckReleaseMs;
+    d.depthDb = (float)s.voiceDuckDepthDb;
+    return d;
+}
+
 // Helper function to sanitize file paths, especially for Windows where file:// URL
 // conversion can leave a leading slash before drive letters (e.g., "/C:/path" -> "C:/path")
 static QString sanitizeFilePath(const QString& path)
@@ -56,6 +74,20 @@ static QString sanitizeFilePath(const QString& path)
 
 SoundboardService::SoundboardService(QObject* parent) : QObject(parent), m_audioEngine(std::make_unique<AudioEngine>())
 {
+    // Probed media info (duration, backend, ...) persists across runs
+    m_audioEngine->setMediaCacheDirectory(
+        (QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/media_cache").toStdString());
+
+    // Probes only mark the cache dirty; write it once an import or board load has settled
+    m_mediaCacheFlushTimer = new QTimer(this);
+    m_mediaCacheFlushTimer->setInterval(1000);
+    connect(m_mediaCacheFlushTimer, &QTimer::timeout, this,
+            [this]() { m_audioEngine->mediaInfoCache().flush(std::chrono::milliseconds(2000)); });
+    m_mediaCacheFlushTimer->start();
+
+    // Waveform generation gets its own bounded pool so a large board never saturates every core
+    m_waveformPool.setMaxThreadCount(std::clamp(QThread::idealThreadCount() / 2, 1, 4));
+
     // 1) Load index (might not exist) - BEFORE starting audio to apply saved devices
     m_state = m_repo.loadIndex();
 
@@ -116,6 +148,13 @@ SoundboardService::SoundboardService(QObject* parent) : QObject(parent), m_audio
         m_audioEngine->setMicPassthroughEnabled(m_state.settings.micPassthroughEnabled);
         m_audioEngine->setMicSoundboardBalance(m_state.settings.micSoundboardBalance);
         m_audioEngine->setNoiseSuppressionLevel(m_state.settings.noiseSuppressionLevel);
+        m_audioEngine->setNoiseSuppressionOnDspThread(m_state.settings.noiseSuppressionOnDspThread);
+        m_audioEngine->setRecordingInputNoiseSuppressionLevel(m_state.settings.recordingInputNoiseSuppressionLevel);
+        m_audioEngine->setClipFadeMs(m_state.settings.clipFadeMs);
+        m_audioEngine->setResamplerQuality(static_cast<ResamplerQuality>(m_state.settings.resamplerQuality));
+        m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+        m_audioEngine->setVoiceStealPolicy(
+            static_cast<AudioEngine::VoiceStealPolicy>(m_state.settings.voiceStealPolicy));
 
         m_recordingTickTimer = new QTimer(this);
         m_recordingTickTimer->setInterval(100); // 10 updates/sec (smooth timer)
@@ -127,6 +166,17 @@ SoundboardService::SoundboardService(QObject* parent) : QObject(parent), m_audio
             }
         });
 
+        // One engine read per display frame replaces per-tile polling from QML; started by the
+        // watch*Telemetry() calls, and by playback starting while the playback data is watched
+        m_telemetryTimer = new QTimer(this);
+        m_telemetryTimer->setTimerType(Qt::PreciseTimer);
+        m_telemetryTimer->setInterval(16);
+        connect(m_telemetryTimer, &QTimer::timeout, this, &SoundboardService::publishTelemetry);
+        connect(this, &SoundboardService::activeClipsChanged, this, [this]() {
+            if (m_playbackWatchers > 0)
+                publishTelemetry();
+        });
+
         qDebug() << "Applied saved audio settings - Master:" << m_state.settings.masterGainDb
                  << "dB, Mic:" << m_state.settings.micGainDb << "dB";
     }
@@ -183,7 +233,8 @@ SoundboardService::SoundboardService(QObject* parent) : QObject(parent), m_audio
             const int finishedClipId = m_slotToClipId.value(slotId, -1);
             if (finishedClipId != -1) {
                 QMetaObject::invokeMethod(
-                    this, [this, finishedClipId]() { finalizeClipPlayback(finishedClipId); }, Qt::QueuedConnection);
+                    this, [this, finishedClipId, slotId]() { handleVoiceFinished(finishedClipId, slotId); },
+                    Qt::QueuedConnection);
             }
         });
 
@@ -205,7 +256,30 @@ SoundboardService::SoundboardService(QObject* parent) : QObject(parent), m_audio
         });
     }
 
-    // 8) Notify UI
+    // 8) Macros run on their own sequencer thread against the engine clock
+    m_macros = m_repo.loadMacros();
+    if (m_audioEngine) {
+        m_macroSequencer = std::make_unique<MacroSequencer>(*m_audioEngine);
+        m_macroSequencer->setStepCallback([this](int macroId, int stepIndex) {
+            QMetaObject::invokeMethod(
+                this, [this, macroId, stepIndex]() { handleMacroStep(macroId, stepIndex); }, Qt::QueuedConnection);
+        });
+        m_macroSequencer->setFinishedCallback([this](int macroId, bool completed) {
+            QMetaObject::invokeMethod(
+                this,
+                [this, macroId, completed]() {
+                    if (!isMacroRunning(macroId)) {
+                        m_runningMacroClipIds.remove(macroId);
+                        m_macroSlots.remove(macroId);
+                        updateTelemetryTimer();
+                    }
+                    emit macroFinished(macroId, completed);
+                },
+                Qt::QueuedConnection);
+        });
+    }
+
+    // 9) Notify UI
     emit boardsChanged();
     emit activeBoardChanged();
     emit activeClipsChanged();
@@ -213,6 +287,13 @@ SoundboardService::SoundboardService(QObject* parent) : QObject(parent), m_audio
 
 SoundboardService::~SoundboardService()
 {
+    // Drop queued waveform jobs and ask running ones to bail out early
+    for (auto it = m_waveformBoardCancel.begin(); it != m_waveformBoardCancel.end(); ++it) {
+        it.value()->store(true);
+    }
+    m_waveformPool.clear();
+    m_waveformPool.waitForDone();
+
     // Stop all clips before shutting down
     if (m_audioEngine) {
         for (auto it = m_clipIdToSlot.begin(); it != m_clipIdToSlot.end(); ++it) {
@@ -253,6 +334,9 @@ void SoundboardService::saveAllChanges()
         m_dirtyBoards.clear();
     }
 
+    if (m_audioEngine)
+        m_audioEngine->mediaInfoCache().flush();
+
     qDebug() << "All changes saved successfully.";
 }
 
@@ -429,6 +513,9 @@ bool SoundboardService::deactivate(int boardId)
         return true; // Already not active
     }
 
+    // Waveforms for this board are no longer needed
+    cancelWaveformJobsForBoard(boardId);
+
     // Mark the board as dirty before removing
     m_dirtyBoards.insert(boardId);
     m_activeBoards.remove(boardId);
@@ -466,6 +553,7 @@ QString SoundboardService::normalizeHotkey(const QString& hotkey)
 void SoundboardService::rebuildHotkeyIndex()
 {
     m_hotkeyToClipId.clear();
+    m_hotkeyFastPaths.clear();
 
     // Build hotkey index from all active boards
     for (auto it = m_activeBoards.begin(); it != m_activeBoards.end(); ++it) {
@@ -473,9 +561,90 @@ void SoundboardService::rebuildHotkeyIndex()
             const QString hk = normalizeHotkey(c.hotkey);
             if (!hk.isEmpty()) {
                 m_hotkeyToClipId[hk] = c.id;
+                // Engine-ready path, so a trigger never has to convert strings
+                m_hotkeyFastPaths[c.id] = sanitizeFilePath(c.filePath).toUtf8().toStdString();
+            }
+        }
+    }
+}
+
+bool SoundboardService::triggerClipFast(int clipId, qint64 pressNs, qint64 actionNs)
+{
+    if (!m_audioEngine)
+        return false;
+
+    // Only clips whose file is still loaded in their slot: anything that needs a load,
+    // a board lookup or a decision about other clips' saved state takes the full path.
+    auto fast = m_hotkeyFastPaths.constFind(clipId);
+    const int slotId = m_clipIdToSlot.value(clipId, -1);
+    if (fast == m_hotkeyFastPaths.constEnd() || slotId < 0 || !m_audioEngine->isClipLoaded(slotId, *fast))
+        return false;
+
+    Clip* clip = findActiveClipById(clipId);
+    if (!clip || clip->reproductionMode == 1 || clip->muteOtherSounds || clip->muteMicDuringPlayback ||
+        clip->polyphony > 1)
+        return false;
+
+    const int mode = clip->reproductionMode;
+    const bool isPlaying = m_audioEngine->isClipPlaying(slotId) && !m_audioEngine->isClipPaused(slotId);
+
+    // Play/Stop toggles off when tapped while playing
+    if (mode == 2 && isPlaying) {
+        if (!m_audioEngine->postCommand({AudioEngine::Command::Type::StopClip, slotId}))
+            return false;
+        QMetaObject::invokeMethod(
+            this,
+            [this, clipId]() {
+                if (Clip* c = findActiveClipById(clipId))
+                    c->isPlaying = false;
+                emit activeClipsChanged();
+                emit clipPlaybackStopped(clipId);
+            },
+            Qt::QueuedConnection);
+        return true;
+    }
+
+    applyClipSettings(clip, slotId);
+    if (pressNs >= 0)
+        m_audioEngine->armLatencyTrace(slotId, pressNs, actionNs);
+    if (!m_audioEngine->postCommand({AudioEngine::Command::Type::PlayClip, slotId}))
+        return false;
+    m_slotToClipId[slotId] = clipId;
+
+    // Others are stopped after the start is queued, so they never delay it
+    QList<int> stoppedClipIds;
+    if (mode == 2 || mode == 3 || mode == 4 || clip->stopOtherSounds) {
+        for (auto it = m_clipIdToSlot.constBegin(); it != m_clipIdToSlot.constEnd(); ++it) {
+            if (it.key() == clipId || it.value() == slotId)
+                continue;
+            if (m_audioEngine->isClipPlaying(it.value()) && !m_audioEngine->isClipPaused(it.value()) &&
+                m_audioEngine->postCommand({AudioEngine::Command::Type::StopClip, it.value()})) {
+                stoppedClipIds.append(it.key());
             }
         }
+        // Overlapping instances of other clips; each is dropped by its finished callback
+        for (auto it = m_extraVoices.constBegin(); it != m_extraVoices.constEnd(); ++it) {
+            if (it.key() != clipId && m_audioEngine->isClipPlaying(it.value()))
+                m_audioEngine->postCommand({AudioEngine::Command::Type::StopClip, it.value()});
+        }
     }
+
+    // UI bookkeeping follows once the event loop gets to it
+    QMetaObject::invokeMethod(
+        this,
+        [this, clipId, stoppedClipIds]() {
+            for (int otherId : stoppedClipIds) {
+                if (Clip* other = findActiveClipById(otherId))
+                    other->isPlaying = false;
+                emit clipPlaybackStopped(otherId);
+            }
+            if (Clip* c = findActiveClipById(clipId))
+                c->isPlaying = true;
+            emit activeClipsChanged();
+            emit clipPlaybackStarted(clipId);
+        },
+        Qt::QueuedConnection);
+    return true;
 }
 
 int SoundboardService::findActiveClipIdByHotkey(const QString& hotkey) const
@@ -583,6 +752,9 @@ QVariantMap SoundboardService::getClipData(int boardId, int clipId) const
                     map["speed"] = c.speed;
                     map["isPlaying"] = c.isPlaying; // Use stored state, not audio engine state
                     map["isRepeat"] = c.isRepeat;
+                    map["loopCrossfadeMs"] = c.loopCrossfadeMs;
+                    map["polyphony"] = c.polyphony;
+                    map["voicePriority"] = c.voicePriority;
                     map["tags"] = c.tags;
                     map["reproductionMode"] = c.reproductionMode;
                     map["stopOtherSounds"] = c.stopOtherSounds;
@@ -614,6 +786,9 @@ QVariantMap SoundboardService::getClipData(int boardId, int clipId) const
         map["speed"] = clip->speed;
         map["isPlaying"] = clip->isPlaying; // Use stored state, not audio engine state
         map["isRepeat"] = clip->isRepeat;
+        map["loopCrossfadeMs"] = clip->loopCrossfadeMs;
+        map["polyphony"] = clip->polyphony;
+        map["voicePriority"] = clip->voicePriority;
         map["tags"] = clip->tags;
         map["reproductionMode"] = clip->reproductionMode;
         map["stopOtherSounds"] = clip->stopOtherSounds;
@@ -829,6 +1004,7 @@ bool SoundboardService::addClipWithSettings(int boardId, const QString& filePath
 
             // Only delete the original if it's in managed storage (recordings)
             if (isFileInManagedStorage(localPath)) {
+                MappedFile::evict(localPath.toStdString()); // Windows can't delete a mapped file
                 QFile::remove(localPath);
                 qDebug() << "Deleted original recording file:" << localPath;
             }
@@ -870,6 +1046,7 @@ bool SoundboardService::deleteClip(int boardId, int clipId)
                 // STOP the clip if it's playing before deleting
                 if (m_audioEngine && m_clipIdToSlot.contains(clipId)) {
                     int slotId = m_clipIdToSlot[clipId];
+                    stopExtraVoices(clipId);
                     m_audioEngine->stopClip(slotId);
                     m_audioEngine->unloadClip(slotId);
                     m_clipIdToSlot.remove(clipId);
@@ -896,6 +1073,7 @@ bool SoundboardService::deleteClip(int boardId, int clipId)
             if (refCount == 0) {
                 // No other clips use this file, safe to delete
                 QString sanitizedPath = sanitizeFilePath(filePathToCheck);
+                MappedFile::evict(sanitizedPath.toStdString());
                 if (QFile::remove(sanitizedPath)) {
                     qDebug() << "Deleted orphaned managed file:" << sanitizedPath;
                 } else {
@@ -938,6 +1116,7 @@ bool SoundboardService::deleteClip(int boardId, int clipId)
             int refCount = countClipsUsingFile(filePathToCheck);
             if (refCount == 0) {
                 QString sanitizedPath = sanitizeFilePath(filePathToCheck);
+                MappedFile::evict(sanitizedPath.toStdString());
                 if (QFile::remove(sanitizedPath)) {
                     qDebug() << "Deleted orphaned managed file:" << sanitizedPath;
                 } else {
@@ -1256,6 +1435,8 @@ bool SoundboardService::updateClipAudioSettings(int boardId, int clipId, int vol
                 // Convert volume (0-100) to dB gain (-60 to 0)
                 float gainDb = (volume <= 0) ? -60.0f : 20.0f * std::log10(volume / 100.0f);
                 m_audioEngine->setClipGain(slotId, gainDb);
+                for (int extraSlotId : m_extraVoices.values(clipId))
+                    m_audioEngine->setClipGain(extraSlotId, gainDb);
                 // Note: Speed changes would require reloading the clip with pitch shift
                 // This is a placeholder for future implementation
             }
@@ -1314,6 +1495,8 @@ void SoundboardService::setClipVolume(int boardId, int clipId, int volume)
             // Convert volume (0-100) to dB gain (-60 to 0)
             float gainDb = (volume <= 0) ? -60.0f : 20.0f * std::log10(volume / 100.0f);
             m_audioEngine->setClipGain(slotId, gainDb);
+            for (int extraSlotId : m_extraVoices.values(clipId))
+                m_audioEngine->setClipGain(extraSlotId, gainDb);
         }
 
         emit activeClipsChanged();
@@ -1346,6 +1529,121 @@ void SoundboardService::setClipRepeat(int boardId, int clipId, bool repeat)
     }
 }
 
+void SoundboardService::setClipLoopCrossfade(int boardId, int clipId, double crossfadeMs)
+{
+    crossfadeMs = std::clamp(crossfadeMs, 0.0, 5000.0);
+
+    // Active board update
+    if (m_activeBoards.contains(boardId)) {
+        Soundboard& board = m_activeBoards[boardId];
+        for (auto& c : board.clips) {
+            if (c.id != clipId)
+                continue;
+
+            c.loopCrossfadeMs = crossfadeMs;
+
+            // Takes effect at the next loop point if the clip is playing
+            if (m_clipIdToSlot.contains(clipId) && m_audioEngine) {
+                m_audioEngine->setClipLoopCrossfade(m_clipIdToSlot[clipId], crossfadeMs);
+            }
+
+            emit clipUpdated(boardId, clipId);
+            saveActive();
+            return;
+        }
+    }
+
+    // Inactive board update
+    auto loaded = m_repo.loadBoard(boardId);
+    if (!loaded)
+        return;
+
+    Soundboard b = *loaded;
+    for (auto& c : b.clips) {
+        if (c.id == clipId) {
+            c.loopCrossfadeMs = crossfadeMs;
+            m_repo.saveBoard(b);
+            m_state = m_repo.loadIndex();
+            return;
+        }
+    }
+}
+
+void SoundboardService::setClipPolyphony(int boardId, int clipId, int polyphony)
+{
+    polyphony = std::clamp(polyphony, 1, kClipSlotsUsable);
+
+    // Active board update (applies from the next trigger)
+    if (m_activeBoards.contains(boardId)) {
+        Soundboard& board = m_activeBoards[boardId];
+        for (auto& c : board.clips) {
+            if (c.id != clipId)
+                continue;
+
+            c.polyphony = polyphony;
+            emit clipUpdated(boardId, clipId);
+            saveActive();
+            return;
+        }
+    }
+
+    // Inactive board update
+    auto loaded = m_repo.loadBoard(boardId);
+    if (!loaded)
+        return;
+
+    Soundboard b = *loaded;
+    for (auto& c : b.clips) {
+        if (c.id == clipId) {
+            c.polyphony = polyphony;
+            m_repo.saveBoard(b);
+            m_state = m_repo.loadIndex();
+            return;
+        }
+    }
+}
+
+void SoundboardService::setClipVoicePriority(int boardId, int clipId, int priority)
+{
+    priority = std::clamp(priority, 0, 10);
+
+    // Active board update
+    if (m_activeBoards.contains(boardId)) {
+        Soundboard& board = m_activeBoards[boardId];
+        for (auto& c : board.clips) {
+            if (c.id != clipId)
+                continue;
+
+            c.voicePriority = priority;
+
+            // Voices already playing keep competing with the new priority
+            if (m_audioEngine) {
+                for (int slotId : voicesOf(clipId))
+                    m_audioEngine->setClipPriority(slotId, priority);
+            }
+
+            emit clipUpdated(boardId, clipId);
+            saveActive();
+            return;
+        }
+    }
+
+    // Inactive board update
+    auto loaded = m_repo.loadBoard(boardId);
+    if (!loaded)
+        return;
+
+    Soundboard b = *loaded;
+    for (auto& c : b.clips) {
+        if (c.id == clipId) {
+            c.voicePriority = priority;
+            m_repo.saveBoard(b);
+            m_state = m_repo.loadIndex();
+            return;
+        }
+    }
+}
+
 void SoundboardService::setClipReproductionMode(int boardId, int clipId, int mode)
 {
     // Clamp mode to valid range (0-4)
@@ -1854,6 +2152,7 @@ bool SoundboardService::removeClipByFilePath(int boardId, const QString& filePat
                 // Stop the clip if playing
                 if (m_audioEngine && m_clipIdToSlot.contains(clipId)) {
                     int slotId = m_clipIdToSlot[clipId];
+                    stopExtraVoices(clipId);
                     m_audioEngine->stopClip(slotId);
                     m_audioEngine->unloadClip(slotId);
                     m_clipIdToSlot.remove(clipId);
@@ -2069,6 +2368,7 @@ bool SoundboardService::deleteBoard(int boardId)
             int refCount = countClipsUsingFile(filePath);
             if (refCount == 0) {
                 QString sanitizedPath = sanitizeFilePath(filePath);
+                MappedFile::evict(sanitizedPath.toStdString());
                 if (QFile::remove(sanitizedPath)) {
                     qDebug() << "Deleted orphaned managed file after board deletion:" << sanitizedPath;
                 } else {
@@ -2101,6 +2401,8 @@ void SoundboardService::clipClicked(int clipId)
 
 void SoundboardService::setCurrentlySelectedClip(int clipId)
 {
+    // The editor shows this clip's waveform next, so generate it ahead of everything else
+    enqueueWaveformJob(clipId, WaveformPrioritySelected);
     emit clipSelectionRequested(clipId);
 }
 
@@ -2130,6 +2432,7 @@ void SoundboardService::reproductionPlayingClip(const QVariantList& playingClipI
 
         case 1: // Play/Pause -> pause previous clips
         {
+            stopExtraVoices(cid); // only the primary instance is kept to resume
             double pos = m_audioEngine->getClipPlaybackPositionMs(slotId);
             Clip* clip = findActiveClipById(cid);
             if (!clip)
@@ -2145,6 +2448,7 @@ void SoundboardService::reproductionPlayingClip(const QVariantList& playingClipI
         case 2: // Play/Stop -> stop previous clips
         case 3: // Loop -> also stop previous clips
         {
+            stopExtraVoices(cid);
             m_audioEngine->stopClip(slotId);
 
             // update your UI state if you track it
@@ -2170,6 +2474,7 @@ void SoundboardService::playClip(int clipId)
         qWarning() << "AudioEngine not initialized";
         return;
     }
+    m_audioEngine->flushCommands();
 
     Clip* clip = findActiveClipById(clipId);
     if (!clip) {
@@ -2191,7 +2496,11 @@ void SoundboardService::playClip(int clipId)
         return;
     }
 
-    const int slotId = getOrAssignSlot(clipId);
+    int slotId = getOrAssignSlot(clipId);
+    if (slotId < 0) {
+        emit errorOccurred(tr("All voices are busy with higher-priority clips"));
+        return;
+    }
     m_slotToClipId[slotId] = clipId;
 
     // IMPORTANT: reproductionMode of *Clip_B* affects *previous playing clips*.
@@ -2253,11 +2562,19 @@ void SoundboardService::playClip(int clipId)
         return;
     }
 
+    // Overlay with polyphony: tapping a playing clip adds an instance instead of restarting it
+    if (mode == 0 && clip->polyphony > 1 && isCurrentlyPlaying && !isPaused) {
+        slotId = acquireOverlapVoice(*clip);
+        if (slotId < 0)
+            return;
+    }
+
     // Handle case where clip has a saved position but is not currently in audio engine
     // (e.g., it was paused when another clip started playing)
     const bool hasSavedPosition = (mode == 1 && clip->lastPlayedPosMs > 0.0);
 
     if (mode == 2 && isCurrentlyPlaying && !isPaused) {
+        stopExtraVoices(clipId);
         m_audioEngine->stopClip(slotId);
         clip->isPlaying = false;
         emit activeClipsChanged();
@@ -2268,6 +2585,7 @@ void SoundboardService::playClip(int clipId)
     // Mode 3 (Restart): Always restart from beginning when clicking same clip
     // If the clip is playing or paused, stop it and let it fall through to restart
     if (mode == 3 && isCurrentlyPlaying) {
+        stopExtraVoices(clipId);
         m_audioEngine->stopClip(slotId);
         clip->isPlaying = false;
         qDebug() << "Mode 3 (Restart): Restarting clip" << clipId << "from beginning";
@@ -2328,16 +2646,22 @@ void SoundboardService::playClip(int clipId)
 
     // Per-clip behavior options (independent of reproduction mode)
     if (clip->stopOtherSounds && !others.isEmpty()) {
-        // Stop all other playing clips
+        // Fade all other playing clips out; each one is finalized when its fade ends
         for (const QVariant& v : others) {
             bool ok = false;
             int otherId = v.toInt(&ok);
-            if (ok) {
-                stopClip(otherId);
+            if (ok && m_clipIdToSlot.contains(otherId)) {
+                const int otherSlotId = m_clipIdToSlot[otherId];
+                for (int extraSlotId : m_extraVoices.values(otherId))
+                    m_audioEngine->fadeOutAndStop(extraSlotId, kOtherSoundsFadeMs);
+                m_audioEngine->fadeOutAndStop(otherSlotId, kOtherSoundsFadeMs);
+                // Stopped on the spot (paused, or no main output to time the fade): no end will be reported
+                if (!m_audioEngine->isClipPlaying(otherSlotId))
+                    stopClip(otherId);
             }
         }
     } else if (clip->muteOtherSounds && !others.isEmpty()) {
-        // Pause (mute) all other playing clips and track them for resuming later
+        // Duck all other playing clips to silence; they keep playing and come back when this clip ends
         QList<int> mutedClipIds;
         for (const QVariant& v : others) {
             bool ok = false;
@@ -2345,23 +2669,16 @@ void SoundboardService::playClip(int clipId)
             if (ok && m_clipIdToSlot.contains(otherId)) {
                 int otherSlotId = m_clipIdToSlot[otherId];
                 if (m_audioEngine->isClipPlaying(otherSlotId) && !m_audioEngine->isClipPaused(otherSlotId)) {
-                    // Save position before pausing
-                    Clip* otherClip = findActiveClipById(otherId);
-                    if (otherClip) {
-                        otherClip->lastPlayedPosMs = m_audioEngine->getClipPlaybackPositionMs(otherSlotId);
-                        otherClip->isPlaying = false;
-                    }
-                    m_audioEngine->pauseClip(otherSlotId);
+                    for (int voice : voicesOf(otherId))
+                        m_audioEngine->rampClipLevel(voice, AudioEngine::kSilentLevelDb, kOtherSoundsFadeMs);
                     mutedClipIds.append(otherId);
-                    emit clipPlaybackPaused(otherId);
                 }
             }
         }
-        // Track which clips were muted by this clip for resuming later
+        // Track which clips were muted by this clip for unmuting later
         if (!mutedClipIds.isEmpty()) {
-            m_pausedByClip[clipId] = mutedClipIds;
+            m_mutedByClip[clipId] = mutedClipIds;
         }
-        emit activeClipsChanged();
     }
 
     // Mute mic if muteMicDuringPlayback is enabled for this clip
@@ -2376,14 +2693,7 @@ void SoundboardService::playClip(int clipId)
     }
 
     // 2) Prepare Clip_B to start from beginning
-    // Ensure it's stopped so loadClip() can succeed reliably
-    m_audioEngine->stopClip(slotId);
-
-    const std::string filePath = sanitizeFilePath(clip->filePath).toUtf8().constData();
-    qDebug() << "playClip: Loading audio file:" << QString::fromStdString(filePath);
-    auto [startSec, endSec] = m_audioEngine->loadClip(slotId, filePath);
-    if (startSec == endSec) {
-        qWarning() << "Failed to load clip:" << clip->filePath;
+    if (!prepareClipSlot(clip, slotId)) {
         // Restore mic if we muted it
         if (clip->muteMicDuringPlayback && wasMicEnabled) {
             m_audioEngine->setMicEnabled(true);
@@ -2392,20 +2702,6 @@ void SoundboardService::playClip(int clipId)
         }
         return;
     }
-    clip->durationSec = endSec;
-    qDebug() << "playClip: Successfully loaded clip, duration:" << endSec << "sec";
-
-    // Apply gain
-    const float gainDb = (clip->volume <= 0) ? -60.0f : 20.0f * std::log10(clip->volume / 100.0f);
-    m_audioEngine->setClipGain(slotId, gainDb);
-
-    // Apply loop behavior (Mode 4 forces repeat ON, Mode 3 is restart without loop)
-    const bool loop = (mode == 4) ? true : clip->isRepeat;
-    if (mode == 4)
-        clip->isRepeat = true;
-
-    m_audioEngine->setClipLoop(slotId, loop);
-    m_audioEngine->setClipTrim(slotId, clip->trimStartMs, clip->trimEndMs);
 
     // Resume from saved position if applicable (mainly for Play/Pause mode)
     if (hasSavedPosition) {
@@ -2416,6 +2712,10 @@ void SoundboardService::playClip(int clipId)
     }
 
     // Play the clip
+    if (m_pendingLatencyTrace.clipId == clipId) {
+        m_audioEngine->armLatencyTrace(slotId, m_pendingLatencyTrace.pressNs, m_pendingLatencyTrace.actionNs);
+        m_pendingLatencyTrace = PendingLatencyTrace();
+    }
     m_audioEngine->playClip(slotId);
 
     clip->isPlaying = true;
@@ -2451,35 +2751,16 @@ void SoundboardService::playClipFromPosition(int clipId, double positionMs)
     qDebug() << "playClipFromPosition: clipId=" << clipId << "positionMs=" << positionMs;
 
     const int slotId = getOrAssignSlot(clipId);
-    m_slotToClipId[slotId] = clipId;
-
-    const int mode = clip->reproductionMode;
-
-    // Stop the clip if it's currently playing
-    if (m_audioEngine->isClipPlaying(slotId)) {
-        m_audioEngine->stopClip(slotId);
+    if (slotId < 0) {
+        emit errorOccurred(tr("All voices are busy with higher-priority clips"));
+        return;
     }
+    m_slotToClipId[slotId] = clipId;
+    stopExtraVoices(clipId);
 
     // Load the clip (this resets seekPosMs to -1, but we'll set it after)
-    const std::string filePath = sanitizeFilePath(clip->filePath).toUtf8().constData();
-    auto [startSec, endSec] = m_audioEngine->loadClip(slotId, filePath);
-    if (startSec == endSec) {
-        qWarning() << "Failed to load clip:" << clip->filePath;
+    if (!prepareClipSlot(clip, slotId))
         return;
-    }
-    clip->durationSec = endSec;
-
-    // Apply gain
-    const float gainDb = (clip->volume <= 0) ? -60.0f : 20.0f * std::log10(clip->volume / 100.0f);
-    m_audioEngine->setClipGain(slotId, gainDb);
-
-    // Apply loop behavior
-    const bool loop = (mode == 4) ? true : clip->isRepeat;
-    if (mode == 4)
-        clip->isRepeat = true;
-
-    m_audioEngine->setClipLoop(slotId, loop);
-    m_audioEngine->setClipTrim(slotId, clip->trimStartMs, clip->trimEndMs);
 
     // *** KEY FIX: Set the start position AFTER loadClip but BEFORE playClip ***
     // This ensures the decoder thread will see seekPosMs when it starts
@@ -2496,50 +2777,169 @@ void SoundboardService::playClipFromPosition(int clipId, double positionMs)
     qDebug() << "playClipFromPosition: clip" << clipId << "started from position" << positionMs << "ms";
 }
 
-void SoundboardService::stopClip(int clipId)
+bool SoundboardService::prepareClipSlot(Clip* clip, int slotId)
 {
-    if (!m_audioEngine)
-        return;
-    if (!m_clipIdToSlot.contains(clipId))
-        return;
+    // Hotkey fast-path commands still in flight would race with the reload
+    m_audioEngine->flushCommands();
 
-    int slotId = m_clipIdToSlot[clipId];
+    // Ensure it's stopped so loadClip() can succeed reliably
     m_audioEngine->stopClip(slotId);
 
-    // remove ownership mapping
-    m_slotToClipId.remove(slotId);
+    const std::string filePath = sanitizeFilePath(clip->filePath).toUtf8().constData();
+    qDebug() << "Loading audio file:" << QString::fromStdString(filePath);
+    auto [startSec, endSec] = m_audioEngine->loadClip(slotId, filePath);
+    if (startSec == endSec) {
+        qWarning() << "Failed to load clip:" << clip->filePath;
+        return false;
+    }
+    clip->durationSec = endSec;
 
-    finalizeClipPlayback(clipId);
-    qDebug() << "Stopped clip" << clipId << "in slot" << slotId;
+    applyClipSettings(clip, slotId);
+    return true;
 }
 
-bool SoundboardService::startRecording()
+void SoundboardService::applyClipSettings(Clip* clip, int slotId)
+{
+    // Mode 4 forces repeat ON, Mode 3 is restart without loop
+    if (clip->reproductionMode == 4)
+        clip->isRepeat = true;
+
+    configureClipSlot(*m_audioEngine, *clip, slotId);
+}
+
+void SoundboardService::configureClipSlot(AudioEngine& engine, const Clip& clip, int slotId)
+{
+    // Apply gain
+    const float gainDb = (clip.volume <= 0) ? -60.0f : 20.0f * std::log10(clip.volume / 100.0f);
+    engine.setClipGain(slotId, gainDb);
+
+    // Apply loop behavior
+    const bool loop = (clip.reproductionMode == 4) ? true : clip.isRepeat;
+    engine.setClipLoop(slotId, loop);
+    engine.setClipLoopCrossfade(slotId, clip.loopCrossfadeMs);
+    engine.setClipTrim(slotId, clip.trimStartMs, clip.trimEndMs);
+    engine.setClipPriority(slotId, clip.voicePriority);
+}
+
+bool SoundboardService::playClipsInSync(const QVariantList& clipIds, double quantizeMs)
 {
     if (!m_audioEngine)
         return false;
 
-    // Stop preview if playing (avoid device conflicts)
-    if (m_recordingPreviewPlaying) {
-        stopLastRecordingPreview();
+    QList<QPair<int, int>> prepared; // clipId, slotId
+    for (const QVariant& v : clipIds) {
+        bool ok = false;
+        const int clipId = v.toInt(&ok);
+        Clip* clip = ok ? findActiveClipById(clipId) : nullptr;
+        if (!clip || clip->filePath.isEmpty())
+            continue;
+
+        const int slotId = getOrAssignSlot(clipId);
+        if (slotId < 0)
+            continue;
+        m_slotToClipId[slotId] = clipId;
+        if (prepareClipSlot(clip, slotId))
+            prepared.append({clipId, slotId});
     }
+    if (prepared.isEmpty())
+        return false;
 
-    // Clear any previous pending recording to prevent re-save duplicates
-    m_hasUnsavedRecording = false;
-    m_lastRecordingPath.clear();
+    // One start frame for the whole group, picked after loading so slow loads don't eat into the lead time
+    const uint64_t startFrame = m_audioEngine->nextScheduleFrame(kScheduleLeadMs, quantizeMs);
+    for (const auto& [clipId, slotId] : prepared) {
+        m_audioEngine->playClipAt(slotId, startFrame);
+        if (Clip* clip = findActiveClipById(clipId))
+            clip->isPlaying = true;
+        emit clipPlaybackStarted(clipId);
+    }
+    emit activeClipsChanged();
 
-    emit recordingStateChanged(); // updates QML immediately
+    qDebug() << "playClipsInSync:" << prepared.size() << "clips at engine frame" << startFrame;
+    return true;
+}
 
-    m_lastRecordingPath = getRecordingOutputPath();
-    QDir().mkpath(QFileInfo(m_lastRecordingPath).absolutePath());
+bool SoundboardService::scheduleClip(int clipId, double delayMs, double quantizeMs)
+{
+    if (!m_audioEngine)
+        return false;
 
-    // Check if the recording device matches the application capture device
-    // If they are the same, we need to disable mic passthrough to avoid feedback
-    m_micPassthroughDisabledForRecording = false;
-    if (!m_selectedRecordingDeviceId.isEmpty() && m_selectedRecordingDeviceId != "-1" &&
-        m_state.settings.micPassthroughEnabled) {
-        // Check if recording device matches the app's capture device
-        if (m_selectedRecordingDeviceId == m_state.settings.selectedCaptureDeviceId) {
-            // Same device - disable mic passthrough to avoid feedback during recording
+    Clip* clip = findActiveClipById(clipId);
+    if (!clip || clip->filePath.isEmpty())
+        return false;
+
+    const int slotId = getOrAssignSlot(clipId);
+    if (slotId < 0)
+        return false;
+    m_slotToClipId[slotId] = clipId;
+    if (!prepareClipSlot(clip, slotId))
+        return false;
+
+    const uint64_t startFrame = m_audioEngine->nextScheduleFrame(std::max(delayMs, kScheduleLeadMs), quantizeMs);
+    m_audioEngine->playClipAt(slotId, startFrame);
+
+    clip->isPlaying = true;
+    emit activeClipsChanged();
+    emit clipPlaybackStarted(clipId);
+    return true;
+}
+
+bool SoundboardService::scheduleClipStop(int clipId, double delayMs, double quantizeMs)
+{
+    if (!m_audioEngine || !m_clipIdToSlot.contains(clipId))
+        return false;
+
+    // Bookkeeping happens in the finished callback once the engine has actually stopped the clip
+    const int slotId = m_clipIdToSlot[clipId];
+    m_audioEngine->stopClipAt(slotId, m_audioEngine->nextScheduleFrame(delayMs, quantizeMs));
+    return true;
+}
+
+void SoundboardService::stopClip(int clipId)
+{
+    if (!m_audioEngine)
+        return;
+    if (!m_clipIdToSlot.contains(clipId))
+        return;
+
+    int slotId = m_clipIdToSlot[clipId];
+    m_audioEngine->flushCommands();
+    stopExtraVoices(clipId);
+    m_audioEngine->stopClip(slotId);
+
+    // remove ownership mapping
+    m_slotToClipId.remove(slotId);
+
+    finalizeClipPlayback(clipId);
+    qDebug() << "Stopped clip" << clipId << "in slot" << slotId;
+}
+
+bool SoundboardService::startRecording()
+{
+    if (!m_audioEngine)
+        return false;
+
+    // Stop preview if playing (avoid device conflicts)
+    if (m_recordingPreviewPlaying) {
+        stopLastRecordingPreview();
+    }
+
+    // Clear any previous pending recording to prevent re-save duplicates
+    m_hasUnsavedRecording = false;
+    m_lastRecordingPath.clear();
+
+    emit recordingStateChanged(); // updates QML immediately
+
+    m_lastRecordingPath = getRecordingOutputPath();
+    QDir().mkpath(QFileInfo(m_lastRecordingPath).absolutePath());
+
+    // Check if the recording device matches the application capture device
+    // If they are the same, we need to disable mic passthrough to avoid feedback
+    m_micPassthroughDisabledForRecording = false;
+    if (!m_selectedRecordingDeviceId.isEmpty() && m_selectedRecordingDeviceId != "-1" &&
+        m_state.settings.micPassthroughEnabled) {
+        // Check if recording device matches the app's capture device
+        if (m_selectedRecordingDeviceId == m_state.settings.selectedCaptureDeviceId) {
+            // Same device - disable mic passthrough to avoid feedback during recording
             qDebug() << "Recording device matches capture device, temporarily disabling mic passthrough";
             m_audioEngine->setMicPassthroughEnabled(false);
             m_micPassthroughDisabledForRecording = true;
@@ -2714,6 +3114,12 @@ float SoundboardService::getRecordingPeakLevel() const
 }
 
 QVariantList SoundboardService::getWaveformPeaks(const QString& filePath, int numBars) const
+{
+    return computeWaveformPeaks(filePath, numBars, nullptr);
+}
+
+QVariantList SoundboardService::computeWaveformPeaks(const QString& filePath, int numBars,
+                                                     const std::atomic_bool* cancelled) const
 {
     QVariantList result;
 
@@ -2732,37 +3138,23 @@ QVariantList SoundboardService::getWaveformPeaks(const QString& filePath, int nu
         return result;
     }
 
-    // Try miniaudio first, then fallback to FFmpeg for unsupported formats (like Opus)
-    ma_decoder_config cfg = ma_decoder_config_init(ma_format_f32, 2, 48000);
-    ma_decoder decoder;
-    bool usingMiniaudio = false;
-    FFmpegDecoder ffmpegDec;
-
-    if (ma_decoder_init_file(localPath.toUtf8().constData(), &cfg, &decoder) == MA_SUCCESS) {
-        usingMiniaudio = true;
-    } else {
-        // Try FFmpeg as fallback (for Opus, etc.)
-        qDebug() << "getWaveformPeaks: miniaudio failed, trying FFmpeg for:" << localPath;
-        if (!ffmpegDec.open(localPath.toStdString(), 48000, 2)) {
-            qDebug() << "getWaveformPeaks: Both miniaudio and FFmpeg failed for:" << localPath;
-            return result;
-        }
-        qDebug() << "getWaveformPeaks: FFmpeg decoder opened successfully";
+    // Open with whichever backend decoded this file before (miniaudio first, FFmpeg for Opus etc.)
+    const std::string path = localPath.toStdString();
+    const DecoderBackend preferred =
+        m_audioEngine ? m_audioEngine->mediaInfoCache().preferredBackend(path) : DecoderBackend::Unknown;
+    ClipDecoder decoder;
+    if (!decoder.open(path, 48000, 2, preferred)) {
+        qDebug() << "getWaveformPeaks: Could not open:" << localPath;
+        return result;
+    }
+    if (m_audioEngine && decoder.backend() != preferred) {
+        m_audioEngine->mediaInfoCache().updateBackend(path, decoder.backend());
     }
 
     // Get total frames
-    ma_uint64 totalFrames = 0;
-    if (usingMiniaudio) {
-        if (ma_decoder_get_length_in_pcm_frames(&decoder, &totalFrames) != MA_SUCCESS || totalFrames == 0) {
-            ma_decoder_uninit(&decoder);
-            return result;
-        }
-    } else {
-        totalFrames = ffmpegDec.getLengthInPcmFrames();
-        if (totalFrames == 0) {
-            ffmpegDec.close();
-            return result;
-        }
+    const ma_uint64 totalFrames = decoder.getLengthInPcmFrames();
+    if (totalFrames == 0) {
+        return result;
     }
 
     // Calculate frames per bar
@@ -2779,17 +3171,14 @@ QVariantList SoundboardService::getWaveformPeaks(const QString& filePath, int nu
     peaks.reserve(numBars);
 
     for (int bar = 0; bar < numBars; ++bar) {
-        // Seek to the start of this bar's segment
-        ma_uint64 startFrame = (ma_uint64)bar * framesPerBar;
-        bool seekOk = false;
-
-        if (usingMiniaudio) {
-            seekOk = (ma_decoder_seek_to_pcm_frame(&decoder, startFrame) == MA_SUCCESS);
-        } else {
-            seekOk = ffmpegDec.seekToPcmFrame(startFrame);
+        // Board was deactivated (or the service is shutting down) - stop decoding
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+            return result;
         }
 
-        if (!seekOk) {
+        // Seek to the start of this bar's segment
+        ma_uint64 startFrame = (ma_uint64)bar * framesPerBar;
+        if (!decoder.seekToPcmFrame(startFrame)) {
             peaks.append(0.1f);
             continue;
         }
@@ -2799,18 +3188,9 @@ QVariantList SoundboardService::getWaveformPeaks(const QString& filePath, int nu
 
         while (framesRemaining > 0) {
             ma_uint64 framesToRead = std::min((ma_uint64)kBufferSize, framesRemaining);
-            ma_uint64 framesRead = 0;
-
-            if (usingMiniaudio) {
-                if (ma_decoder_read_pcm_frames(&decoder, buffer, framesToRead, &framesRead) != MA_SUCCESS ||
-                    framesRead == 0) {
-                    break;
-                }
-            } else {
-                framesRead = ffmpegDec.readPcmFrames(buffer, framesToRead);
-                if (framesRead == 0) {
-                    break;
-                }
+            uint64_t framesRead = 0;
+            if (decoder.readPcmFrames(buffer, framesToRead, &framesRead) != MA_SUCCESS || framesRead == 0) {
+                break;
             }
 
             // Find max amplitude in this chunk (stereo - 2 channels)
@@ -2828,13 +3208,6 @@ QVariantList SoundboardService::getWaveformPeaks(const QString& filePath, int nu
             globalMaxPeak = maxPeak;
     }
 
-    // Clean up
-    if (usingMiniaudio) {
-        ma_decoder_uninit(&decoder);
-    } else {
-        ffmpegDec.close();
-    }
-
     // Normalize peaks to 0.1 - 1.0 range
     for (int i = 0; i < peaks.size(); ++i) {
         float normalized = 0.1f;
@@ -3244,6 +3617,15 @@ void SoundboardService::finalizeClipPlayback(int clipId)
         saveActive();
     }
 
+    // Unmute clips this one ducked, whatever else is playing (a clip replayed since is back at 0 dB anyway)
+    if (m_mutedByClip.contains(clipId)) {
+        const QList<int> mutedClips = m_mutedByClip.take(clipId);
+        for (int mutedClipId : mutedClips) {
+            for (int voice : voicesOf(mutedClipId))
+                m_audioEngine->rampClipLevel(voice, 0.0f, kOtherSoundsFadeMs);
+        }
+    }
+
     // If something else is currently playing (not paused), DO NOT auto-resume paused clips.
 
     QVariantList others = playingClipIDs(); // excludes paused by your logic
@@ -3299,6 +3681,18 @@ void SoundboardService::stopAllClips()
     if (!m_audioEngine) {
         return;
     }
+    m_audioEngine->flushCommands();
+
+    // Pending macro steps would start clips again right after this
+    if (m_macroSequencer) {
+        m_macroSequencer->stopAll();
+    }
+
+    for (auto it = m_extraVoices.begin(); it != m_extraVoices.end(); ++it) {
+        m_audioEngine->stopClip(it.value());
+        m_slotToClipId.remove(it.value());
+    }
+    m_extraVoices.clear();
 
     for (auto it = m_clipIdToSlot.begin(); it != m_clipIdToSlot.end(); ++it) {
         m_audioEngine->stopClip(it.value());
@@ -3309,6 +3703,9 @@ void SoundboardService::stopAllClips()
         }
     }
 
+    // Every clip is stopped, so there is nothing left to unmute
+    m_mutedByClip.clear();
+
     // Restore mic if any clips had muted it
     if (!m_clipsThatMutedMic.isEmpty()) {
         m_clipsThatMutedMic.clear();
@@ -3345,6 +3742,7 @@ void SoundboardService::stopClipsForBoard(int boardId)
 
         if (m_clipIdToSlot.contains(clipId)) {
             int slotId = m_clipIdToSlot.value(clipId);
+            stopExtraVoices(clipId);
             m_audioEngine->stopClip(slotId);
             m_audioEngine->unloadClip(slotId);
             m_clipIdToSlot.remove(clipId);
@@ -3438,7 +3836,12 @@ double SoundboardService::getClipDurationMs(int clipId) const
     for (auto it = m_activeBoards.begin(); it != m_activeBoards.end(); ++it) {
         for (const auto& clip : it.value().clips) {
             if (clip.id == clipId) {
-                return clip.durationSec * 1000.0;
+                if (clip.durationSec > 0.0 || !m_audioEngine)
+                    return clip.durationSec * 1000.0;
+                // Not stored yet - the engine's media info cache avoids reopening the file on every call.
+                // getFileDuration() returns -1 for files it cannot open.
+                const double sec = m_audioEngine->getFileDuration(sanitizeFilePath(clip.filePath).toStdString());
+                return std::max(0.0, sec) * 1000.0;
             }
         }
     }
@@ -3483,41 +3886,158 @@ QVariantList SoundboardService::playingClipIDs() const
     return playingIds;
 }
 
-int SoundboardService::getOrAssignSlot(int clipId)
+int SoundboardService::getOrAssignSlot(int clipId, uint32_t keepSlots)
 {
     if (m_clipIdToSlot.contains(clipId))
         return m_clipIdToSlot[clipId];
+    if (!m_audioEngine)
+        return -1;
 
-    QSet<int> usedSlots;
-    for (auto it = m_clipIdToSlot.begin(); it != m_clipIdToSlot.end(); ++it)
-        usedSlots.insert(it.value());
+    const Clip* clip = findActiveClipById(clipId);
+    const int priority = clip ? clip->voicePriority : 0;
+
+    // A running macro's steps name their slots, so those keep their clip until it ends
+    const uint32_t allowed = kClipVoiceMask & ~(macroPinnedSlots() | keepSlots);
+
+    // Voices no clip holds go first, so clips left loaded in the others stay ready for the hotkey fast path
+    uint32_t held = 0;
+    for (int s : std::as_const(m_clipIdToSlot))
+        held |= 1u << s;
+    for (int s : std::as_const(m_extraVoices))
+        held |= 1u << s;
+
+    int slotId = -1;
+    if ((allowed & ~held) != 0)
+        slotId = m_audioEngine->acquireVoice(allowed & ~held, priority);
+    if (slotId < 0 && allowed != 0)
+        slotId = m_audioEngine->acquireVoice(allowed, priority);
+    if (slotId < 0)
+        return -1;
 
-    // Only use 0..14 (reserve 15 for preview)
-    for (int i = 0; i < kClipSlotsUsable; ++i) {
-        int candidateSlot = (m_nextSlot + i) % kClipSlotsUsable;
-        if (!usedSlots.contains(candidateSlot)) {
-            m_clipIdToSlot[clipId] = candidateSlot;
-            m_nextSlot = (candidateSlot + 1) % kClipSlotsUsable;
-            return candidateSlot;
-        }
+    releaseSlotOwner(slotId);
+    m_clipIdToSlot[clipId] = slotId;
+    return slotId;
+}
+
+int SoundboardService::acquireOverlapVoice(Clip& clip)
+{
+    const QList<int> voices = voicesOf(clip.id);
+    uint32_t own = 0;
+    for (int s : voices)
+        own |= 1u << s;
+
+    // Below the clip's polyphony another voice is taken like for any new sound; at it, its own oldest is reused
+    const uint32_t others = kClipVoiceMask & ~own & ~macroPinnedSlots();
+    int slotId = -1;
+    if (voices.size() < clip.polyphony && others != 0)
+        slotId = m_audioEngine->acquireVoice(others, clip.voicePriority);
+    if (slotId < 0)
+        slotId = m_audioEngine->acquireVoice(own, clip.voicePriority, AudioEngine::VoiceStealPolicy::Oldest);
+    if (slotId < 0)
+        return -1;
+
+    releaseSlotOwner(slotId);
+
+    // The newest instance is the primary: position, pause and seek follow it
+    if (m_clipIdToSlot.contains(clip.id))
+        m_extraVoices.insert(clip.id, m_clipIdToSlot.value(clip.id));
+    m_clipIdToSlot[clip.id] = slotId;
+    m_slotToClipId[slotId] = clip.id;
+    return slotId;
+}
+
+uint32_t SoundboardService::macroPinnedSlots() const
+{
+    uint32_t pinned = 0;
+    for (const QList<int>& slots : m_macroSlots) {
+        for (int s : slots)
+            pinned |= 1u << s;
     }
+    return pinned;
+}
 
-    // Evict using round-robin within usable slots only
-    int slotId = m_nextSlot % kClipSlotsUsable;
+void SoundboardService::releaseSlotOwner(int slotId)
+{
+    m_slotToClipId.remove(slotId);
 
-    for (auto it = m_clipIdToSlot.begin(); it != m_clipIdToSlot.end();) {
-        if (it.value() == slotId && it.key() != clipId) {
-            if (m_audioEngine && m_audioEngine->isClipPlaying(slotId))
-                m_audioEngine->stopClip(slotId);
-            it = m_clipIdToSlot.erase(it);
-        } else {
-            ++it;
+    int owner = -1;
+    for (auto it = m_clipIdToSlot.begin(); it != m_clipIdToSlot.end(); ++it) {
+        if (it.value() == slotId) {
+            owner = it.key();
+            m_clipIdToSlot.erase(it);
+            // A polyphonic clip keeps sounding on its other instances
+            auto extra = m_extraVoices.find(owner);
+            if (extra != m_extraVoices.end()) {
+                m_clipIdToSlot[owner] = extra.value();
+                m_extraVoices.erase(extra);
+            }
+            break;
+        }
+    }
+    if (owner == -1) {
+        for (auto it = m_extraVoices.begin(); it != m_extraVoices.end(); ++it) {
+            if (it.value() == slotId) {
+                owner = it.key();
+                m_extraVoices.erase(it);
+                break;
+            }
         }
     }
 
-    m_clipIdToSlot[clipId] = slotId;
-    m_nextSlot = (slotId + 1) % kClipSlotsUsable;
-    return slotId;
+    // Its last voice was stolen mid-playback: a stolen voice reports no end, so wrap up here
+    const Clip* clip = owner != -1 ? findActiveClipById(owner) : nullptr;
+    if (clip && clip->isPlaying && !m_clipIdToSlot.contains(owner)) {
+        QMetaObject::invokeMethod(
+            this,
+            [this, owner]() {
+                if (!m_clipIdToSlot.contains(owner))
+                    finalizeClipPlayback(owner);
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+QList<int> SoundboardService::voicesOf(int clipId) const
+{
+    QList<int> voices;
+    if (m_clipIdToSlot.contains(clipId))
+        voices.append(m_clipIdToSlot.value(clipId));
+    voices.append(m_extraVoices.values(clipId));
+    return voices;
+}
+
+void SoundboardService::stopExtraVoices(int clipId)
+{
+    if (!m_audioEngine)
+        return;
+    const QList<int> extras = m_extraVoices.values(clipId);
+    m_extraVoices.remove(clipId);
+    for (int slotId : extras) {
+        m_slotToClipId.remove(slotId);
+        m_audioEngine->stopClip(slotId);
+    }
+}
+
+void SoundboardService::handleVoiceFinished(int clipId, int slotId)
+{
+    // The voice went to another sound (or was restarted) before this got here
+    if (m_slotToClipId.value(slotId, -1) != clipId || (m_audioEngine && m_audioEngine->isClipPlaying(slotId)))
+        return;
+
+    // One instance of a polyphonic clip ended; the clip plays on while any other does
+    if (m_extraVoices.remove(clipId, slotId) > 0) {
+        m_slotToClipId.remove(slotId);
+        return;
+    }
+    if (m_clipIdToSlot.value(clipId, -1) == slotId && m_extraVoices.contains(clipId)) {
+        auto extra = m_extraVoices.find(clipId);
+        m_clipIdToSlot[clipId] = extra.value();
+        m_extraVoices.erase(extra);
+        m_slotToClipId.remove(slotId);
+        return;
+    }
+
+    finalizeClipPlayback(clipId);
 }
 
 // ============================================================================
@@ -3713,6 +4233,141 @@ void SoundboardService::resetPeakLevels()
     }
 }
 
+static QVariantMap meterReadingToMap(const BusMeter::Reading& r)
+{
+    QVariantMap m;
+    m["rms"] = r.rms;
+    m["peak"] = r.peak;
+    m["truePeak"] = r.truePeak;
+    m["momentaryLufs"] = r.momentaryLufs;
+    m["shortTermLufs"] = r.shortTermLufs;
+    return m;
+}
+
+QVariantMap SoundboardService::getMeters() const
+{
+    QVariantMap result;
+    if (!m_audioEngine)
+        return result;
+
+    const AudioEngine::MeterSnapshot snap = m_audioEngine->getMeterSnapshot();
+    result["mic"] = meterReadingToMap(snap.mic);
+    result["master"] = meterReadingToMap(snap.master);
+    result["monitor"] = meterReadingToMap(snap.monitor);
+
+    QVariantMap clipRms;
+    QVariantMap clipPeak;
+    for (auto it = m_clipIdToSlot.constBegin(); it != m_clipIdToSlot.constEnd(); ++it) {
+        AudioEngine::VoiceMeterReading loudest = snap.voices[it.value()];
+        for (int extraSlotId : m_extraVoices.values(it.key())) {
+            loudest.rms = std::max(loudest.rms, snap.voices[extraSlotId].rms);
+            loudest.peak = std::max(loudest.peak, snap.voices[extraSlotId].peak);
+        }
+        const QString key = QString::number(it.key());
+        clipRms[key] = loudest.rms;
+        clipPeak[key] = loudest.peak;
+    }
+    result["clipRms"] = clipRms;
+    result["clipPeak"] = clipPeak;
+    return result;
+}
+
+void SoundboardService::resetMeters()
+{
+    if (m_audioEngine) {
+        m_audioEngine->resetMeters();
+    }
+}
+
+void SoundboardService::watchPlaybackTelemetry(bool watching)
+{
+    m_playbackWatchers = std::max(0, m_playbackWatchers + (watching ? 1 : -1));
+    publishTelemetry();
+}
+
+void SoundboardService::watchMeterTelemetry(bool watching)
+{
+    m_meterWatchers = std::max(0, m_meterWatchers + (watching ? 1 : -1));
+    publishTelemetry();
+}
+
+void SoundboardService::updateTelemetryTimer()
+{
+    if (!m_telemetryTimer)
+        return;
+
+    // Meters move on their own; playback data only changes while something plays or a macro may start it
+    const bool playbackLive = !m_playbackTelemetry.value("playing").toList().isEmpty() || !m_macroSlots.isEmpty();
+    const bool wanted = m_meterWatchers > 0 || (m_playbackWatchers > 0 && playbackLive);
+    if (wanted && !m_telemetryTimer->isActive())
+        m_telemetryTimer->start();
+    else if (!wanted && m_telemetryTimer->isActive())
+        m_telemetryTimer->stop();
+}
+
+void SoundboardService::publishTelemetry()
+{
+    if (!m_audioEngine)
+        return;
+
+    const AudioEngine::TelemetrySnapshot snap = m_audioEngine->getTelemetrySnapshot();
+
+    if (m_playbackWatchers > 0) {
+        QVariantList playing;
+        QVariantMap progress;
+        QVariantMap positions;
+        for (auto it = m_activeBoards.constBegin(); it != m_activeBoards.constEnd(); ++it) {
+            for (const auto& clip : it.value().clips) {
+                const int slotId = m_clipIdToSlot.value(clip.id, -1);
+                const AudioEngine::VoiceTelemetry voice =
+                    slotId >= 0 ? snap.voices[slotId] : AudioEngine::VoiceTelemetry();
+
+                // Same rule as playingClipIDs()
+                if ((clip.isPlaying || voice.playing) && !voice.paused)
+                    playing.append(clip.id);
+                if (!voice.playing)
+                    continue;
+
+                const QString key = QString::number(clip.id);
+                positions[key] = voice.positionMs;
+
+                // Progress within the trimmed region, as getClipPlaybackProgress()
+                const double totalMs = clip.durationSec * 1000.0;
+                const double endMs = clip.trimEndMs > 0.0 ? clip.trimEndMs : totalMs;
+                const double spanMs = endMs - clip.trimStartMs;
+                progress[key] =
+                    spanMs > 0.0 ? std::clamp((voice.positionMs - clip.trimStartMs) / spanMs, 0.0, 1.0) : 0.0;
+            }
+        }
+
+        QVariantMap playback;
+        playback["playing"] = playing;
+        playback["progress"] = progress;
+        playback["positionMs"] = positions;
+
+        // An idle board costs no QML work
+        if (playback != m_playbackTelemetry) {
+            m_playbackTelemetry = playback;
+            emit playbackTelemetryChanged();
+        }
+    }
+
+    if (m_meterWatchers > 0) {
+        QVariantMap meters;
+        meters["mic"] = meterReadingToMap(snap.meters.mic);
+        meters["master"] = meterReadingToMap(snap.meters.master);
+        meters["monitor"] = meterReadingToMap(snap.meters.monitor);
+
+        // Nor do settled meters
+        if (meters != m_meterTelemetry) {
+            m_meterTelemetry = meters;
+            emit meterTelemetryChanged();
+        }
+    }
+
+    updateTelemetryTimer();
+}
+
 // ============================================================================
 // MIXER CONTROLS
 // ============================================================================
@@ -3816,6 +4471,21 @@ void SoundboardService::setNoiseSuppressionLevel(int level)
     emit settingsChanged();
 }
 
+void SoundboardService::setRecordingInputNoiseSuppressionLevel(int level)
+{
+    level = qBound(0, level, 4);
+    if (m_state.settings.recordingInputNoiseSuppressionLevel == level)
+        return;
+
+    m_state.settings.recordingInputNoiseSuppressionLevel = level;
+    if (m_audioEngine) {
+        m_audioEngine->setRecordingInputNoiseSuppressionLevel(level);
+    }
+
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
 QStringList SoundboardService::getNoiseSuppressionLevelNames() const
 {
     return QStringList() << "Off" << "Low" << "Moderate" << "High" << "Very High";
@@ -3868,8 +4538,452 @@ bool SoundboardService::setBoardHotkey(int boardId, const QString& hotkey)
 // HOTKEY ACTION HANDLER
 // ============================================================================
 
+// ============================================================
+// Trigger latency
+// ============================================================
+QVariantMap SoundboardService::getTriggerLatencyStats() const
+{
+    QVariantMap result;
+    if (!m_audioEngine)
+        return result;
+
+    QVariantMap stages;
+    for (int i = 0; i < (int)AudioEngine::LatencyStage::Count; ++i) {
+        const auto stage = static_cast<AudioEngine::LatencyStage>(i);
+        const LatencyHistogram::Summary sum = m_audioEngine->getLatencySummary(stage);
+
+        QVariantMap sm;
+        sm["count"] = (qulonglong)sum.count;
+        sm["p50Ms"] = sum.p50Ms;
+        sm["p95Ms"] = sum.p95Ms;
+        sm["p99Ms"] = sum.p99Ms;
+        sm["maxMs"] = sum.maxMs;
+        sm["meanMs"] = sum.meanMs;
+        stages[AudioEngine::latencyStageName(stage)] = sm;
+    }
+
+    result["outputLatencyMs"] = m_audioEngine->getOutputLatencyMs();
+    result["bufferSizeFrames"] = m_state.settings.bufferSizeFrames;
+    result["bufferPeriods"] = m_state.settings.bufferPeriods;
+    result["stages"] = stages;
+    return result;
+}
+
+bool SoundboardService::dumpTriggerLatencyStats(const QString& filePath) const
+{
+    if (!m_audioEngine)
+        return false;
+
+    QFile f(sanitizeFilePath(filePath));
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "dumpTriggerLatencyStats: cannot write" << filePath;
+        return false;
+    }
+
+    QTextStream out(&f);
+    out << "# TalkLess trigger latency, " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
+    out << "# bufferSizeFrames=" << m_state.settings.bufferSizeFrames
+        << " bufferPeriods=" << m_state.settings.bufferPeriods << " sampleRate=" << m_state.settings.sampleRate
+        << " outputLatencyMs=" << m_audioEngine->getOutputLatencyMs() << "\n";
+    out << "stage,count,p50Ms,p95Ms,p99Ms,maxMs,meanMs\n";
+    for (int i = 0; i < (int)AudioEngine::LatencyStage::Count; ++i) {
+        const auto stage = static_cast<AudioEngine::LatencyStage>(i);
+        const LatencyHistogram::Summary sum = m_audioEngine->getLatencySummary(stage);
+        out << AudioEngine::latencyStageName(stage) << ',' << sum.count << ',' << sum.p50Ms << ',' << sum.p95Ms
+            << ',' << sum.p99Ms << ',' << sum.maxMs << ',' << sum.meanMs << "\n";
+    }
+    return true;
+}
+
+void SoundboardService::resetTriggerLatencyStats()
+{
+    if (m_audioEngine)
+        m_audioEngine->resetLatencyStats();
+}
+
+QVariantMap SoundboardService::getEngineHealth() const
+{
+    QVariantMap result;
+    if (!m_audioEngine)
+        return result;
+
+    QVariantMap callbacks;
+    for (int i = 0; i < (int)AudioEngine::EngineCallback::Count; ++i) {
+        const auto cb = static_cast<AudioEngine::EngineCallback>(i);
+        const CallbackProfiler::Snapshot snap = m_audioEngine->getCallbackProfile(cb);
+
+        QVariantMap cm;
+        cm["blocks"] = (qulonglong)snap.blocks;
+        cm["deadlineMisses"] = (qulonglong)snap.deadlineMisses;
+        cm["periodUs"] = snap.periodUs;
+        cm["lastUs"] = snap.lastUs;
+        cm["avgUs"] = snap.avgUs;
+        cm["worstUs"] = snap.worstUs;
+        cm["avgLoad"] = snap.avgLoad;
+        cm["worstLoad"] = snap.worstLoad;
+        callbacks[AudioEngine::engineCallbackName(cb)] = cm;
+    }
+
+    const AudioEngine::XrunCounters xruns = m_audioEngine->getXrunCounters();
+    result["callbacks"] = callbacks;
+    result["captureOverruns"] = (qulonglong)xruns.captureOverruns;
+    result["recordingOverruns"] = (qulonglong)xruns.recordingOverruns;
+    result["recordingInputOverruns"] = (qulonglong)xruns.recordingInputOverruns;
+    result["clipUnderruns"] = (qulonglong)xruns.clipUnderruns;
+    result["voiceRingBytes"] = (qulonglong)m_audioEngine->getVoiceRingMemoryBytes();
+    result["noiseSuppressionLatencyMs"] = m_audioEngine->getNoiseSuppressionLatencyMs();
+    result["voiceDuckGainDb"] = m_audioEngine->getVoiceDuckGainDb();
+    result["voicesStolen"] = (qulonglong)m_audioEngine->getVoicesStolen();
+    result["deviceRunning"] = m_audioEngine->isDeviceRunning();
+    return result;
+}
+
+void SoundboardService::resetEngineHealth()
+{
+    if (m_audioEngine)
+        m_audioEngine->resetEngineHealth();
+}
+
+// ============================================================
+// Offline session render
+// ============================================================
+bool SoundboardService::renderSessionToFile(const QVariantList& triggers, const QString& micInputPath,
+                                            const QString& outputPath, double durationMs)
+{
+    const QString outPath = sanitizeFilePath(outputPath);
+    if (outPath.isEmpty()) {
+        emit errorOccurred("No output file for the session render");
+        return false;
+    }
+    if (!outPath.endsWith(".wav", Qt::CaseInsensitive)) {
+        // miniaudio only encodes WAV
+        emit errorOccurred("Session renders are written as WAV; use a .wav file name");
+        return false;
+    }
+
+    // Each distinct clip gets its own slot on the private engine
+    QHash<int, int> slotByClipId;
+    QVector<QPair<int, Clip>> slotClips;
+    std::vector<AudioEngine::OfflineTrigger> engineTriggers;
+
+    for (const QVariant& v : triggers) {
+        const QVariantMap t = v.toMap();
+        const int clipId = t.value("clipId", -1).toInt();
+
+        if (!slotByClipId.contains(clipId)) {
+            std::optional<Clip> clip = findClipByIdAnyBoard(clipId);
+            if (!clip || clip->filePath.isEmpty()) {
+                emit errorOccurred(QString("Session render: unknown clip %1").arg(clipId));
+                return false;
+            }
+            if (slotClips.size() >= AudioEngine::MAX_CLIPS) {
+                emit errorOccurred(
+                    QString("Session render: at most %1 different clips per session").arg(AudioEngine::MAX_CLIPS));
+                return false;
+            }
+            slotByClipId.insert(clipId, slotClips.size());
+            slotClips.append({(int)slotClips.size(), *clip});
+        }
+
+        AudioEngine::OfflineTrigger trigger;
+        trigger.timeMs = t.value("timeMs").toDouble();
+        trigger.slotId = slotByClipId.value(clipId);
+        trigger.action = t.value("action").toString().compare("stop", Qt::CaseInsensitive) == 0
+                             ? AudioEngine::OfflineTrigger::Action::Stop
+                             : AudioEngine::OfflineTrigger::Action::Play;
+        engineTriggers.push_back(trigger);
+    }
+
+    const AppSettings settings = m_state.settings;
+    const QString micPath = micInputPath.isEmpty() ? QString() : sanitizeFilePath(micInputPath);
+
+    (void)QtConcurrent::run([this, settings, slotClips, engineTriggers, micPath, outPath, durationMs]() {
+        // Private engine: never touches the live devices, mixed exactly like the live main output
+        AudioEngine engine;
+        engine.setAudioConfig(static_cast<ma_uint32>(settings.sampleRate),
+                              static_cast<ma_uint32>(settings.bufferSizeFrames),
+                              static_cast<ma_uint32>(settings.bufferPeriods), static_cast<ma_uint32>(settings.channels));
+        engine.setMasterGainDB(static_cast<float>(settings.masterGainDb));
+        engine.setMicGainDB(static_cast<float>(settings.micGainDb));
+        engine.setMicEnabled(settings.micEnabled);
+        engine.setMicPassthroughEnabled(settings.micPassthroughEnabled);
+        engine.setMicSoundboardBalance(settings.micSoundboardBalance);
+        engine.setNoiseSuppressionLevel(settings.noiseSuppressionLevel);
+        engine.setClipFadeMs(settings.clipFadeMs);
+        engine.setVoiceDucking(voiceDuckSettings(settings));
+        engine.setResamplerQuality(static_cast<ResamplerQuality>(settings.resamplerQuality));
+
+        AudioEngine::OfflineRenderResult result;
+        for (const auto& [slotId, clip] : slotClips) {
+            auto [startSec, endSec] = engine.loadClip(slotId, sanitizeFilePath(clip.filePath).toUtf8().toStdString());
+            if (startSec == endSec) {
+                result.error = "Cannot load " + clip.filePath.toStdString();
+                break;
+            }
+            configureClipSlot(engine, clip, slotId);
+        }
+        if (result.error.empty())
+            result = engine.renderSession(engineTriggers, micPath.toUtf8().toStdString(), outPath.toUtf8().toStdString(),
+                                          durationMs);
+
+        const double renderedSec = (double)result.framesRendered / std::max<ma_uint32>(1, engine.getSampleRate());
+        const double realtimeFactor = result.wallSeconds > 0.0 ? renderedSec / result.wallSeconds : 0.0;
+        qDebug() << "Session render:" << outPath << "success:" << result.success << "seconds:" << renderedSec
+                 << "x realtime:" << realtimeFactor;
+
+        QMetaObject::invokeMethod(
+            this,
+            [this, result, outPath, realtimeFactor]() {
+                emit sessionRenderFinished(result.success, outPath, QString::fromStdString(result.error),
+                                           realtimeFactor);
+            },
+            Qt::QueuedConnection);
+    });
+    return true;
+}
+
+// ============================================================
+// Macros
+// ============================================================
+Macro* SoundboardService::findMacroById(int macroId)
+{
+    for (auto& m : m_macros) {
+        if (m.id == macroId)
+            return &m;
+    }
+    return nullptr;
+}
+
+QVariantList SoundboardService::getMacros() const
+{
+    QVariantList list;
+    for (const auto& m : m_macros) {
+        QVariantList steps;
+        for (const auto& step : m.steps) {
+            QVariantMap sm;
+            sm["type"] = StorageRepository::macroStepTypeToName(step.type);
+            sm["clipId"] = step.clipId;
+            sm["durationMs"] = step.durationMs;
+            sm["gainDb"] = step.gainDb;
+            steps.append(sm);
+        }
+
+        QVariantMap mm;
+        mm["id"] = m.id;
+        mm["name"] = m.name;
+        mm["hotkey"] = m.hotkey;
+        mm["steps"] = steps;
+        mm["isRunning"] = isMacroRunning(m.id);
+        list.append(mm);
+    }
+    return list;
+}
+
+int SoundboardService::createMacro(const QString& name)
+{
+    int maxId = 0;
+    for (const auto& m : m_macros)
+        maxId = std::max(maxId, m.id);
+
+    Macro macro;
+    macro.id = maxId + 1;
+    macro.name = name.trimmed().isEmpty() ? QString("Macro %1").arg(macro.id) : name.trimmed();
+    m_macros.append(macro);
+
+    m_repo.saveMacros(m_macros);
+    emit macrosChanged();
+    return macro.id;
+}
+
+bool SoundboardService::deleteMacro(int macroId)
+{
+    for (int i = 0; i < m_macros.size(); ++i) {
+        if (m_macros[i].id == macroId) {
+            stopMacro(macroId);
+            m_macros.removeAt(i);
+            m_repo.saveMacros(m_macros);
+            emit macrosChanged();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SoundboardService::renameMacro(int macroId, const QString& name)
+{
+    Macro* macro = findMacroById(macroId);
+    if (!macro || name.trimmed().isEmpty())
+        return false;
+
+    macro->name = name.trimmed();
+    m_repo.saveMacros(m_macros);
+    emit macrosChanged();
+    return true;
+}
+
+bool SoundboardService::setMacroSteps(int macroId, const QVariantList& steps)
+{
+    Macro* macro = findMacroById(macroId);
+    if (!macro)
+        return false;
+
+    QVector<MacroStep> parsed;
+    for (const QVariant& v : steps) {
+        const QVariantMap sm = v.toMap();
+        const auto type = StorageRepository::macroStepTypeFromName(sm.value("type").toString());
+        if (!type) {
+            qWarning() << "setMacroSteps: unknown step type" << sm.value("type");
+            return false;
+        }
+
+        MacroStep step;
+        step.type = *type;
+        step.clipId = sm.value("clipId", -1).toInt();
+        step.durationMs = std::max(0.0, sm.value("durationMs", 0.0).toDouble());
+        step.gainDb = std::clamp(sm.value("gainDb", 0.0).toDouble(), -60.0, 12.0);
+        parsed.append(step);
+    }
+
+    macro->steps = parsed;
+    m_repo.saveMacros(m_macros);
+    emit macrosChanged();
+    return true;
+}
+
+bool SoundboardService::setMacroHotkey(int macroId, const QString& hotkey)
+{
+    Macro* macro = findMacroById(macroId);
+    if (!macro)
+        return false;
+
+    macro->hotkey = hotkey;
+    m_repo.saveMacros(m_macros);
+    emit macrosChanged();
+    return true;
+}
+
+bool SoundboardService::runMacro(int macroId)
+{
+    const Macro* macro = findMacroById(macroId);
+    if (!macro || macro->steps.isEmpty() || !m_audioEngine || !m_macroSequencer)
+        return false;
+
+    // Every clip the macro touches is loaded into a slot up front, so the sequencer thread
+    // only has to start and stop slots on the engine clock. The slots stay pinned to their
+    // clips until the macro ends (see macroPinnedSlots), so nothing evicts them meanwhile.
+    QHash<int, int> clipSlots; // clipId -> slotId
+    uint32_t claimed = 0;
+    std::vector<MacroSequencer::Step> steps;
+    QVector<int> stepClipIds;
+    for (const MacroStep& ms : macro->steps) {
+        MacroSequencer::Step step;
+        switch (ms.type) {
+        case MacroStep::Type::PlayClip:
+            step.type = MacroSequencer::Step::Type::PlayClip;
+            break;
+        case MacroStep::Type::StopClip:
+            step.type = MacroSequencer::Step::Type::StopClip;
+            break;
+        case MacroStep::Type::Wait:
+            step.type = MacroSequencer::Step::Type::Wait;
+            step.value = ms.durationMs;
+            break;
+        case MacroStep::Type::WaitClipEnd:
+            step.type = MacroSequencer::Step::Type::WaitClipEnd;
+            break;
+        case MacroStep::Type::SetGain:
+            step.type = MacroSequencer::Step::Type::SetGain;
+            step.value = ms.gainDb;
+            break;
+        case MacroStep::Type::DuckMic:
+            step.type = MacroSequencer::Step::Type::DuckMic;
+            step.value = ms.gainDb;
+            break;
+        case MacroStep::Type::StopAll:
+            step.type = MacroSequencer::Step::Type::StopAll;
+            break;
+        }
+
+        const bool needsClip = ms.type == MacroStep::Type::PlayClip || ms.type == MacroStep::Type::StopClip ||
+                               ms.type == MacroStep::Type::WaitClipEnd || ms.type == MacroStep::Type::SetGain;
+        if (needsClip) {
+            if (!clipSlots.contains(ms.clipId)) {
+                Clip* clip = findActiveClipById(ms.clipId);
+                if (!clip || clip->filePath.isEmpty()) {
+                    emit errorOccurred(QString("Macro \"%1\" uses a clip that is not on an active soundboard")
+                                           .arg(macro->name));
+                    return false;
+                }
+                if (clipSlots.size() >= kClipSlotsUsable) {
+                    emit errorOccurred(
+                        QString("Macro \"%1\" uses more clips than can play at once").arg(macro->name));
+                    return false;
+                }
+
+                const int slotId = getOrAssignSlot(ms.clipId, claimed);
+                if (slotId < 0) {
+                    emit errorOccurred(
+                        QString("Macro \"%1\" found every voice busy with higher-priority clips").arg(macro->name));
+                    return false;
+                }
+                m_slotToClipId[slotId] = ms.clipId;
+                if (!prepareClipSlot(clip, slotId))
+                    return false;
+                clipSlots.insert(ms.clipId, slotId);
+                claimed |= 1u << slotId;
+            }
+            step.slotId = clipSlots.value(ms.clipId);
+        }
+
+        steps.push_back(step);
+        stepClipIds.append(needsClip ? ms.clipId : -1);
+    }
+
+    m_runningMacroClipIds.insert(macroId, stepClipIds);
+    m_macroSlots.insert(macroId, clipSlots.values());
+    m_macroSequencer->start(macroId, std::move(steps), kScheduleLeadMs);
+    updateTelemetryTimer(); // its clips start on the sequencer thread, without activeClipsChanged
+    emit macroStarted(macroId);
+
+    qDebug() << "Macro started:" << macroId << macro->name;
+    return true;
+}
+
+void SoundboardService::stopMacro(int macroId)
+{
+    if (m_macroSequencer)
+        m_macroSequencer->stop(macroId);
+}
+
+bool SoundboardService::isMacroRunning(int macroId) const
+{
+    return m_macroSequencer && m_macroSequencer->isRunning(macroId);
+}
+
+void SoundboardService::handleMacroStep(int macroId, int stepIndex)
+{
+    const QVector<int> clipIds = m_runningMacroClipIds.value(macroId);
+    const Macro* macro = findMacroById(macroId);
+    if (!macro || stepIndex < 0 || stepIndex >= clipIds.size() || stepIndex >= macro->steps.size())
+        return;
+
+    // Playback UI state only; stops are reported by the engine's finished callback
+    if (macro->steps[stepIndex].type == MacroStep::Type::PlayClip) {
+        const int clipId = clipIds[stepIndex];
+        if (Clip* clip = findActiveClipById(clipId)) {
+            clip->isPlaying = true;
+            emit clipPlaybackStarted(clipId);
+            emit activeClipsChanged();
+        }
+    }
+}
+
 void SoundboardService::handleHotkeyAction(const QString& actionId)
 {
+    const qint64 actionNs = latencyClockNs();
+    const qint64 pressNs = m_lastHotkeyPressNs >= 0 ? m_lastHotkeyPressNs : actionNs;
+    m_lastHotkeyPressNs = -1;
+
     qDebug() << "Hotkey action received:" << actionId;
 
     if (actionId == "sys.toggleMute") {
@@ -3892,13 +5006,28 @@ void SoundboardService::handleHotkeyAction(const QString& actionId)
             activate(boardId);
             qDebug() << "Soundboard activated via hotkey:" << boardId;
         }
+    } else if (actionId.startsWith("macro.")) {
+        // Macro hotkeys toggle: start the macro, or cancel it if it is still running
+        bool ok;
+        int macroId = actionId.mid(6).toInt(&ok);
+        if (ok) {
+            if (isMacroRunning(macroId))
+                stopMacro(macroId);
+            else
+                runMacro(macroId);
+            qDebug() << "Macro hotkey triggered for macro:" << macroId;
+        }
     } else if (actionId.startsWith("clip.")) {
         // Handle clip-specific hotkeys (e.g., "clip.123" plays clip 123)
         bool ok;
         int clipId = actionId.mid(5).toInt(&ok);
         if (ok) {
             // Clip hotkey uses the clip's reproduction mode
-            playClip(clipId);
+            if (!triggerClipFast(clipId, pressNs, actionNs)) {
+                m_pendingLatencyTrace = {clipId, pressNs, actionNs};
+                playClip(clipId);
+                m_pendingLatencyTrace = PendingLatencyTrace();
+            }
             qDebug() << "Clip hotkey triggered for clip:" << clipId;
         }
     } else {
@@ -4489,8 +5618,8 @@ void SoundboardService::setBufferPeriods(int periods)
 
 void SoundboardService::setSampleRate(int rate)
 {
-    // Validate: only allow common sample rates
-    if (rate != 44100 && rate != 48000 && rate != 96000)
+    // Validate: only allow common sample rates (0 = device native)
+    if (rate != 0 && rate != 44100 && rate != 48000 && rate != 96000)
         return;
     if (m_state.settings.sampleRate == rate)
         return;
@@ -4511,6 +5640,123 @@ void SoundboardService::setAudioChannels(int channels)
     emit settingsChanged();
 }
 
+void SoundboardService::setResamplerQuality(int quality)
+{
+    if (quality < (int)ResamplerQuality::Linear || quality > (int)ResamplerQuality::Sinc64)
+        return;
+    if (m_state.settings.resamplerQuality == quality)
+        return;
+    m_state.settings.resamplerQuality = quality;
+    if (m_audioEngine) {
+        m_audioEngine->setResamplerQuality(static_cast<ResamplerQuality>(quality)); // from the next play
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setVoiceStealPolicy(int policy)
+{
+    policy = std::clamp(policy, (int)AudioEngine::VoiceStealPolicy::Oldest,
+                        (int)AudioEngine::VoiceStealPolicy::LowestPriority);
+    if (m_state.settings.voiceStealPolicy == policy)
+        return;
+    m_state.settings.voiceStealPolicy = policy;
+    if (m_audioEngine) {
+        m_audioEngine->setVoiceStealPolicy(static_cast<AudioEngine::VoiceStealPolicy>(policy));
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setNoiseSuppressionOnDspThread(bool enabled)
+{
+    if (m_state.settings.noiseSuppressionOnDspThread == enabled)
+        return;
+    m_state.settings.noiseSuppressionOnDspThread = enabled;
+    if (m_audioEngine) {
+        m_audioEngine->setNoiseSuppressionOnDspThread(enabled); // from the next device start
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setClipFadeMs(double fadeMs)
+{
+    fadeMs = std::clamp(fadeMs, 0.0, 100.0);
+    if (qFuzzyCompare(m_state.settings.clipFadeMs + 1.0, fadeMs + 1.0))
+        return;
+    m_state.settings.clipFadeMs = fadeMs;
+    if (m_audioEngine) {
+        m_audioEngine->setClipFadeMs(fadeMs); // takes effect immediately
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setVoiceDuckingEnabled(bool enabled)
+{
+    if (m_state.settings.voiceDuckingEnabled == enabled)
+        return;
+    m_state.settings.voiceDuckingEnabled = enabled;
+    if (m_audioEngine) {
+        m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setVoiceDuckThreshold(double threshold)
+{
+    threshold = std::clamp(threshold, 0.0, 1.0);
+    if (qFuzzyCompare(m_state.settings.voiceDuckThreshold + 1.0, threshold + 1.0))
+        return;
+    m_state.settings.voiceDuckThreshold = threshold;
+    if (m_audioEngine) {
+        m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setVoiceDuckAttackMs(double attackMs)
+{
+    attackMs = std::clamp(attackMs, 0.0, 1000.0);
+    if (qFuzzyCompare(m_state.settings.voiceDuckAttackMs + 1.0, attackMs + 1.0))
+        return;
+    m_state.settings.voiceDuckAttackMs = attackMs;
+    if (m_audioEngine) {
+        m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setVoiceDuckReleaseMs(double releaseMs)
+{
+    releaseMs = std::clamp(releaseMs, 0.0, 5000.0);
+    if (qFuzzyCompare(m_state.settings.voiceDuckReleaseMs + 1.0, releaseMs + 1.0))
+        return;
+    m_state.settings.voiceDuckReleaseMs = releaseMs;
+    if (m_audioEngine) {
+        m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
+void SoundboardService::setVoiceDuckDepthDb(double depthDb)
+{
+    depthDb = std::clamp(depthDb, -60.0, 0.0);
+    if (qFuzzyCompare(m_state.settings.voiceDuckDepthDb + 1.0, depthDb + 1.0))
+        return;
+    m_state.settings.voiceDuckDepthDb = depthDb;
+    if (m_audioEngine) {
+        m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+    }
+    m_indexDirty = true; // Mark as dirty instead of immediate save
+    emit settingsChanged();
+}
+
 bool SoundboardService::exportSettings(const QString& filePath)
 {
     QString path = filePath;
@@ -4533,11 +5779,21 @@ bool SoundboardService::exportSettings(const QString& filePath)
     settings["micEnabled"] = m_state.settings.micEnabled;
     settings["micPassthroughEnabled"] = m_state.settings.micPassthroughEnabled;
     settings["micSoundboardBalance"] = m_state.settings.micSoundboardBalance;
+    settings["noiseSuppressionOnDspThread"] = m_state.settings.noiseSuppressionOnDspThread;
+    settings["recordingInputNoiseSuppressionLevel"] = m_state.settings.recordingInputNoiseSuppressionLevel;
     // Audio buffer settings
     settings["bufferSizeFrames"] = m_state.settings.bufferSizeFrames;
     settings["bufferPeriods"] = m_state.settings.bufferPeriods;
     settings["sampleRate"] = m_state.settings.sampleRate;
     settings["channels"] = m_state.settings.channels;
+    settings["resamplerQuality"] = m_state.settings.resamplerQuality;
+    settings["voiceStealPolicy"] = m_state.settings.voiceStealPolicy;
+    settings["clipFadeMs"] = m_state.settings.clipFadeMs;
+    settings["voiceDuckingEnabled"] = m_state.settings.voiceDuckingEnabled;
+    settings["voiceDuckThreshold"] = m_state.settings.voiceDuckThreshold;
+    settings["voiceDuckAttackMs"] = m_state.settings.voiceDuckAttackMs;
+    settings["voiceDuckReleaseMs"] = m_state.settings.voiceDuckReleaseMs;
+    settings["voiceDuckDepthDb"] = m_state.settings.voiceDuckDepthDb;
 
     root["settings"] = settings;
     root["version"] = m_state.version;
@@ -4590,11 +5846,29 @@ bool SoundboardService::importSettings(const QString& filePath)
             s.value("micPassthroughEnabled").toBool(m_state.settings.micPassthroughEnabled);
         m_state.settings.micSoundboardBalance =
             (float)s.value("micSoundboardBalance").toDouble(m_state.settings.micSoundboardBalance);
+        m_state.settings.noiseSuppressionOnDspThread =
+            s.value("noiseSuppressionOnDspThread").toBool(m_state.settings.noiseSuppressionOnDspThread);
+        const int recInputNs = m_state.settings.recordingInputNoiseSuppressionLevel;
+        m_state.settings.recordingInputNoiseSuppressionLevel =
+            qBound(0, s.value("recordingInputNoiseSuppressionLevel").toInt(recInputNs), 4);
         // Audio buffer settings
         m_state.settings.bufferSizeFrames = s.value("bufferSizeFrames").toInt(m_state.settings.bufferSizeFrames);
         m_state.settings.bufferPeriods = s.value("bufferPeriods").toInt(m_state.settings.bufferPeriods);
         m_state.settings.sampleRate = s.value("sampleRate").toInt(m_state.settings.sampleRate);
         m_state.settings.channels = s.value("channels").toInt(m_state.settings.channels);
+        m_state.settings.resamplerQuality =
+            std::clamp(s.value("resamplerQuality").toInt(m_state.settings.resamplerQuality), 0, 3);
+        m_state.settings.voiceStealPolicy =
+            std::clamp(s.value("voiceStealPolicy").toInt(m_state.settings.voiceStealPolicy), 0, 2);
+        m_state.settings.clipFadeMs = s.value("clipFadeMs").toDouble(m_state.settings.clipFadeMs);
+        m_state.settings.voiceDuckingEnabled =
+            s.value("voiceDuckingEnabled").toBool(m_state.settings.voiceDuckingEnabled);
+        m_state.settings.voiceDuckThreshold =
+            s.value("voiceDuckThreshold").toDouble(m_state.settings.voiceDuckThreshold);
+        m_state.settings.voiceDuckAttackMs = s.value("voiceDuckAttackMs").toDouble(m_state.settings.voiceDuckAttackMs);
+        m_state.settings.voiceDuckReleaseMs =
+            s.value("voiceDuckReleaseMs").toDouble(m_state.settings.voiceDuckReleaseMs);
+        m_state.settings.voiceDuckDepthDb = s.value("voiceDuckDepthDb").toDouble(m_state.settings.voiceDuckDepthDb);
 
         // Mark as dirty instead of immediate save
         m_indexDirty = true;
@@ -4603,6 +5877,11 @@ bool SoundboardService::importSettings(const QString& filePath)
         if (m_audioEngine) {
             m_audioEngine->setMasterGainDB(static_cast<float>(m_state.settings.masterGainDb));
             m_audioEngine->setMicGainDB(static_cast<float>(m_state.settings.micGainDb));
+            m_audioEngine->setClipFadeMs(m_state.settings.clipFadeMs);
+            m_audioEngine->setResamplerQuality(static_cast<ResamplerQuality>(m_state.settings.resamplerQuality));
+            m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+            m_audioEngine->setVoiceStealPolicy(
+                static_cast<AudioEngine::VoiceStealPolicy>(m_state.settings.voiceStealPolicy));
             if (!m_state.settings.selectedCaptureDeviceId.isEmpty())
                 m_audioEngine->setCaptureDevice(m_state.settings.selectedCaptureDeviceId.toStdString());
             if (!m_state.settings.selectedPlaybackDeviceId.isEmpty())
@@ -4613,6 +5892,9 @@ bool SoundboardService::importSettings(const QString& filePath)
             m_audioEngine->setMicEnabled(m_state.settings.micEnabled);
             m_audioEngine->setMicPassthroughEnabled(m_state.settings.micPassthroughEnabled);
             m_audioEngine->setMicSoundboardBalance(m_state.settings.micSoundboardBalance);
+            m_audioEngine->setNoiseSuppressionOnDspThread(m_state.settings.noiseSuppressionOnDspThread);
+            m_audioEngine->setRecordingInputNoiseSuppressionLevel(
+                m_state.settings.recordingInputNoiseSuppressionLevel);
         }
 
         emit settingsChanged();
@@ -4640,6 +5922,13 @@ void SoundboardService::resetSettings()
         m_audioEngine->setMicEnabled(m_state.settings.micEnabled);
         m_audioEngine->setMicPassthroughEnabled(m_state.settings.micPassthroughEnabled);
         m_audioEngine->setMicSoundboardBalance(m_state.settings.micSoundboardBalance);
+        m_audioEngine->setClipFadeMs(m_state.settings.clipFadeMs);
+        m_audioEngine->setResamplerQuality(static_cast<ResamplerQuality>(m_state.settings.resamplerQuality));
+        m_audioEngine->setNoiseSuppressionOnDspThread(m_state.settings.noiseSuppressionOnDspThread);
+        m_audioEngine->setRecordingInputNoiseSuppressionLevel(m_state.settings.recordingInputNoiseSuppressionLevel);
+        m_audioEngine->setVoiceDucking(voiceDuckSettings(m_state.settings));
+        m_audioEngine->setVoiceStealPolicy(
+            static_cast<AudioEngine::VoiceStealPolicy>(m_state.settings.voiceStealPolicy));
     }
 
     m_indexDirty = true; // Mark as dirty instead of immediate save
@@ -4704,37 +5993,126 @@ QString SoundboardService::extractAudioArtwork(const QString& audioFilePath)
 
 void SoundboardService::cacheActiveBoardWaveforms()
 {
-    // Collect all clip IDs from active boards to minimize lock contention
-    QList<int> clipIds;
-    // Note: m_activeBoards is generally stable on the main thread,
-    // but better to quickly copy IDs
+    // Queue every uncached clip of the active boards at background priority.
+    // Visible/selected clips are bumped later via prioritizeClipWaveforms()/setCurrentlySelectedClip().
     for (auto it = m_activeBoards.constBegin(); it != m_activeBoards.constEnd(); ++it) {
         for (const auto& clip : it.value().clips) {
-            clipIds.append(clip.id);
+            enqueueWaveformJob(clip.id, WaveformPriorityBackground);
         }
     }
+}
 
-    if (clipIds.isEmpty())
-        return;
+void SoundboardService::prioritizeClipWaveforms(const QList<int>& clipIds)
+{
+    for (int clipId : clipIds) {
+        enqueueWaveformJob(clipId, WaveformPriorityVisible);
+    }
+}
 
-    // Run in background (discard QFuture - fire and forget)
-    (void)QtConcurrent::run([this, clipIds]() {
-        for (int clipId : clipIds) {
-            // Check if already cached
-            bool cached = false;
-            {
-                QMutexLocker locker(&m_waveformCacheMutex);
-                cached = m_waveformCache.contains(clipId);
-            }
+QVariantList SoundboardService::requestClipWaveformPeaks(int clipId)
+{
+    {
+        QMutexLocker locker(&m_waveformCacheMutex);
+        auto it = m_waveformCache.constFind(clipId);
+        if (it != m_waveformCache.constEnd())
+            return it.value();
+    }
 
-            if (!cached) {
-                // Determine path and load
-                // We use getClipWaveformPeaks which handles lookup and caching.
-                getClipWaveformPeaks(clipId, 100);
+    enqueueWaveformJob(clipId, WaveformPrioritySelected);
+    return QVariantList();
+}
+
+std::shared_ptr<std::atomic_bool> SoundboardService::waveformCancelFlag(int boardId)
+{
+    auto& flag = m_waveformBoardCancel[boardId];
+    if (!flag || flag->load()) {
+        // Fresh flag per activation so jobs from a previous activation stay cancelled
+        flag = std::make_shared<std::atomic_bool>(false);
+    }
+    return flag;
+}
+
+void SoundboardService::enqueueWaveformJob(int clipId, int priority)
+{
+    {
+        QMutexLocker locker(&m_waveformCacheMutex);
+        if (m_waveformCache.contains(clipId))
+            return;
+    }
+
+    // Resolve the file on the main thread; jobs never touch m_activeBoards
+    int boardId = -1;
+    QString filePath;
+    for (auto it = m_activeBoards.constBegin(); it != m_activeBoards.constEnd() && filePath.isEmpty(); ++it) {
+        for (const auto& clip : it.value().clips) {
+            if (clip.id == clipId) {
+                boardId = it.key();
+                filePath = clip.filePath;
+                break;
             }
         }
-        // qDebug() << "Background waveform caching complete for" << clipIds.size() << "clips.";
+    }
+    if (filePath.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_waveformJobsMutex);
+
+    auto pending = m_pendingWaveformJobs.find(clipId);
+    if (pending != m_pendingWaveformJobs.end()) {
+        if (pending->priority >= priority)
+            return; // Already queued at the same or a higher priority
+        if (!m_waveformPool.tryTake(pending->runnable))
+            return; // Already running
+        delete pending->runnable;
+        m_pendingWaveformJobs.erase(pending);
+    }
+
+    std::shared_ptr<std::atomic_bool> cancelled = waveformCancelFlag(boardId);
+    QRunnable* job = QRunnable::create([this, clipId, filePath, cancelled]() {
+        {
+            QMutexLocker jobsLocker(&m_waveformJobsMutex);
+            m_pendingWaveformJobs.remove(clipId);
+        }
+        if (cancelled->load())
+            return;
+
+        {
+            QMutexLocker cacheLocker(&m_waveformCacheMutex);
+            if (m_waveformCache.contains(clipId))
+                return;
+        }
+
+        QVariantList peaks = computeWaveformPeaks(filePath, 100, cancelled.get());
+        if (cancelled->load() || peaks.isEmpty())
+            return;
+
+        {
+            QMutexLocker cacheLocker(&m_waveformCacheMutex);
+            m_waveformCache[clipId] = peaks;
+        }
+        QMetaObject::invokeMethod(this, [this, clipId]() { emit clipWaveformReady(clipId); }, Qt::QueuedConnection);
     });
+
+    m_pendingWaveformJobs.insert(clipId, PendingWaveformJob{job, boardId, priority});
+    m_waveformPool.start(job, priority);
+}
+
+void SoundboardService::cancelWaveformJobsForBoard(int boardId)
+{
+    auto flag = m_waveformBoardCancel.find(boardId);
+    if (flag != m_waveformBoardCancel.end()) {
+        flag.value()->store(true); // Running jobs notice this between bars
+    }
+
+    QMutexLocker locker(&m_waveformJobsMutex);
+    for (auto it = m_pendingWaveformJobs.begin(); it != m_pendingWaveformJobs.end();) {
+        if (it->boardId == boardId && m_waveformPool.tryTake(it->runnable)) {
+            delete it->runnable;
+            it = m_pendingWaveformJobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 QVariantList SoundboardService::getClipsForBoardVariant(int boardId) const
@@ -4753,6 +6131,9 @@ QVariantList SoundboardService::getClipsForBoardVariant(int boardId) const
             m["speed"] = clip.speed;
             m["isPlaying"] = clip.isPlaying;
             m["isRepeat"] = clip.isRepeat;
+            m["loopCrossfadeMs"] = clip.loopCrossfadeMs;
+            m["polyphony"] = clip.polyphony;
+            m["voicePriority"] = clip.voicePriority;
             m["tags"] = clip.tags;
             m["reproductionMode"] = clip.reproductionMode;
             m["stopOtherSounds"] = clip.stopOtherSounds;
@@ -2,6 +2,7 @@
 
 #include "models/AppState.h"
 #include "models/clip.h"
+#include "models/macro.h"
 #include "models/soundboard.h"
 #include "services/storageRepository.h"
 
@@ -10,15 +11,19 @@
 #include <QObject>
 #include <QSet>
 #include <QStringList>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVariant>
 #include <QVector>
 
+#include <atomic>
 #include <memory>
 #include <optional>
+#include <string>
 
 // Forward declaration
 class AudioEngine;
+class MacroSequencer;
 
 class SoundboardService : public QObject
 {
@@ -58,16 +63,35 @@ public:
     // Noise cancellation
     Q_PROPERTY(
         int noiseSuppressionLevel READ noiseSuppressionLevel WRITE setNoiseSuppressionLevel NOTIFY settingsChanged)
+    Q_PROPERTY(bool noiseSuppressionOnDspThread READ noiseSuppressionOnDspThread WRITE setNoiseSuppressionOnDspThread
+                   NOTIFY settingsChanged)
+    Q_PROPERTY(int recordingInputNoiseSuppressionLevel READ recordingInputNoiseSuppressionLevel WRITE
+                   setRecordingInputNoiseSuppressionLevel NOTIFY settingsChanged)
 
     // Audio buffer settings
     Q_PROPERTY(int bufferSizeFrames READ bufferSizeFrames WRITE setBufferSizeFrames NOTIFY settingsChanged)
     Q_PROPERTY(int bufferPeriods READ bufferPeriods WRITE setBufferPeriods NOTIFY settingsChanged)
     Q_PROPERTY(int sampleRate READ sampleRate WRITE setSampleRate NOTIFY settingsChanged)
     Q_PROPERTY(int audioChannels READ audioChannels WRITE setAudioChannels NOTIFY settingsChanged)
+    Q_PROPERTY(int resamplerQuality READ resamplerQuality WRITE setResamplerQuality NOTIFY settingsChanged)
+    Q_PROPERTY(int voiceStealPolicy READ voiceStealPolicy WRITE setVoiceStealPolicy NOTIFY settingsChanged)
+    Q_PROPERTY(double clipFadeMs READ clipFadeMs WRITE setClipFadeMs NOTIFY settingsChanged)
+
+    // Speech ducking of clips
+    Q_PROPERTY(bool voiceDuckingEnabled READ voiceDuckingEnabled WRITE setVoiceDuckingEnabled NOTIFY settingsChanged)
+    Q_PROPERTY(double voiceDuckThreshold READ voiceDuckThreshold WRITE setVoiceDuckThreshold NOTIFY settingsChanged)
+    Q_PROPERTY(double voiceDuckAttackMs READ voiceDuckAttackMs WRITE setVoiceDuckAttackMs NOTIFY settingsChanged)
+    Q_PROPERTY(double voiceDuckReleaseMs READ voiceDuckReleaseMs WRITE setVoiceDuckReleaseMs NOTIFY settingsChanged)
+    Q_PROPERTY(double voiceDuckDepthDb READ voiceDuckDepthDb WRITE setVoiceDuckDepthDb NOTIFY settingsChanged)
 
     Q_PROPERTY(bool isRecording READ isRecording NOTIFY recordingStateChanged)
     Q_PROPERTY(QString lastRecordingPath READ lastRecordingPath NOTIFY recordingStateChanged)
     Q_PROPERTY(float recordingDuration READ recordingDuration NOTIFY recordingStateChanged)
+    // Published about once per display frame while watched (watchPlaybackTelemetry), and only when it changed:
+    //   playing: clip IDs playing (not paused); progress / positionMs: clipId -> value for clips holding a voice
+    Q_PROPERTY(QVariantMap playbackTelemetry READ playbackTelemetry NOTIFY playbackTelemetryChanged)
+    // Same cadence while watched (watchMeterTelemetry): mic / master / monitor readings as in getMeters()
+    Q_PROPERTY(QVariantMap meterTelemetry READ meterTelemetry NOTIFY meterTelemetryChanged)
     Q_PROPERTY(float recordingPeakLevel READ getRecordingPeakLevel NOTIFY recordingStateChanged)
     Q_PROPERTY(
         bool recordWithInputDevice READ recordWithInputDevice WRITE setRecordWithInputDevice NOTIFY settingsChanged)
@@ -119,6 +143,28 @@ public:
     int audioChannels() const { return m_state.settings.channels; }
     Q_INVOKABLE void setAudioChannels(int channels);
 
+    int resamplerQuality() const { return m_state.settings.resamplerQuality; }
+    Q_INVOKABLE void setResamplerQuality(int quality);
+
+    // Which playing clip gives up its voice when all are busy (AudioEngine::VoiceStealPolicy)
+    int voiceStealPolicy() const { return m_state.settings.voiceStealPolicy; }
+    Q_INVOKABLE void setVoiceStealPolicy(int policy);
+
+    double clipFadeMs() const { return m_state.settings.clipFadeMs; }
+    Q_INVOKABLE void setClipFadeMs(double fadeMs);
+
+    // Speech ducking (all take effect immediately)
+    bool voiceDuckingEnabled() const { return m_state.settings.voiceDuckingEnabled; }
+    Q_INVOKABLE void setVoiceDuckingEnabled(bool enabled);
+    double voiceDuckThreshold() const { return m_state.settings.voiceDuckThreshold; }
+    Q_INVOKABLE void setVoiceDuckThreshold(double threshold);
+    double voiceDuckAttackMs() const { return m_state.settings.voiceDuckAttackMs; }
+    Q_INVOKABLE void setVoiceDuckAttackMs(double attackMs);
+    double voiceDuckReleaseMs() const { return m_state.settings.voiceDuckReleaseMs; }
+    Q_INVOKABLE void setVoiceDuckReleaseMs(double releaseMs);
+    double voiceDuckDepthDb() const { return m_state.settings.voiceDuckDepthDb; }
+    Q_INVOKABLE void setVoiceDuckDepthDb(double depthDb);
+
     Q_INVOKABLE bool exportSettings(const QString& filePath);
     Q_INVOKABLE bool importSettings(const QString& filePath);
     Q_INVOKABLE void triggerSettingsChanged() { emit settingsChanged(); }
@@ -163,6 +209,9 @@ public:
     Q_INVOKABLE bool updateClipAudioSettings(int boardId, int clipId, int volume, double speed);
     Q_INVOKABLE void setClipVolume(int boardId, int clipId, int volume);
     Q_INVOKABLE void setClipRepeat(int boardId, int clipId, bool repeat);
+    Q_INVOKABLE void setClipLoopCrossfade(int boardId, int clipId, double crossfadeMs);
+    Q_INVOKABLE void setClipPolyphony(int boardId, int clipId, int polyphony);
+    Q_INVOKABLE void setClipVoicePriority(int boardId, int clipId, int priority);
     Q_INVOKABLE void setClipReproductionMode(int boardId, int clipId, int mode);
     Q_INVOKABLE void setClipStopOtherSounds(int boardId, int clipId, bool stop);
     Q_INVOKABLE void setClipMuteOtherSounds(int boardId, int clipId, bool mute);
@@ -190,6 +239,12 @@ public:
     Q_INVOKABLE void playClip(int clipId);
     Q_INVOKABLE void playClipFromPosition(int clipId, double positionMs);
     Q_INVOKABLE void stopClip(int clipId);
+
+    // Sample-accurate cues on the engine clock. quantizeMs > 0 rounds the start up to that grid
+    // (e.g. 60000/bpm for the next beat). Reproduction modes don't apply to other clips here.
+    Q_INVOKABLE bool playClipsInSync(const QVariantList& clipIds, double quantizeMs = 0.0);
+    Q_INVOKABLE bool scheduleClip(int clipId, double delayMs, double quantizeMs = 0.0);
+    Q_INVOKABLE bool scheduleClipStop(int clipId, double delayMs, double quantizeMs = 0.0);
     Q_INVOKABLE void stopAllClips();
     Q_INVOKABLE bool isClipPlaying(int clipId) const;
     Q_INVOKABLE double getClipPlaybackPositionMs(int clipId) const;
@@ -211,6 +266,16 @@ public:
     Q_INVOKABLE float getMasterPeakLevel() const;
     Q_INVOKABLE float getMonitorPeakLevel() const;
     Q_INVOKABLE void resetPeakLevels();
+    // Per bus (mic, master, monitor): rms, peak, truePeak (linear), momentaryLufs, shortTermLufs;
+    // plus clipRms / clipPeak: clipId -> RMS / held sample peak of its loudest voice, for clips holding a voice
+    Q_INVOKABLE QVariantMap getMeters() const;
+    Q_INVOKABLE void resetMeters();
+    QVariantMap playbackTelemetry() const { return m_playbackTelemetry; }
+    QVariantMap meterTelemetry() const { return m_meterTelemetry; }
+    // Views call these with true when they start showing the data and false when they stop;
+    // the publishing timer only runs while something is watched (and, for playback, while clips play)
+    Q_INVOKABLE void watchPlaybackTelemetry(bool watching);
+    Q_INVOKABLE void watchMeterTelemetry(bool watching);
 
     // ---- Mixer Controls ----
     Q_INVOKABLE void setMicSoundboardBalance(float balance);
@@ -223,8 +288,12 @@ public:
 
     // Noise cancellation controls
     int noiseSuppressionLevel() const { return m_state.settings.noiseSuppressionLevel; }
+    bool noiseSuppressionOnDspThread() const { return m_state.settings.noiseSuppressionOnDspThread; }
+    Q_INVOKABLE void setNoiseSuppressionOnDspThread(bool enabled);
     Q_INVOKABLE void setNoiseSuppressionLevel(int level);
     Q_INVOKABLE QStringList getNoiseSuppressionLevelNames() const;
+    int recordingInputNoiseSuppressionLevel() const { return m_state.settings.recordingInputNoiseSuppressionLevel; }
+    Q_INVOKABLE void setRecordingInputNoiseSuppressionLevel(int level);
 
     // ---- Recording ----
     Q_INVOKABLE bool startRecording();
@@ -255,6 +324,9 @@ public:
     Q_INVOKABLE float getRecordingPeakLevel() const;
     Q_INVOKABLE QVariantList getWaveformPeaks(const QString& filePath, int numBars = 100) const;
     Q_INVOKABLE QVariantList getClipWaveformPeaks(int clipId, int numBars = 100) const; // Get waveform by clip ID
+    // Non-blocking variant: returns cached peaks, or schedules generation at top priority and returns an empty list
+    // (clipWaveformReady is emitted once the peaks are available)
+    Q_INVOKABLE QVariantList requestClipWaveformPeaks(int clipId);
     bool recordWithInputDevice() const { return m_recordWithInputDevice; }
     void setRecordWithInputDevice(bool enabled);
     bool recordWithClipboard() const { return m_recordWithClipboard; }
@@ -272,6 +344,7 @@ public:
 
     // ---- Waveform Caching ----
     Q_INVOKABLE void cacheActiveBoardWaveforms();
+    void prioritizeClipWaveforms(const QList<int>& clipIds); // Visible clips jump ahead of background work
 
     // ---- Recording preview (NO soundboard add) ----
     Q_INVOKABLE QVariantList listBoardsForDropdown() const;
@@ -294,9 +367,47 @@ public:
     // ---- Hotkey (active only) ----
     int findActiveClipIdByHotkey(const QString& hotkey) const;
 
+    // Hotkey fast path: if the clip is still loaded in its slot, queue the start/stop straight
+    // into the engine and update UI state asynchronously. Returns false when the full playClip()
+    // path is needed (not loaded, Play/Pause mode, mute-others or mute-mic options).
+    // pressNs/actionNs (latencyClockNs) trace the trigger; actionNs < 0 when called from the hotkey itself.
+    bool triggerClipFast(int clipId, qint64 pressNs = -1, qint64 actionNs = -1);
+    void noteHotkeyPressed(qint64 pressNs) { m_lastHotkeyPressNs = pressNs; }
+
+    // ---- Trigger latency (hotkey press -> first sample; see AudioEngine::LatencyStage) ----
+    // { outputLatencyMs, stages: { <stage>: { count, p50Ms, p95Ms, p99Ms, maxMs, meanMs } } }
+    Q_INVOKABLE QVariantMap getTriggerLatencyStats() const;
+    Q_INVOKABLE bool dumpTriggerLatencyStats(const QString& filePath) const;
+    Q_INVOKABLE void resetTriggerLatencyStats();
+
+    // Engine health: per-callback timing and ring buffer over/underruns
+    Q_INVOKABLE QVariantMap getEngineHealth() const;
+    Q_INVOKABLE void resetEngineHealth();
+
+    // ---- Offline session render (see AudioEngine::renderSession) ----
+    // Triggers: [{ timeMs, clipId, action: "play"|"stop" }], at most AudioEngine::MAX_CLIPS distinct clips.
+    // Renders on a private engine with the current mixer settings, in the background, to a WAV file;
+    // durationMs <= 0 renders until everything has ended. Emits sessionRenderFinished.
+    Q_INVOKABLE bool renderSessionToFile(const QVariantList& triggers, const QString& micInputPath,
+                                         const QString& outputPath, double durationMs = 0.0);
+
     // ---- Playback state (active only) ----
     bool setClipPlaying(int clipId, bool playing);
 
+    // ---- Macros (timed clip sequences, run on the engine clock) ----
+    // Steps: [{ type: "playClip"|"stopClip"|"wait"|"waitClipEnd"|"setGain"|"duckMic"|"stopAll",
+    //           clipId, durationMs, gainDb }]. Clips must be on an active board when the macro runs.
+    QVector<Macro> listMacros() const { return m_macros; }
+    Q_INVOKABLE QVariantList getMacros() const;
+    Q_INVOKABLE int createMacro(const QString& name);
+    Q_INVOKABLE bool deleteMacro(int macroId);
+    Q_INVOKABLE bool renameMacro(int macroId, const QString& name);
+    Q_INVOKABLE bool setMacroSteps(int macroId, const QVariantList& steps);
+    Q_INVOKABLE bool setMacroHotkey(int macroId, const QString& hotkey);
+    Q_INVOKABLE bool runMacro(int macroId);
+    Q_INVOKABLE void stopMacro(int macroId);
+    Q_INVOKABLE bool isMacroRunning(int macroId) const;
+
     // ---- Hotkey Action Handler ----
     Q_INVOKABLE void handleHotkeyAction(const QString& actionId);
 
@@ -329,11 +440,18 @@ signals:
     void clipPlaybackPaused(int clipId);
     void clipLooped(int clipId); // Emitted when a looping clip restarts from the beginning
     void clipUpdated(int boardId, int clipId);
+    void clipWaveformReady(int clipId);
+    void macrosChanged();
+    void macroStarted(int macroId);
+    void macroFinished(int macroId, bool completed); // completed = false if stopped or restarted
+    void sessionRenderFinished(bool success, const QString& outputPath, const QString& error, double realtimeFactor);
 
     void playSelectedRequested();
     void clipSelectionRequested(int clipId);
     void clipboardChanged();
     void recordingStateChanged();
+    void playbackTelemetryChanged();
+    void meterTelemetryChanged();
     void testCallSimulationChanged();
     void audioDevicesChanged();
 
@@ -356,7 +474,16 @@ private:
     void rebuildHotkeyIndex();
     Clip* findActiveClipById(int clipId);
     std::optional<Clip> findClipByIdAnyBoard(int clipId, int* outBoardId = nullptr) const;
-    int getOrAssignSlot(int clipId);
+    int getOrAssignSlot(int clipId, uint32_t keepSlots = 0); // -1 when no voice may be taken
+    int acquireOverlapVoice(Clip& clip); // another voice for a polyphonic clip; becomes its primary
+    void releaseSlotOwner(int slotId);   // forget whichever clip held slotId
+    QList<int> voicesOf(int clipId) const;
+    void stopExtraVoices(int clipId);
+    void handleVoiceFinished(int clipId, int slotId);
+    uint32_t macroPinnedSlots() const; // slots running macros address, never reassigned
+    bool prepareClipSlot(Clip* clip, int slotId); // stop, load and apply per-clip settings; no playback yet
+    void applyClipSettings(Clip* clip, int slotId); // gain, loop, trim for an already-loaded slot
+    static void configureClipSlot(AudioEngine& engine, const Clip& clip, int slotId);
     void reproductionPlayingClip(const QVariantList& playingClipIds, int mode);
     static QString normalizeHotkey(const QString& hotkey);
     void finalizeClipPlayback(int clipId);
@@ -364,25 +491,57 @@ private:
     void removeFromSharedBoardIds(const QString& filePath, int boardId);
     QString extractAudioArtwork(const QString& audioFilePath);
     void stopClipsForBoard(int boardId); // Stop all clips playing from a specific board
+    Macro* findMacroById(int macroId);
+    void handleMacroStep(int macroId, int stepIndex);
+
+    // Waveform job scheduling
+    enum WaveformPriority {
+        WaveformPriorityBackground = 0,
+        WaveformPriorityVisible = 10,
+        WaveformPrioritySelected = 20
+    };
+    void enqueueWaveformJob(int clipId, int priority);
+    void cancelWaveformJobsForBoard(int boardId);
+    std::shared_ptr<std::atomic_bool> waveformCancelFlag(int boardId);
+    QVariantList computeWaveformPeaks(const QString& filePath, int numBars, const std::atomic_bool* cancelled) const;
 
 private:
     // Reserve last engine slot for recording preview so it never collides with normal clip slots.
     static constexpr int kEngineSlotsTotal = 8; // AudioEngine::MAX_CLIPS
     static constexpr int kPreviewSlot = 7;      // Last slot reserved for preview (must be < MAX_CLIPS)
     static constexpr int kClipSlotsUsable = 7;  // 0..6 used by normal clips, 7 reserved for preview
+    static constexpr uint32_t kClipVoiceMask = (1u << kClipSlotsUsable) - 1;
+    // Scheduled starts are at least this far ahead so every decoder thread has filled its ring
+    static constexpr double kScheduleLeadMs = 50.0;
 
     StorageRepository m_repo;
 
     AppState m_state;
     QHash<int, Soundboard> m_activeBoards;
     QHash<QString, int> m_hotkeyToClipId;
+    QHash<int, std::string> m_hotkeyFastPaths; // clipId -> engine file path, for triggerClipFast
+
+    // Trigger latency tracing (main thread only)
+    struct PendingLatencyTrace
+    {
+        int clipId = -1;
+        qint64 pressNs = -1;
+        qint64 actionNs = -1;
+    };
+    qint64 m_lastHotkeyPressNs = -1;
+    PendingLatencyTrace m_pendingLatencyTrace; // armed by handleHotkeyAction, consumed by playClip
     QHash<int, int> m_slotToClipId;
 
     std::unique_ptr<AudioEngine> m_audioEngine;
-    QHash<int, int> m_clipIdToSlot;
-    int m_nextSlot = 0;
+    std::unique_ptr<MacroSequencer> m_macroSequencer; // declared after the engine so it stops first
+    QVector<Macro> m_macros;
+    QHash<int, QVector<int>> m_runningMacroClipIds; // macroId -> clipId per step, for UI state
+    QHash<int, QList<int>> m_macroSlots;            // macroId -> slots its steps were resolved to
+    QHash<int, int> m_clipIdToSlot;      // primary voice of each clip
+    QMultiHash<int, int> m_extraVoices;  // clipId -> further voices while a polyphonic clip overlaps itself
     QSet<int> m_clipsThatMutedMic;
     QHash<int, QList<int>> m_pausedByClip; // Maps clipId -> list of clip IDs that were paused when this clip started
+    QHash<int, QList<int>> m_mutedByClip;  // Maps clipId -> clip IDs it ducked to silence (muteOtherSounds)
 
     std::optional<Clip> m_clipboardClip;
     QString m_lastRecordingPath;
@@ -393,6 +552,16 @@ private:
     QString m_filePreviewPath;         // Currently previewing file path
     bool m_hasUnsavedRecording = false;
     QTimer* m_recordingTickTimer = nullptr;
+    QTimer* m_mediaCacheFlushTimer = nullptr;
+
+    // UI telemetry, see the playbackTelemetry / meterTelemetry properties
+    void publishTelemetry();
+    void updateTelemetryTimer();
+    QTimer* m_telemetryTimer = nullptr;
+    QVariantMap m_playbackTelemetry;
+    QVariantMap m_meterTelemetry;
+    int m_playbackWatchers = 0;
+    int m_meterWatchers = 0;
     bool m_recordWithInputDevice = true;
     bool m_recordWithClipboard = false;
     QString m_selectedRecordingDeviceId;               // Track the selected recording input device
@@ -409,4 +578,19 @@ private:
     // Waveform cache (clipId -> peaks)
     mutable QMap<int, QVariantList> m_waveformCache;
     mutable QMutex m_waveformCacheMutex;
+
+    // Pending waveform jobs (clipId -> queued job). A job removes itself when it starts running,
+    // so anything still in here can be re-prioritized or cancelled with QThreadPool::tryTake().
+    struct PendingWaveformJob
+    {
+        QRunnable* runnable = nullptr;
+        int boardId = -1;
+        int priority = WaveformPriorityBackground;
+    };
+    QHash<int, PendingWaveformJob> m_pendingWaveformJobs;
+    QMutex m_waveformJobsMutex;
+    QHash<int, std::shared_ptr<std::atomic_bool>> m_waveformBoardCancel; // main thread only
+
+    // Declared last so it is destroyed (and drained) before the state its jobs touch
+    QThreadPool m_waveformPool;
 };
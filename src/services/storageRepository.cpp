@@ -31,11 +31,21 @@ static QJsonObject settingsToJson(const AppSettings& s)
     o["micPassthroughEnabled"] = s.micPassthroughEnabled;
     o["micSoundboardBalance"] = s.micSoundboardBalance;
     o["noiseSuppressionLevel"] = s.noiseSuppressionLevel;
+    o["noiseSuppressionOnDspThread"] = s.noiseSuppressionOnDspThread;
+    o["recordingInputNoiseSuppressionLevel"] = s.recordingInputNoiseSuppressionLevel;
     // Audio buffer settings
     o["bufferSizeFrames"] = s.bufferSizeFrames;
     o["bufferPeriods"] = s.bufferPeriods;
     o["sampleRate"] = s.sampleRate;
     o["channels"] = s.channels;
+    o["resamplerQuality"] = s.resamplerQuality;
+    o["voiceStealPolicy"] = s.voiceStealPolicy;
+    o["clipFadeMs"] = s.clipFadeMs;
+    o["voiceDuckingEnabled"] = s.voiceDuckingEnabled;
+    o["voiceDuckThreshold"] = s.voiceDuckThreshold;
+    o["voiceDuckAttackMs"] = s.voiceDuckAttackMs;
+    o["voiceDuckReleaseMs"] = s.voiceDuckReleaseMs;
+    o["voiceDuckDepthDb"] = s.voiceDuckDepthDb;
     return o;
 }
 
@@ -57,11 +67,21 @@ static AppSettings settingsFromJson(const QJsonObject& o)
     s.micPassthroughEnabled = o.value("micPassthroughEnabled").toBool(true);
     s.micSoundboardBalance = (float)o.value("micSoundboardBalance").toDouble(0.5);
     s.noiseSuppressionLevel = o.value("noiseSuppressionLevel").toInt(2); // Default to Moderate
+    s.noiseSuppressionOnDspThread = o.value("noiseSuppressionOnDspThread").toBool(false);
+    s.recordingInputNoiseSuppressionLevel = o.value("recordingInputNoiseSuppressionLevel").toInt(2);
     // Audio buffer settings
     s.bufferSizeFrames = o.value("bufferSizeFrames").toInt(1024);
     s.bufferPeriods = o.value("bufferPeriods").toInt(3);
-    s.sampleRate = o.value("sampleRate").toInt(48000);
+    s.sampleRate = o.value("sampleRate").toInt(0); // 0 = device native
     s.channels = o.value("channels").toInt(2);
+    s.resamplerQuality = o.value("resamplerQuality").toInt(2);
+    s.voiceStealPolicy = o.value("voiceStealPolicy").toInt(0);
+    s.clipFadeMs = o.value("clipFadeMs").toDouble(5.0);
+    s.voiceDuckingEnabled = o.value("voiceDuckingEnabled").toBool(false);
+    s.voiceDuckThreshold = o.value("voiceDuckThreshold").toDouble(0.6);
+    s.voiceDuckAttackMs = o.value("voiceDuckAttackMs").toDouble(10.0);
+    s.voiceDuckReleaseMs = o.value("voiceDuckReleaseMs").toDouble(400.0);
+    s.voiceDuckDepthDb = o.value("voiceDuckDepthDb").toDouble(-12.0);
     return s;
 }
 
@@ -115,6 +135,9 @@ static QJsonObject clipToJson(const Clip& c)
 
     o["title"] = c.title;
     o["isRepeat"] = c.isRepeat;
+    o["loopCrossfadeMs"] = c.loopCrossfadeMs;
+    o["polyphony"] = c.polyphony;
+    o["voicePriority"] = c.voicePriority;
     o["reproductionMode"] = c.reproductionMode;
 
     // Playback behavior options
@@ -161,6 +184,9 @@ static Clip clipFromJson(const QJsonObject& o)
 
     c.title = o.value("title").toString();
     c.isRepeat = o.value("isRepeat").toBool(false);
+    c.loopCrossfadeMs = o.value("loopCrossfadeMs").toDouble(0.0);
+    c.polyphony = o.value("polyphony").toInt(1);
+    c.voicePriority = o.value("voicePriority").toInt(0);
     c.reproductionMode = o.value("reproductionMode").toInt(1); // Default to Play/Pause
 
     // Playback behavior options
@@ -213,6 +239,90 @@ static Soundboard soundboardFromJson(const QJsonObject& root)
     return b;
 }
 
+static const char* macroStepTypeName(MacroStep::Type t)
+{
+    switch (t) {
+    case MacroStep::Type::PlayClip:
+        return "playClip";
+    case MacroStep::Type::StopClip:
+        return "stopClip";
+    case MacroStep::Type::Wait:
+        return "wait";
+    case MacroStep::Type::WaitClipEnd:
+        return "waitClipEnd";
+    case MacroStep::Type::SetGain:
+        return "setGain";
+    case MacroStep::Type::DuckMic:
+        return "duckMic";
+    case MacroStep::Type::StopAll:
+        return "stopAll";
+    }
+    return "wait";
+}
+
+std::optional<MacroStep::Type> StorageRepository::macroStepTypeFromName(const QString& name)
+{
+    static const MacroStep::Type kTypes[] = {MacroStep::Type::PlayClip, MacroStep::Type::StopClip,
+                                             MacroStep::Type::Wait,     MacroStep::Type::WaitClipEnd,
+                                             MacroStep::Type::SetGain,  MacroStep::Type::DuckMic,
+                                             MacroStep::Type::StopAll};
+    for (MacroStep::Type t : kTypes) {
+        if (name == QLatin1String(macroStepTypeName(t)))
+            return t;
+    }
+    return std::nullopt;
+}
+
+QString StorageRepository::macroStepTypeToName(MacroStep::Type type)
+{
+    return QString::fromLatin1(macroStepTypeName(type));
+}
+
+static QJsonObject macroToJson(const Macro& m)
+{
+    QJsonObject root;
+    root["id"] = m.id;
+    root["name"] = m.name;
+    root["hotkey"] = m.hotkey;
+
+    QJsonArray stepsArr;
+    for (const auto& s : m.steps) {
+        QJsonObject o;
+        o["type"] = macroStepTypeName(s.type);
+        o["clipId"] = s.clipId;
+        o["durationMs"] = s.durationMs;
+        o["gainDb"] = s.gainDb;
+        stepsArr.append(o);
+    }
+    root["steps"] = stepsArr;
+
+    return root;
+}
+
+static Macro macroFromJson(const QJsonObject& root)
+{
+    Macro m;
+    m.id = root.value("id").toInt(-1);
+    m.name = root.value("name").toString();
+    m.hotkey = root.value("hotkey").toString();
+
+    const auto stepsArr = root.value("steps").toArray();
+    for (const auto& v : stepsArr) {
+        const auto o = v.toObject();
+        const auto type = StorageRepository::macroStepTypeFromName(o.value("type").toString());
+        if (!type)
+            continue; // written by a newer version
+        MacroStep s;
+        s.type = *type;
+        s.clipId = o.value("clipId").toInt(-1);
+        s.durationMs = o.value("durationMs").toDouble(0.0);
+        s.gainDb = o.value("gainDb").toDouble(0.0);
+        m.steps.push_back(s);
+    }
+
+    return m;
+}
+
 // ------------------ StorageRepository ------------------
 
 StorageRepository::StorageRepository()
@@ -247,6 +357,11 @@ QString StorageRepository::indexPath() const
     return QDir(baseDir()).filePath("index.json");
 }
 
+QString StorageRepository::macrosPath() const
+{
+    return QDir(baseDir()).filePath("macros.json");
+}
+
 QString StorageRepository::boardsDir() const
 {
     return QDir(baseDir()).filePath("boards");
@@ -457,3 +572,44 @@ bool StorageRepository::deleteBoard(int boardId)
 
     return saveIndex(state);
 }
+
+QVector<Macro> StorageRepository::loadMacros() const
+{
+    QVector<Macro> macros;
+    ensureDirs();
+
+    QFile f(macrosPath());
+    if (!f.exists() || !f.open(QIODevice::ReadOnly))
+        return macros;
+
+    const auto doc = QJsonDocument::fromJson(f.readAll());
+    if (!doc.isObject())
+        return macros;
+
+    const auto macrosArr = doc.object().value("macros").toArray();
+    for (const auto& v : macrosArr) {
+        Macro m = macroFromJson(v.toObject());
+        if (m.id >= 0)
+            macros.push_back(m);
+    }
+    return macros;
+}
+
+bool StorageRepository::saveMacros(const QVector<Macro>& macros) const
+{
+    ensureDirs();
+
+    QJsonArray macrosArr;
+    for (const auto& m : macros)
+        macrosArr.append(macroToJson(m));
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["macros"] = macrosArr;
+
+    QFile f(macrosPath());
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
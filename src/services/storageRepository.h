@@ -2,6 +2,7 @@
 
 #include "models/AppState.h"
 #include "models/clip.h"       // your Clip
+#include "models/macro.h"
 #include "models/soundboard.h" // your Soundboard (contains QVector<Clip>)
 
 #include <QString>
@@ -24,6 +25,13 @@ public:
     std::optional<Soundboard> loadBoard(int boardId) const;
     bool saveBoard(const Soundboard& board); // updates index.json name + clipCount too
 
+    // ---- macros.json (all macros, independent of boards) ----
+    QVector<Macro> loadMacros() const;
+    bool saveMacros(const QVector<Macro>& macros) const;
+
+    static std::optional<MacroStep::Type> macroStepTypeFromName(const QString& name);
+    static QString macroStepTypeToName(MacroStep::Type type);
+
     // ---- helpers ----
     int createBoard(const QString& name); // creates board file and updates index
     bool deleteBoard(int boardId);        // deletes board file and updates index
@@ -31,6 +39,7 @@ public:
 private:
     QString baseDir() const;              // AppDataLocation/TalkLess/soundboards
     QString indexPath() const;            // .../index.json
+    QString macrosPath() const;           // .../macros.json
     QString boardsDir() const;            // .../boards
     QString boardPath(int boardId) const; // .../boards/board_<id>.json
 
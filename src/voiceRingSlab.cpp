@@ -0,0 +1,57 @@
+#include "voiceRingSlab.h"
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+VoiceRingSlab::~VoiceRingSlab()
+{
+    release();
+}
+
+VoiceRingSlab::VoiceRingSlab(VoiceRingSlab&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_regionCount(std::exchange(other.m_regionCount, 0)),
+      m_stride(std::exchange(other.m_stride, 0))
+{
+}
+
+VoiceRingSlab& VoiceRingSlab::operator=(VoiceRingSlab&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_regionCount = std::exchange(other.m_regionCount, 0);
+        m_stride = std::exchange(other.m_stride, 0);
+    }
+    return *this;
+}
+
+bool VoiceRingSlab::allocate(size_t regionCount, size_t regionBytes)
+{
+    release();
+    if (regionCount == 0 || regionBytes == 0)
+        return false;
+
+    const size_t stride = (regionBytes + kAlignment - 1) / kAlignment * kAlignment;
+    auto* data = static_cast<unsigned char*>(
+        ::operator new(regionCount * stride, std::align_val_t{kAlignment}, std::nothrow));
+    if (!data)
+        return false;
+
+    // Touch every page now rather than on the first decode into a fresh voice
+    std::memset(data, 0, regionCount * stride);
+
+    m_data = data;
+    m_regionCount = regionCount;
+    m_stride = stride;
+    return true;
+}
+
+void VoiceRingSlab::release()
+{
+    if (m_data)
+        ::operator delete(m_data, std::align_val_t{kAlignment}, std::nothrow);
+    m_data = nullptr;
+    m_regionCount = 0;
+    m_stride = 0;
+}
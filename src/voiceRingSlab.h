@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief One cache-line-aligned allocation carved into equal ring buffer regions
+ *
+ * Backs every clip voice's ring buffers, so loading a clip never allocates and
+ * the engine's streaming memory is a single, known number. Each region starts
+ * on its own cache line; a decoder writing one voice's ring never shares a line
+ * with the mixer reading the next.
+ *
+ * Not thread-safe: the owner swaps slabs only while nothing streams from them.
+ */
+class VoiceRingSlab
+{
+public:
+    static constexpr size_t kAlignment = 64;
+
+    VoiceRingSlab() = default;
+    ~VoiceRingSlab();
+
+    VoiceRingSlab(VoiceRingSlab&& other) noexcept;
+    VoiceRingSlab& operator=(VoiceRingSlab&& other) noexcept;
+    VoiceRingSlab(const VoiceRingSlab&) = delete;
+    VoiceRingSlab& operator=(const VoiceRingSlab&) = delete;
+
+    // Replaces any previous allocation; false (and empty) if it fails
+    bool allocate(size_t regionCount, size_t regionBytes);
+    void release();
+
+    bool empty() const { return m_data == nullptr; }
+    void* region(size_t index) const { return m_data + index * m_stride; }
+    size_t regionCount() const { return m_regionCount; }
+    size_t totalBytes() const { return m_regionCount * m_stride; }
+
+private:
+    unsigned char* m_data = nullptr;
+    size_t m_regionCount = 0;
+    size_t m_stride = 0; // region size rounded up to kAlignment
+};